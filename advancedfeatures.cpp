@@ -1,12 +1,17 @@
 #include "advancedfeatures.h"
 #include "fournisseur.h"
+#include "tracing.h"
+#include "memorytracker.h"
 #include <QFile>
 #include <QTextStream>
 #include <QDir>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QRegularExpression>
+#include <QHash>
+#include <algorithm>
 
 // ===== ActivityLog Implementation =====
 ActivityLog::ActivityLog(const QString& action, const QString& desc, int fId)
@@ -48,7 +53,7 @@ QString ActivityLog::toString() const
 // ===== SupplierRating Implementation =====
 SupplierRating::SupplierRating()
     : fournisseurId(-1), qualityScore(0), deliveryScore(0), priceScore(0),
-      communicationScore(0), totalOrders(0), onTimeDeliveries(0), averageDeliveryTime(0.0)
+      communicationScore(0), totalOrders(0), onTimeDeliveries(0), averageDeliveryTime(0.0), overall(0.0)
 {
     ratedDate = QDateTime::currentDateTime();
 }
@@ -60,11 +65,7 @@ SupplierRating::SupplierRating(int fId, int quality, int delivery, int price,
       totalOrders(0), onTimeDeliveries(0), averageDeliveryTime(0.0)
 {
     ratedDate = QDateTime::currentDateTime();
-}
-
-double SupplierRating::getOverallRating() const
-{
-    return (qualityScore + deliveryScore + priceScore + communicationScore) / 4.0;
+    updateOverall();
 }
 
 double SupplierRating::getOnTimePercentage() const
@@ -134,6 +135,34 @@ bool FilterCriteria::matches(const QString& fNom, const QString& fEmail,
     return true;
 }
 
+QVector<bool> FilterCriteria::matchingTypes() const
+{
+    if (typeProduits.isEmpty()) return QVector<bool>();
+    int codes = ProductTypes::count();
+    QVector<bool> types(codes);
+    for (int code = 0; code < codes; ++code) {
+        types[code] = ProductTypes::label(quint32(code)).contains(typeProduits, Qt::CaseInsensitive);
+    }
+    return types;
+}
+
+bool FilterCriteria::matches(const Fournisseur& f, int rating, const QVector<bool>& types) const
+{
+    if (activeOnly && !f.getIsActive()) return false;
+    if (rating < minRating || rating > maxRating) return false;
+    if (!typeProduits.isEmpty()) {
+        // Codes interned after matchingTypes() was computed are checked by label
+        int code = int(f.getTypeCode());
+        bool typeOk = code < types.size()
+            ? types[code] : f.getTypeProduits().contains(typeProduits, Qt::CaseInsensitive);
+        if (!typeOk) return false;
+    }
+    if (!nom.isEmpty() && !f.getNom().contains(nom, Qt::CaseInsensitive)) return false;
+    if (!email.isEmpty() && !f.getEmail().contains(email, Qt::CaseInsensitive)) return false;
+    if (!adresse.isEmpty() && !f.getAdresse().contains(adresse, Qt::CaseInsensitive)) return false;
+    return true;
+}
+
 // ===== BackupManager Implementation =====
 bool BackupManager::createBackup(const QString& sourceFile, QString& backupPath)
 {
@@ -175,14 +204,18 @@ bool BackupManager::autoBackup(const QString& sourceFile, int maxBackups)
         return false;
     }
     
-    // Remove old backups if exceeding max
-    QStringList backups = listBackups();
+    pruneBackups(maxBackups);
+    return true;
+}
+
+void BackupManager::pruneBackups(int maxBackups, const QString& backupDir)
+{
+    // Remove old backups if exceeding max (listBackups is newest first)
+    QStringList backups = listBackups(backupDir);
     while (backups.size() > maxBackups) {
-        QFile::remove("backups/" + backups.last());
+        QFile::remove(backupDir + "/" + backups.last());
         backups.removeLast();
     }
-    
-    return true;
 }
 
 // ===== CSVManager Implementation =====
@@ -226,54 +259,67 @@ QStringList CSVManager::parseCSVLine(const QString& line)
 
 bool CSVManager::exportToCSV(const QString& fileName, const QList<Fournisseur>& fournisseurs)
 {
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    TRACE_SCOPE("CSVManager::exportToCSV");
+    MemoryScope memory("exportToCSV", MemoryAccounting::Suppliers,
+                       MemoryAccounting::hooksCompiledIn() ? MemoryAccounting::estimate(fournisseurs) : 0);
+    CSVWriter writer;
+    if (!writer.open(fileName)) {
         return false;
     }
     
-    QTextStream out(&file);
-    
-    // Header
-    out << "ID,Nom,Adresse,Email,Telephone,TypeProduits,HistoriqueLivraisons\n";
-    
-    // Data
     for (const Fournisseur& f : fournisseurs) {
-        out << f.getIdFournisseur() << ","
-            << escapeCSV(f.getNom()) << ","
-            << escapeCSV(f.getAdresse()) << ","
-            << escapeCSV(f.getEmail()) << ","
-            << escapeCSV(f.getTelephone()) << ","
-            << escapeCSV(f.getTypeProduits()) << ","
-            << escapeCSV(f.getHistoriqueLivraisons()) << "\n";
+        writer.write(f);
     }
     
-    file.close();
-    return true;
+    return writer.close();
 }
 
 QList<Fournisseur> CSVManager::importFromCSV(const QString& fileName, bool& success)
 {
+    TRACE_SCOPE("CSVManager::importFromCSV");
     QList<Fournisseur> fournisseurs;
     success = false;
     
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    MemoryScope memory("importFromCSV", MemoryAccounting::Suppliers, QFileInfo(fileName).size());
+    CSVReader reader;
+    if (!reader.open(fileName)) {
         return fournisseurs;
     }
     
-    QTextStream in(&file);
+    Fournisseur f;
+    while (reader.next(f)) {
+        fournisseurs.append(f);
+    }
+    
+    reader.close();
+    success = true;
+    return fournisseurs;
+}
+
+// ===== CSVReader / CSVWriter Implementation =====
+bool CSVReader::open(const QString& fileName)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+    in.setDevice(&file);
     
     // Skip header
     if (!in.atEnd()) {
         in.readLine();
     }
-    
+    return true;
+}
+
+bool CSVReader::next(Fournisseur& f)
+{
     while (!in.atEnd()) {
-        QString line = in.readLine();
-        QStringList fields = parseCSVLine(line);
+        QStringList fields = CSVManager::parseCSVLine(in.readLine());
         
+        // Short lines (blank or truncated) are skipped, as before
         if (fields.size() >= 7) {
-            Fournisseur f(
+            f = Fournisseur(
                 fields[0].toInt(),
                 fields[1],
                 fields[2],
@@ -282,11 +328,202 @@ QList<Fournisseur> CSVManager::importFromCSV(const QString& fileName, bool& succ
                 fields[5],
                 fields[6]
             );
-            fournisseurs.append(f);
+            return true;
+        }
+    }
+    return false;
+}
+
+double CSVReader::progress() const
+{
+    // Device position runs ahead by the stream buffer: close enough for progress,
+    // and QTextStream::pos() would re-decode the buffer on every call
+    qint64 size = file.size();
+    return size > 0 ? qMin(1.0, double(file.pos()) / size) : 1.0;
+}
+
+bool CSVWriter::open(const QString& fileName)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    out.setDevice(&file);
+    
+    // Header
+    out << "ID,Nom,Adresse,Email,Telephone,TypeProduits,HistoriqueLivraisons\n";
+    return true;
+}
+
+void CSVWriter::write(const Fournisseur& f)
+{
+    out << f.getIdFournisseur() << ","
+        << CSVManager::escapeCSV(f.getNom()) << ","
+        << CSVManager::escapeCSV(f.getAdresse()) << ","
+        << CSVManager::escapeCSV(f.getEmail()) << ","
+        << CSVManager::escapeCSV(f.getTelephone()) << ","
+        << CSVManager::escapeCSV(f.getTypeProduits()) << ","
+        << CSVManager::escapeCSV(f.getHistoriqueLivraisons()) << "\n";
+}
+
+bool CSVWriter::close()
+{
+    out.flush();
+    bool ok = out.status() == QTextStream::Ok && file.error() == QFileDevice::NoError;
+    file.close();
+    return ok;
+}
+
+bool JsonArrayWriter::open(const QString& fileName)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    first = true;
+    file.write("[\n");
+    return true;
+}
+
+void JsonArrayWriter::write(const Fournisseur& f)
+{
+    if (!first) file.write(",\n");
+    first = false;
+    file.write(QJsonDocument(f.toJson()).toJson(QJsonDocument::Compact));
+}
+
+bool JsonArrayWriter::close()
+{
+    file.write("\n]\n");
+    bool ok = file.error() == QFileDevice::NoError;
+    file.close();
+    return ok;
+}
+
+// ===== SupplierSorter Implementation =====
+namespace {
+// Each score is read once into a key array; the sort compares plain doubles
+template <typename ScoreOf>
+void sortByScore(QList<Fournisseur>& fournisseurs, ScoreOf scoreOf)
+{
+    QVector<QPair<double, int>> keys(fournisseurs.size());
+    for (int i = 0; i < fournisseurs.size(); ++i) {
+        keys[i] = qMakePair(-scoreOf(fournisseurs[i].getIdFournisseur()), i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    QList<Fournisseur> sorted(fournisseurs.size());
+    for (int i = 0; i < keys.size(); ++i) sorted[i] = std::move(fournisseurs[keys[i].second]);
+    fournisseurs = std::move(sorted);
+}
+}
+
+void SupplierSorter::sortById(QList<Fournisseur>& fournisseurs)
+{
+    std::sort(fournisseurs.begin(), fournisseurs.end(),
+              [](const Fournisseur& a, const Fournisseur& b) {
+                  return a.getIdFournisseur() < b.getIdFournisseur();
+              });
+}
+
+void SupplierSorter::sortByNom(QList<Fournisseur>& fournisseurs)
+{
+    std::sort(fournisseurs.begin(), fournisseurs.end(),
+              [](const Fournisseur& a, const Fournisseur& b) {
+                  return a.getNom() < b.getNom();
+              });
+}
+
+void SupplierSorter::sortByTypeProduits(QList<Fournisseur>& fournisseurs)
+{
+    // Counting sort on the rank of each type code: only the distinct labels
+    // are compared, and rows of the same type keep their order
+    QVector<int> ranks = ProductTypes::sortRanks();
+    QVector<int> starts(ranks.size() + 1, 0);
+    for (const Fournisseur& f : fournisseurs) starts[ranks[int(f.getTypeCode())] + 1]++;
+    for (int rank = 1; rank < starts.size(); ++rank) starts[rank] += starts[rank - 1];
+
+    QList<Fournisseur> sorted(fournisseurs.size());
+    for (Fournisseur& f : fournisseurs) {
+        sorted[starts[ranks[int(f.getTypeCode())]]++] = std::move(f);
+    }
+    fournisseurs = std::move(sorted);
+}
+
+void SupplierSorter::sortByRating(QList<Fournisseur>& fournisseurs,
+                                  const QList<SupplierRating>& ratings)
+{
+    // Look scores up once instead of scanning the ratings on every comparison
+    QHash<int, double> scores;
+    scores.reserve(ratings.size());
+    for (const SupplierRating& rating : ratings) {
+        if (!scores.contains(rating.getFournisseurId())) {
+            scores.insert(rating.getFournisseurId(), rating.getOverallRating());
         }
     }
+    sortByScore(fournisseurs, [&scores](int id) { return scores.value(id, 0.0); });
+}
+
+void SupplierSorter::sortByRating(QList<Fournisseur>& fournisseurs,
+                                  const RatingHistory& history, RatingHistory::Window window)
+{
+    TRACE_SCOPE("SupplierSorter::sortByRating");
+    sortByScore(fournisseurs, [&history, window](int id) {
+        return history.contains(id) ? history.score(id, window) : -1.0;
+    });
+}
+
+// ===== JsonStorage Implementation =====
+bool JsonStorage::saveToFile(const QString& fileName, const QList<Fournisseur>& fournisseurs)
+{
+    TRACE_SCOPE("JsonStorage::saveToFile");
+    MemoryScope memory("JsonStorage::saveToFile", MemoryAccounting::JsonDom,
+                       MemoryAccounting::hooksCompiledIn() ? MemoryAccounting::estimate(fournisseurs) : 0);
+    QJsonArray jsonArray;
+    for (const Fournisseur& f : fournisseurs) {
+        jsonArray.append(f.toJson());
+    }
+
+    QJsonDocument doc(jsonArray);
+    QFile file(fileName);
     
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(doc.toJson());
     file.close();
+    return true;
+}
+
+QList<Fournisseur> JsonStorage::loadFromFile(const QString& fileName, bool& success)
+{
+    TRACE_SCOPE("JsonStorage::loadFromFile");
+    QList<Fournisseur> fournisseurs;
+    success = false;
+
+    QFile file(fileName);
+    MemoryScope memory("JsonStorage::loadFromFile", MemoryAccounting::JsonDom, file.size());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fournisseurs;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+
+    QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (!doc.isArray()) {
+        return fournisseurs;
+    }
+
+    QJsonArray jsonArray = doc.array();
+    fournisseurs.reserve(jsonArray.size());
+    ColdTextStore::Builder cold;
+    for (const QJsonValue& value : jsonArray) {
+        if (value.isObject()) {
+            Fournisseur f = Fournisseur::fromJson(value.toObject());
+            f.setHistoriqueLivraisons(cold.add(f.getHistoriqueLivraisons()));
+            fournisseurs.append(f);
+        }
+    }
+    cold.finish();
+
     success = true;
     return fournisseurs;
 }
@@ -296,69 +533,163 @@ AdvancedStats::Stats AdvancedStats::calculateStats(const QList<Fournisseur>& fou
                                                    const QList<SupplierRating>& ratings,
                                                    const QList<ActivityLog>& activities)
 {
-    Stats stats;
-    stats.totalSuppliers = fournisseurs.size();
+    TRACE_SCOPE("AdvancedStats::calculateStats");
+    Accumulator accumulator(ratings, activities);
+    for (const Fournisseur& f : fournisseurs) {
+        accumulator.add(f);
+    }
+    return accumulator.result();
+}
+
+QMap<QString, int> AdvancedStats::productTypeDistribution(const QList<Fournisseur>& fournisseurs)
+{
+    QVector<int> counts(ProductTypes::count(), 0);
+    for (const Fournisseur& f : fournisseurs) {
+        int code = int(f.getTypeCode());
+        if (code >= counts.size()) counts.resize(code + 1);
+        counts[code]++;
+    }
+    return labelTypeCounts(counts);
+}
+
+QMap<QString, int> AdvancedStats::labelTypeCounts(const QVector<int>& countsByCode)
+{
+    QMap<QString, int> distribution;
+    for (int code = 0; code < countsByCode.size(); ++code) {
+        if (countsByCode[code] == 0) continue;
+        QString type = ProductTypes::label(quint32(code));
+        if (type.isEmpty()) type = "Non spécifié";
+        distribution[type] += countsByCode[code];
+    }
+    return distribution;
+}
+
+AdvancedStats::Accumulator::Accumulator(const QList<SupplierRating>& ratings,
+                                        const QList<ActivityLog>& activities)
+{
+    init(activities);
+    ratingOf.reserve(ratings.size());
+    for (const SupplierRating& rating : ratings) {
+        addRating(rating.getFournisseurId(), rating.getOverallRating());
+    }
+    finishRatings();
+    
+    // A single rating per supplier: its decayed averages are the rating itself
+    stats.averageRating30 = stats.averageRating;
+    stats.averageRating90 = stats.averageRating;
+}
+
+AdvancedStats::Accumulator::Accumulator(const RatingHistory& history,
+                                        const QList<ActivityLog>& activities)
+{
+    init(activities);
+    ratingOf.reserve(history.supplierCount());
+    double total30 = 0.0;
+    double total90 = 0.0;
+    for (int id : history.suppliers()) {
+        const RatingScores& scores = history.scores(id);
+        addRating(id, scores.allTime);
+        total30 += scores.decayed30;
+        total90 += scores.decayed90;
+    }
+    finishRatings();
+    
+    if (history.supplierCount() > 0) {
+        stats.averageRating30 = total30 / history.supplierCount();
+        stats.averageRating90 = total90 / history.supplierCount();
+    }
+}
+
+void AdvancedStats::Accumulator::init(const QList<ActivityLog>& activities)
+{
+    topRatedId = -1;
+    totalRating = 0.0;
+    maxRating = 0.0;
+    stats.totalSuppliers = 0;
     stats.activeSuppliers = 0;
     stats.inactiveSuppliers = 0;
     stats.averageRating = 0.0;
+    stats.ratingMedian = 0.0;
+    stats.ratingP90 = 0.0;
+    stats.averageRating30 = 0.0;
+    stats.averageRating90 = 0.0;
     stats.totalActivities = activities.size();
+}
+
+// Ratings first, so the top rated name can be picked up while streaming
+void AdvancedStats::Accumulator::addRating(int fournisseurId, double overall)
+{
+    totalRating += overall;
+    ratingDigest.add(overall);
+    ratingOf.insert(fournisseurId, overall);
+    
+    int roundedRating = qRound(overall);
+    stats.ratingDistribution[roundedRating]++;
+    
+    if (overall > maxRating) {
+        maxRating = overall;
+        topRatedId = fournisseurId;
+    }
+}
+
+void AdvancedStats::Accumulator::finishRatings()
+{
+    if (ratingDigest.isEmpty()) return;
+    stats.averageRating = totalRating / ratingDigest.count();
+    stats.ratingMedian = ratingDigest.quantile(0.5);
+    stats.ratingP90 = ratingDigest.quantile(0.9);
+    ratingDigest.compress();
+}
+
+void AdvancedStats::Accumulator::add(const Fournisseur& f)
+{
+    stats.totalSuppliers++;
     
     // Count active/inactive
-    for (const Fournisseur& f : fournisseurs) {
-        if (f.getIsActive()) {
-            stats.activeSuppliers++;
-        } else {
-            stats.inactiveSuppliers++;
-        }
-        
-        // Product type distribution
-        QString type = f.getTypeProduits();
-        if (type.isEmpty()) type = "Non spécifié";
-        stats.productTypeDistribution[type]++;
+    if (f.getIsActive()) {
+        stats.activeSuppliers++;
+    } else {
+        stats.inactiveSuppliers++;
     }
     
-    // Calculate average rating and find top rated
-    double totalRating = 0.0;
-    double maxRating = 0.0;
-    int maxRatingId = -1;
+    // Product type distribution, labelled in result()
+    int code = int(f.getTypeCode());
+    if (code >= typeCounts.size()) typeCounts.resize(qMax(code + 1, ProductTypes::count()));
+    typeCounts[code]++;
     
-    for (const SupplierRating& rating : ratings) {
-        double overall = rating.getOverallRating();
-        totalRating += overall;
-        
-        int roundedRating = qRound(overall);
-        stats.ratingDistribution[roundedRating]++;
-        
-        if (overall > maxRating) {
-            maxRating = overall;
-            maxRatingId = rating.getFournisseurId();
-        }
+    auto rating = ratingOf.constFind(f.getIdFournisseur());
+    if (rating != ratingOf.constEnd()) {
+        if (code >= typeRatings.size()) typeRatings.resize(typeCounts.size());
+        typeRatings[code].add(*rating);
     }
     
-    if (!ratings.isEmpty()) {
-        stats.averageRating = totalRating / ratings.size();
+    // Top rated supplier name (first match wins)
+    if (topRatedId != -1 && stats.topRatedSupplier.isEmpty() &&
+        f.getIdFournisseur() == topRatedId) {
+        stats.topRatedSupplier = f.getNom();
     }
-    
-    // Find top rated supplier name
-    if (maxRatingId != -1) {
-        for (const Fournisseur& f : fournisseurs) {
-            if (f.getIdFournisseur() == maxRatingId) {
-                stats.topRatedSupplier = f.getNom();
-                break;
-            }
-        }
+}
+
+AdvancedStats::Stats AdvancedStats::Accumulator::result() const
+{
+    Stats summary = stats;
+    summary.productTypeDistribution = labelTypeCounts(typeCounts);
+    for (int code = 0; code < typeRatings.size(); ++code) {
+        if (typeRatings[code].isEmpty()) continue;
+        QString type = ProductTypes::label(quint32(code));
+        if (type.isEmpty()) type = "Non spécifié";
+        summary.ratingsByProductType[type].merge(typeRatings[code]);
     }
     
     // Find most common product type
     int maxCount = 0;
-    for (auto it = stats.productTypeDistribution.begin(); 
-         it != stats.productTypeDistribution.end(); ++it) {
+    for (auto it = summary.productTypeDistribution.constBegin(); 
+         it != summary.productTypeDistribution.constEnd(); ++it) {
         if (it.value() > maxCount) {
             maxCount = it.value();
-            stats.mostCommonProductType = it.key();
+            summary.mostCommonProductType = it.key();
         }
     }
     
-    return stats;
+    return summary;
 }
-
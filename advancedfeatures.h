@@ -4,8 +4,15 @@
 #include <QString>
 #include <QDateTime>
 #include <QList>
+#include <QVector>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QFile>
+#include <QTextStream>
+#include <QHash>
+#include <QMap>
+#include "tdigest.h"
+#include "ratinghistory.h"
 
 // Activity Log Entry
 class ActivityLog
@@ -45,6 +52,9 @@ private:
     int totalOrders;
     int onTimeDeliveries;
     double averageDeliveryTime; // in days
+    double overall;             // mean of the four scores, kept up to date by the setters
+
+    void updateOverall() { overall = (qualityScore + deliveryScore + priceScore + communicationScore) / 4.0; }
 
 public:
     SupplierRating();
@@ -60,17 +70,19 @@ public:
     int getTotalOrders() const { return totalOrders; }
     int getOnTimeDeliveries() const { return onTimeDeliveries; }
     double getAverageDeliveryTime() const { return averageDeliveryTime; }
+    QDateTime getRatedDate() const { return ratedDate; }
     
-    void setQualityScore(int score) { qualityScore = score; }
-    void setDeliveryScore(int score) { deliveryScore = score; }
-    void setPriceScore(int score) { priceScore = score; }
-    void setCommunicationScore(int score) { communicationScore = score; }
+    void setQualityScore(int score) { qualityScore = score; updateOverall(); }
+    void setDeliveryScore(int score) { deliveryScore = score; updateOverall(); }
+    void setPriceScore(int score) { priceScore = score; updateOverall(); }
+    void setCommunicationScore(int score) { communicationScore = score; updateOverall(); }
+    void setRatedDate(const QDateTime& date) { ratedDate = date; }
     void setComments(const QString& c) { comments = c; }
     void setTotalOrders(int total) { totalOrders = total; }
     void setOnTimeDeliveries(int onTime) { onTimeDeliveries = onTime; }
     void setAverageDeliveryTime(double avgDays) { averageDeliveryTime = avgDays; }
     
-    double getOverallRating() const;
+    double getOverallRating() const { return overall; }
     double getOnTimePercentage() const;
     QString getPerformanceLevel() const; // "Excellent", "Good", "Average", "Poor"
     
@@ -94,6 +106,10 @@ public:
     bool matches(const QString& fNom, const QString& fEmail, 
                 const QString& fType, const QString& fAddr, 
                 int rating, bool isActive) const;
+    
+    // Type filter resolved once per product type code instead of once per row
+    QVector<bool> matchingTypes() const;
+    bool matches(const class Fournisseur& f, int rating, const QVector<bool>& types) const;
 };
 
 // Backup Manager
@@ -104,6 +120,7 @@ public:
     static bool restoreBackup(const QString& backupFile, const QString& targetFile);
     static QStringList listBackups(const QString& backupDir = "backups");
     static bool autoBackup(const QString& sourceFile, int maxBackups = 10);
+    static void pruneBackups(int maxBackups, const QString& backupDir = "backups");
 };
 
 // CSV Export/Import
@@ -116,6 +133,67 @@ public:
     static QStringList parseCSVLine(const QString& line);
 };
 
+// Row-at-a-time CSV reading, for files that do not fit in a QList
+class CSVReader
+{
+private:
+    QFile file;
+    QTextStream in;
+
+public:
+    bool open(const QString& fileName);
+    bool next(class Fournisseur& f);     // false at end of file
+    double progress() const;            // 0..1, by bytes consumed
+    void close() { file.close(); }
+};
+
+class CSVWriter
+{
+private:
+    QFile file;
+    QTextStream out;
+
+public:
+    bool open(const QString& fileName);
+    void write(const class Fournisseur& f);
+    bool close();                       // false if any write failed
+};
+
+// Writes the same layout as JsonStorage::saveToFile, one object at a time
+class JsonArrayWriter
+{
+private:
+    QFile file;
+    bool first = true;
+
+public:
+    bool open(const QString& fileName);
+    void write(const class Fournisseur& f);
+    bool close();                       // false if any write failed
+};
+
+// Sorting helpers shared by the GUI, the benchmarks and batch tools
+class SupplierSorter
+{
+public:
+    static void sortById(QList<class Fournisseur>& fournisseurs);
+    static void sortByNom(QList<class Fournisseur>& fournisseurs);
+    static void sortByTypeProduits(QList<class Fournisseur>& fournisseurs);
+    static void sortByRating(QList<class Fournisseur>& fournisseurs,
+                             const QList<SupplierRating>& ratings);
+    // Best first on the history's precomputed score; unrated suppliers last
+    static void sortByRating(QList<class Fournisseur>& fournisseurs,
+                             const RatingHistory& history, RatingHistory::Window window);
+};
+
+// JSON file persistence for the supplier list
+class JsonStorage
+{
+public:
+    static bool saveToFile(const QString& fileName, const QList<class Fournisseur>& fournisseurs);
+    static QList<class Fournisseur> loadFromFile(const QString& fileName, bool& success);
+};
+
 // Statistics Calculator
 class AdvancedStats
 {
@@ -125,16 +203,50 @@ public:
         int activeSuppliers;
         int inactiveSuppliers;
         double averageRating;
+        double ratingMedian;
+        double ratingP90;
+        double averageRating30;         // mean of the decayed scores (= averageRating without history)
+        double averageRating90;
         QString topRatedSupplier;
         QString mostCommonProductType;
         int totalActivities;
         QMap<QString, int> productTypeDistribution;
         QMap<int, int> ratingDistribution;
+        QMap<QString, TDigest> ratingsByProductType;    // rated suppliers only
     };
     
     static Stats calculateStats(const QList<class Fournisseur>& fournisseurs,
                                 const QList<SupplierRating>& ratings,
                                 const QList<ActivityLog>& activities);
+
+    // Suppliers per product type: counted by type code, labelled at the end
+    static QMap<QString, int> productTypeDistribution(const QList<class Fournisseur>& fournisseurs);
+    static QMap<QString, int> labelTypeCounts(const QVector<int>& countsByCode);
+
+    // Same statistics, fed one supplier at a time (streaming sources)
+    class Accumulator
+    {
+    private:
+        Stats stats;
+        int topRatedId;
+        QVector<int> typeCounts;        // indexed by ProductTypes code
+        QHash<int, double> ratingOf;    // overall rating by supplier id
+        QVector<TDigest> typeRatings;   // indexed by ProductTypes code
+        TDigest ratingDigest;
+        double totalRating;
+        double maxRating;
+
+        void init(const QList<ActivityLog>& activities);
+        void addRating(int fournisseurId, double overall);
+        void finishRatings();
+
+    public:
+        Accumulator(const QList<SupplierRating>& ratings, const QList<ActivityLog>& activities);
+        // Each supplier counts once, with its all-time score; averages per window
+        Accumulator(const RatingHistory& history, const QList<ActivityLog>& activities);
+        void add(const class Fournisseur& f);
+        Stats result() const;
+    };
 };
 
 #endif // ADVANCEDFEATURES_H
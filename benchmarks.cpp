@@ -0,0 +1,818 @@
+/**
+ * PERFORMANCE BENCHMARKS (QtTest)
+ *
+ * qmake benchmarks.pro && make && ./benchmarks
+ *
+ * Datasets are generated deterministically (DatasetGenerator) at 10k and
+ * 100k rows; set FOURNISSEUR_BENCH_MAX_ROWS=1000000 (or 10000000) to add
+ * the large runs. Besides the usual QtTest output, the best time of every
+ * benchmark is written to bench_results.json (or FOURNISSEUR_BENCH_JSON).
+ * Built with CONFIG+=memtrack, file-format runs also report their peakBytes
+ * (operator new allocations only: QString / QList buffers are not counted).
+ * compactStorage records the compact table's bytes next to the QList estimate,
+ * prefixIndex the autocomplete indexes' bytes next to the strings they index.
+ *
+ * replayWorkload re-issues a real capture (GUI: "Enregistrer la Charge") set
+ * in FOURNISSEUR_BENCH_WORKLOAD against JSON, SQLite and the in-memory engine,
+ * 4 clients, max speed.
+ */
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <algorithm>
+#include <random>
+#include "fournisseur.h"
+#include "advancedfeatures.h"
+#include "databasemanager.h"
+#include "datasetgenerator.h"
+#include "memorytracker.h"
+#include "workload.h"
+#include "compactstorage.h"
+#include "leaderboard.h"
+#include "prefixindex.h"
+#include "contactindex.h"
+
+// Best-of-N timer for the measured section of a QBENCHMARK body
+class BenchTimer
+{
+private:
+    QElapsedTimer timer;
+    qint64 best;
+    int iterations;
+
+public:
+    BenchTimer() : best(-1), iterations(0) {}
+    void start() { timer.start(); }
+    void stop()
+    {
+        qint64 ns = timer.nsecsElapsed();
+        if (best < 0 || ns < best) best = ns;
+        ++iterations;
+    }
+    qint64 bestNs() const { return best; }
+    int getIterations() const { return iterations; }
+};
+
+class FournisseurBenchmarks : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir workDir;
+    int maxRows;
+    QHash<int, QList<Fournisseur>> datasets;
+    QHash<int, QList<Fournisseur>> shuffledDatasets;
+    QHash<int, QList<SupplierRating>> ratingSets;
+    QJsonArray results;
+
+    DatabaseManager *db;
+    DatabaseManager::DatabaseType dbType;
+    int dbRows;
+
+    const QList<Fournisseur>& dataset(int rows);
+    const QList<Fournisseur>& shuffled(int rows);
+    const QList<SupplierRating>& ratings(int rows);
+    bool ensureDatabase(int rows, DatabaseManager::DatabaseType type, BenchTimer *timer = nullptr);
+    void addSizes(int cap = 0);
+    void record(const BenchTimer& timer, const char* memoryOperation = nullptr);
+    void benchmarkSort(void (*sorter)(QList<Fournisseur>&));
+    // Same CRUD loop for every DatabaseManager backend
+    void crudBulkInsert(DatabaseManager::DatabaseType type);
+    void crudGetAll(DatabaseManager::DatabaseType type);
+    void crudSearch(DatabaseManager::DatabaseType type);
+    void crudGetById(DatabaseManager::DatabaseType type);
+    void crudUpdate(DatabaseManager::DatabaseType type);
+    void crudDelete(DatabaseManager::DatabaseType type);
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void generate_data() { addSizes(); }
+    void generate();
+    void csvExport_data() { addSizes(); }
+    void csvExport();
+    void csvImport_data() { addSizes(); }
+    void csvImport();
+    void jsonSave_data() { addSizes(); }
+    void jsonSave();
+    void jsonLoad_data() { addSizes(); }
+    void jsonLoad();
+    void filterMatches_data() { addSizes(); }
+    void filterMatches();
+    void sortById_data() { addSizes(); }
+    void sortById();
+    void sortByNom_data() { addSizes(); }
+    void sortByNom();
+    void sortByTypeProduits_data() { addSizes(); }
+    void sortByTypeProduits();
+    void sortByRating_data() { addSizes(); }
+    void sortByRating();
+    void sortByRatingHistory_data() { addSizes(); }
+    void sortByRatingHistory();
+    void leaderboardUpdate_data() { addSizes(); }
+    void leaderboardUpdate();
+    void calculateStats_data() { addSizes(); }
+    void calculateStats();
+    void compactStorage_data() { addSizes(); }
+    void compactStorage();
+    void prefixIndex_data() { addSizes(); }
+    void prefixIndex();
+    void deliveryWindow_data() { addSizes(); }
+    void deliveryWindow();
+    void leadTimePercentiles_data() { addSizes(); }
+    void leadTimePercentiles();
+    void contactIndexBuild_data() { addSizes(); }
+    void contactIndexBuild();
+
+    // SQLite CRUD, capped at 1M rows
+    void sqliteBulkInsert_data() { addSizes(1000000); }
+    void sqliteBulkInsert() { crudBulkInsert(DatabaseManager::SQLite); }
+    void sqliteGetAll_data() { addSizes(1000000); }
+    void sqliteGetAll() { crudGetAll(DatabaseManager::SQLite); }
+    void sqliteSearch_data() { addSizes(1000000); }
+    void sqliteSearch() { crudSearch(DatabaseManager::SQLite); }
+    void sqliteGetById_data() { addSizes(1000000); }
+    void sqliteGetById() { crudGetById(DatabaseManager::SQLite); }
+    void sqliteUpdate_data() { addSizes(1000000); }
+    void sqliteUpdate() { crudUpdate(DatabaseManager::SQLite); }
+    void sqliteDelete_data() { addSizes(1000000); }
+    void sqliteDelete() { crudDelete(DatabaseManager::SQLite); }
+
+    // Same operations on the embedded engine (no SQL layer)
+    void memoryBulkInsert_data() { addSizes(1000000); }
+    void memoryBulkInsert() { crudBulkInsert(DatabaseManager::InMemory); }
+    void memoryGetAll_data() { addSizes(1000000); }
+    void memoryGetAll() { crudGetAll(DatabaseManager::InMemory); }
+    void memorySearch_data() { addSizes(1000000); }
+    void memorySearch() { crudSearch(DatabaseManager::InMemory); }
+    void memoryGetById_data() { addSizes(1000000); }
+    void memoryGetById() { crudGetById(DatabaseManager::InMemory); }
+    void memoryUpdate_data() { addSizes(1000000); }
+    void memoryUpdate() { crudUpdate(DatabaseManager::InMemory); }
+    void memoryDelete_data() { addSizes(1000000); }
+    void memoryDelete() { crudDelete(DatabaseManager::InMemory); }
+
+    // Recorded mix instead of synthetic loops (skipped without a capture)
+    void replayWorkload_data();
+    void replayWorkload();
+};
+
+// ===== Fixtures =====
+
+void FournisseurBenchmarks::initTestCase()
+{
+    QVERIFY(workDir.isValid());
+    maxRows = qEnvironmentVariableIsSet("FOURNISSEUR_BENCH_MAX_ROWS")
+        ? qEnvironmentVariableIntValue("FOURNISSEUR_BENCH_MAX_ROWS")
+        : 100000;
+    db = nullptr;
+    dbType = DatabaseManager::SQLite;
+    dbRows = -1;
+}
+
+void FournisseurBenchmarks::cleanupTestCase()
+{
+    delete db;
+    db = nullptr;
+
+    QJsonObject report;
+    report["suite"] = "fournisseur-benchmarks";
+    report["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    report["qtVersion"] = QString(qVersion());
+    report["cpu"] = QSysInfo::currentCpuArchitecture();
+    report["maxRows"] = maxRows;
+    report["results"] = results;
+
+    QString path = qEnvironmentVariableIsSet("FOURNISSEUR_BENCH_JSON")
+        ? qEnvironmentVariable("FOURNISSEUR_BENCH_JSON")
+        : QString("bench_results.json");
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(report).toJson());
+        file.close();
+        qDebug() << "📊 Benchmark results written to" << path;
+    }
+}
+
+void FournisseurBenchmarks::addSizes(int cap)
+{
+    QTest::addColumn<int>("rows");
+    const int sizes[] = { 10000, 100000, 1000000, 10000000 };
+    for (int rows : sizes) {
+        if (rows > maxRows || (cap > 0 && rows > cap)) break;
+        QTest::newRow(QByteArray::number(rows / 1000) + "k") << rows;
+    }
+}
+
+const QList<Fournisseur>& FournisseurBenchmarks::dataset(int rows)
+{
+    if (!datasets.contains(rows)) {
+        DatasetGenerator generator;
+        datasets.insert(rows, generator.generate(rows));
+    }
+    return datasets[rows];
+}
+
+const QList<Fournisseur>& FournisseurBenchmarks::shuffled(int rows)
+{
+    if (!shuffledDatasets.contains(rows)) {
+        QList<Fournisseur> copy = dataset(rows);
+        std::mt19937 rng(rows);
+        std::shuffle(copy.begin(), copy.end(), rng);
+        shuffledDatasets.insert(rows, copy);
+    }
+    return shuffledDatasets[rows];
+}
+
+const QList<SupplierRating>& FournisseurBenchmarks::ratings(int rows)
+{
+    if (!ratingSets.contains(rows)) {
+        DatasetGenerator generator(rows);
+        ratingSets.insert(rows, generator.generateRatings(dataset(rows)));
+    }
+    return ratingSets[rows];
+}
+
+bool FournisseurBenchmarks::ensureDatabase(int rows, DatabaseManager::DatabaseType type, BenchTimer *timer)
+{
+    if (dbRows == rows && dbType == type && db && db->isConnected()) return true;
+
+    delete db;
+    db = new DatabaseManager(type);
+    dbType = type;
+    // The in-memory engine journals to disk too: its timings include durability
+    QString path = workDir.filePath(QString(type == DatabaseManager::InMemory ? "bench_%1.journal"
+                                                                            : "bench_%1.db").arg(rows));
+    QFile::remove(path);
+    if (!db->connectToDatabase(path) || !db->createTables()) return false;
+
+    const QList<Fournisseur>& data = dataset(rows);
+    if (timer) timer->start();
+    bool ok = db->importFromJson(data);
+    if (timer) timer->stop();
+
+    dbRows = ok ? rows : -1;
+    return ok;
+}
+
+void FournisseurBenchmarks::record(const BenchTimer& timer, const char* memoryOperation)
+{
+    QFETCH(int, rows);
+
+    QJsonObject entry;
+    entry["benchmark"] = QString(QTest::currentTestFunction());
+    entry["dataset"] = QString(QTest::currentDataTag());
+    entry["rows"] = rows;
+    entry["bestNs"] = double(timer.bestNs());
+    entry["nsPerRow"] = rows > 0 ? double(timer.bestNs()) / rows : 0.0;
+    entry["iterations"] = timer.getIterations();
+    if (memoryOperation && MemoryAccounting::hooksCompiledIn()) {
+        MemoryAccounting::OperationStats stats = MemoryAccounting::operations().value(memoryOperation);
+        entry["peakBytes"] = double(stats.lastPeakBytes);
+        entry["peakBytesPerRow"] = rows > 0 ? double(stats.lastPeakBytes) / rows : 0.0;
+    }
+    results.append(entry);
+}
+
+// ===== Generation and file formats =====
+
+void FournisseurBenchmarks::generate()
+{
+    QFETCH(int, rows);
+    BenchTimer timer;
+    QBENCHMARK_ONCE {
+        DatasetGenerator generator;
+        timer.start();
+        QList<Fournisseur> data = generator.generate(rows);
+        timer.stop();
+        QCOMPARE(data.size(), rows);
+    }
+    record(timer);
+}
+
+void FournisseurBenchmarks::csvExport()
+{
+    QFETCH(int, rows);
+    const QList<Fournisseur>& data = dataset(rows);
+    QString path = workDir.filePath(QString("export_%1.csv").arg(rows));
+    BenchTimer timer;
+    QBENCHMARK {
+        timer.start();
+        QVERIFY(CSVManager::exportToCSV(path, data));
+        timer.stop();
+    }
+    record(timer, "exportToCSV");
+}
+
+void FournisseurBenchmarks::csvImport()
+{
+    QFETCH(int, rows);
+    QString path = workDir.filePath(QString("import_%1.csv").arg(rows));
+    if (!QFile::exists(path)) {
+        DatasetGenerator generator;
+        QVERIFY(generator.writeCSV(path, rows));
+    }
+    BenchTimer timer;
+    QBENCHMARK {
+        bool success;
+        timer.start();
+        QList<Fournisseur> imported = CSVManager::importFromCSV(path, success);
+        timer.stop();
+        QVERIFY(success);
+        QCOMPARE(imported.size(), rows);
+    }
+    record(timer, "importFromCSV");
+}
+
+void FournisseurBenchmarks::jsonSave()
+{
+    QFETCH(int, rows);
+    const QList<Fournisseur>& data = dataset(rows);
+    QString path = workDir.filePath(QString("save_%1.json").arg(rows));
+    BenchTimer timer;
+    QBENCHMARK {
+        timer.start();
+        QVERIFY(JsonStorage::saveToFile(path, data));
+        timer.stop();
+    }
+    record(timer, "JsonStorage::saveToFile");
+}
+
+void FournisseurBenchmarks::jsonLoad()
+{
+    QFETCH(int, rows);
+    QString path = workDir.filePath(QString("load_%1.json").arg(rows));
+    if (!QFile::exists(path)) {
+        QVERIFY(JsonStorage::saveToFile(path, dataset(rows)));
+    }
+    BenchTimer timer;
+    QBENCHMARK {
+        bool success;
+        timer.start();
+        QList<Fournisseur> loaded = JsonStorage::loadFromFile(path, success);
+        timer.stop();
+        QVERIFY(success);
+        QCOMPARE(loaded.size(), rows);
+    }
+    record(timer, "JsonStorage::loadFromFile");
+}
+
+// ===== In-memory operations =====
+
+void FournisseurBenchmarks::filterMatches()
+{
+    QFETCH(int, rows);
+    const QList<Fournisseur>& data = dataset(rows);
+
+    FilterCriteria criteria;
+    criteria.nom = "tech";
+    criteria.typeProduits = "Électronique";
+    criteria.activeOnly = true;
+
+    BenchTimer timer;
+    int matched = 0;
+    QBENCHMARK {
+        matched = 0;
+        timer.start();
+        for (const Fournisseur& f : data) {
+            if (criteria.matches(f.getNom(), f.getEmail(), f.getTypeProduits(),
+                                 f.getAdresse(), 0, f.getIsActive())) {
+                ++matched;
+            }
+        }
+        timer.stop();
+    }
+    QVERIFY(matched <= rows);
+    record(timer);
+}
+
+void FournisseurBenchmarks::benchmarkSort(void (*sorter)(QList<Fournisseur>&))
+{
+    QFETCH(int, rows);
+    const QList<Fournisseur>& data = shuffled(rows);
+    BenchTimer timer;
+    QBENCHMARK {
+        QList<Fournisseur> copy = data;
+        copy.detach();
+        timer.start();
+        sorter(copy);
+        timer.stop();
+    }
+    record(timer);
+}
+
+void FournisseurBenchmarks::sortById()
+{
+    benchmarkSort(&SupplierSorter::sortById);
+}
+
+void FournisseurBenchmarks::sortByNom()
+{
+    benchmarkSort(&SupplierSorter::sortByNom);
+}
+
+void FournisseurBenchmarks::sortByTypeProduits()
+{
+    benchmarkSort(&SupplierSorter::sortByTypeProduits);
+}
+
+void FournisseurBenchmarks::sortByRating()
+{
+    QFETCH(int, rows);
+    const QList<Fournisseur>& data = shuffled(rows);
+    const QList<SupplierRating>& rated = ratings(rows);
+    BenchTimer timer;
+    QBENCHMARK {
+        QList<Fournisseur> copy = data;
+        copy.detach();
+        timer.start();
+        SupplierSorter::sortByRating(copy, rated);
+        timer.stop();
+    }
+    record(timer);
+}
+
+void FournisseurBenchmarks::sortByRatingHistory()
+{
+    QFETCH(int, rows);
+    const QList<Fournisseur>& data = shuffled(rows);
+    // Three ratings per rated supplier, 45 days apart
+    RatingHistory history;
+    QDateTime now = QDateTime::currentDateTime();
+    for (const SupplierRating& rating : ratings(rows)) {
+        RatingEvent event = RatingEvent::fromRating(rating);
+        for (int age = 2; age >= 0; --age) {
+            event.ratedDate = now.addDays(-45 * age);
+            history.append(event);
+        }
+    }
+    BenchTimer timer;
+    QBENCHMARK {
+        QList<Fournisseur> copy = data;
+        copy.detach();
+        timer.start();
+        SupplierSorter::sortByRating(copy, history, RatingHistory::Decayed30);
+        timer.stop();
+    }
+    record(timer);
+}
+
+void FournisseurBenchmarks::leaderboardUpdate()
+{
+    QFETCH(int, rows);
+    const QList<Fournisseur>& data = dataset(rows);
+    const QList<SupplierRating>& rated = ratings(rows);
+    QHash<int, quint32> typeOf;
+    for (const Fournisseur& f : data) typeOf.insert(f.getIdFournisseur(), f.getTypeCode());
+    SupplierLeaderboard leaderboard;
+    for (const SupplierRating& rating : rated) {
+        int id = rating.getFournisseurId();
+        leaderboard.update(id, typeOf.value(id), rating.getOverallRating(), QString());
+    }
+
+    // 1000 re-ratings, each followed by a global and a per-type top 10
+    std::mt19937 rng(7);
+    BenchTimer timer;
+    QBENCHMARK {
+        timer.start();
+        for (int i = 0; i < 1000; ++i) {
+            int id = rated[int(rng() % rated.size())].getFournisseurId();
+            leaderboard.update(id, typeOf.value(id), 1.0 + (rng() % 17) / 4.0, QString());
+            QVERIFY(leaderboard.top(10).size() == qMin(10, leaderboard.count()));
+            leaderboard.top(10, typeOf.value(id));
+        }
+        timer.stop();
+    }
+    record(timer);
+}
+
+void FournisseurBenchmarks::calculateStats()
+{
+    QFETCH(int, rows);
+    const QList<Fournisseur>& data = dataset(rows);
+    const QList<SupplierRating>& rated = ratings(rows);
+    DatasetGenerator generator(7);
+    QList<ActivityLog> activities = generator.generateActivities(rows / 10, rows);
+
+    BenchTimer timer;
+    QBENCHMARK {
+        timer.start();
+        AdvancedStats::Stats stats = AdvancedStats::calculateStats(data, rated, activities);
+        timer.stop();
+        QCOMPARE(stats.totalSuppliers, rows);
+    }
+    record(timer);
+}
+
+// Build time of the compact table; its footprint is reported next to the QList estimate
+void FournisseurBenchmarks::compactStorage()
+{
+    QFETCH(int, rows);
+    const QList<Fournisseur>& data = dataset(rows);
+    qint64 compactBytes = 0;
+
+    BenchTimer timer;
+    QBENCHMARK {
+        timer.start();
+        CompactSupplierTable table;
+        table.reserve(data.size());
+        for (const Fournisseur& f : data) table.append(f);
+        timer.stop();
+        QCOMPARE(table.size(), rows);
+        QCOMPARE(table.at(rows / 2), data.at(rows / 2));
+        compactBytes = table.memoryUsage();
+    }
+    record(timer);
+
+    qint64 listBytes = MemoryAccounting::estimate(data);
+    QJsonObject entry = results.last().toObject();
+    entry["compactBytes"] = double(compactBytes);
+    entry["listBytes"] = double(listBytes);
+    entry["compactRatio"] = listBytes > 0 ? double(compactBytes) / listBytes : 0.0;
+    results.replace(results.size() - 1, entry);
+}
+
+// Name, type and city indexes as the GUI builds them, then one lookup per letter
+void FournisseurBenchmarks::prefixIndex()
+{
+    QFETCH(int, rows);
+    const QList<Fournisseur>& data = dataset(rows);
+    QStringList noms, types, cities;
+    QSet<QString> distinct;
+    qint64 rawBytes = 0;
+    for (const Fournisseur& f : data) {
+        noms << f.getNom();
+        types << f.getTypeProduits();
+        cities << PrefixIndex::cityOf(f.getAdresse());
+    }
+    for (const QStringList* values : {&noms, &types, &cities}) {
+        for (const QString& value : *values) {
+            rawBytes += value.size() * qint64(sizeof(QChar));
+            distinct.insert(value);
+        }
+    }
+    qint64 distinctBytes = 0;
+    for (const QString& value : std::as_const(distinct)) {
+        distinctBytes += value.toUtf8().size();
+    }
+
+    qint64 indexBytes = 0;
+    BenchTimer timer;
+    QBENCHMARK {
+        timer.start();
+        PrefixIndex nomIndex, typeIndex, cityIndex;
+        nomIndex.build(noms);
+        typeIndex.build(types);
+        cityIndex.build(cities);
+        int found = 0;
+        for (char c = 'a'; c <= 'z'; ++c) {
+            found += nomIndex.complete(QString(QChar(c))).size();
+        }
+        timer.stop();
+        QVERIFY(found > 0);
+        indexBytes = nomIndex.memoryUsage() + typeIndex.memoryUsage() + cityIndex.memoryUsage();
+    }
+    record(timer);
+
+    // The index must stay smaller than the QStrings it replaces
+    QVERIFY(indexBytes < rawBytes);
+    QJsonObject entry = results.last().toObject();
+    entry["indexBytes"] = double(indexBytes);
+    entry["rawBytes"] = double(rawBytes);
+    entry["distinctUtf8Bytes"] = double(distinctBytes);
+    entry["indexRatio"] = rawBytes > 0 ? double(indexBytes) / rawBytes : 0.0;
+    results.replace(results.size() - 1, entry);
+}
+
+// 'rows' delivery events over rows / 100 suppliers; one 90-day window per supplier
+void FournisseurBenchmarks::deliveryWindow()
+{
+    QFETCH(int, rows);
+    int suppliers = qMax(1, rows / 100);
+    DatasetGenerator generator(11);
+    DeliveryEventStore store;
+    QCOMPARE(store.appendAll(generator.generateDeliveries(suppliers, rows / suppliers)),
+             suppliers * (rows / suppliers));
+
+    QDate to = QDate::currentDate();
+    QDate from = to.addDays(-90);
+    BenchTimer timer;
+    QBENCHMARK {
+        timer.start();
+        DeliveryMetrics window = store.metricsAll(from, to);
+        timer.stop();
+        QVERIFY(window.orders > 0);
+    }
+    record(timer);
+}
+
+void FournisseurBenchmarks::leadTimePercentiles()
+{
+    QFETCH(int, rows);
+    int suppliers = qMax(1, rows / 100);
+    DatasetGenerator generator(11);
+    DeliveryEventStore store;
+    store.appendAll(generator.generateDeliveries(suppliers, rows / suppliers));
+    QHash<int, quint32> groupOf;
+    for (int id : store.suppliers()) groupOf.insert(id, quint32(id % 8));
+
+    BenchTimer timer;
+    QBENCHMARK {
+        timer.start();
+        QHash<quint32, TDigest> digests = store.leadTimesByGroup(groupOf);
+        const TDigest& all = digests[DeliveryEventStore::AllGroups];
+        double p99 = all.quantile(0.99);
+        timer.stop();
+        QVERIFY(p99 >= all.quantile(0.5));
+    }
+    record(timer);
+}
+
+// Every spelling of a number has to land on one key, or the index misses duplicates
+void FournisseurBenchmarks::contactIndexBuild()
+{
+    QFETCH(int, rows);
+    const QList<Fournisseur>& data = dataset(rows);
+    const qint64 key = ContactIndex::normalizePhone("+216 98 765 432");
+    QCOMPARE(ContactIndex::normalizePhone("98 765 432"), key);
+    QCOMPARE(ContactIndex::normalizePhone("0021698765432"), key);
+    QCOMPARE(ContactIndex::normalizePhone("21698765432"), key);
+    QCOMPARE(ContactIndex::normalizePhone("+33 1 23 45 67 89"),
+             ContactIndex::normalizePhone("0033123456789"));
+
+    BenchTimer timer;
+    QBENCHMARK {
+        ContactIndex index;
+        timer.start();
+        index.build(data);
+        timer.stop();
+        QCOMPARE(index.findConflict(data.at(rows / 2)), ContactIndex::None);
+    }
+    record(timer);
+}
+
+// ===== Database CRUD =====
+
+void FournisseurBenchmarks::crudBulkInsert(DatabaseManager::DatabaseType type)
+{
+    QFETCH(int, rows);
+    BenchTimer timer;
+    QBENCHMARK_ONCE {
+        dbRows = -1; // force a fresh database
+        QVERIFY(ensureDatabase(rows, type, &timer));
+    }
+    record(timer);
+}
+
+void FournisseurBenchmarks::crudGetAll(DatabaseManager::DatabaseType type)
+{
+    QFETCH(int, rows);
+    QVERIFY(ensureDatabase(rows, type));
+    BenchTimer timer;
+    QBENCHMARK {
+        bool success;
+        timer.start();
+        QList<Fournisseur> all = db->getAllFournisseurs(success);
+        timer.stop();
+        QVERIFY(success);
+        QCOMPARE(all.size(), rows);
+    }
+    record(timer);
+}
+
+void FournisseurBenchmarks::crudSearch(DatabaseManager::DatabaseType type)
+{
+    QFETCH(int, rows);
+    QVERIFY(ensureDatabase(rows, type));
+    BenchTimer timer;
+    QBENCHMARK {
+        bool success;
+        timer.start();
+        QList<Fournisseur> found = db->searchFournisseurs("TechSupply", success);
+        timer.stop();
+        QVERIFY(success);
+    }
+    record(timer);
+}
+
+void FournisseurBenchmarks::crudGetById(DatabaseManager::DatabaseType type)
+{
+    QFETCH(int, rows);
+    QVERIFY(ensureDatabase(rows, type));
+    BenchTimer timer;
+    int id = 1;
+    QBENCHMARK {
+        bool success;
+        timer.start();
+        db->getFournisseurById(id, success);
+        timer.stop();
+        QVERIFY(success);
+        id = id % rows + 1;
+    }
+    record(timer);
+}
+
+void FournisseurBenchmarks::crudUpdate(DatabaseManager::DatabaseType type)
+{
+    QFETCH(int, rows);
+    QVERIFY(ensureDatabase(rows, type));
+    const QList<Fournisseur>& data = dataset(rows);
+    BenchTimer timer;
+    int i = 0;
+    QBENCHMARK {
+        Fournisseur f = data[i];
+        f.setHistoriqueLivraisons(QString("%1 livraisons - mise à jour").arg(i));
+        timer.start();
+        QVERIFY(db->updateFournisseur(f));
+        timer.stop();
+        i = (i + 1) % rows;
+    }
+    record(timer);
+}
+
+void FournisseurBenchmarks::crudDelete(DatabaseManager::DatabaseType type)
+{
+    QFETCH(int, rows);
+    QVERIFY(ensureDatabase(rows, type));
+    BenchTimer timer;
+    int id = rows;
+    QBENCHMARK {
+        timer.start();
+        QVERIFY(db->deleteFournisseur(id));
+        timer.stop();
+        if (--id < 1) id = rows;
+    }
+    record(timer);
+    dbRows = -1; // rows were removed; the next test rebuilds the database
+}
+
+// ===== Recorded workload =====
+
+void FournisseurBenchmarks::replayWorkload_data()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::newRow("json") << "json";
+    QTest::newRow("sqlite") << "sqlite";
+    QTest::newRow("memory") << "memory";
+}
+
+void FournisseurBenchmarks::replayWorkload()
+{
+    QFETCH(QString, backend);
+    QString capture = qEnvironmentVariable("FOURNISSEUR_BENCH_WORKLOAD");
+    if (capture.isEmpty()) {
+        QSKIP("FOURNISSEUR_BENCH_WORKLOAD not set");
+    }
+
+    WorkloadReplayer replayer;
+    QVERIFY2(replayer.load(capture), qPrintable(replayer.getLastError()));
+    replayer.setSpeed(0);
+    replayer.setClients(4);
+    replayer.setSeed(true);
+
+    WorkloadReplayer::BackendFactory factory;
+    if (backend == "json") {
+        auto store = std::make_shared<JsonWorkloadBackend::Store>();
+        store->fileName = workDir.filePath("replay.json");
+        factory = [store](int) {
+            return std::unique_ptr<WorkloadBackend>(new JsonWorkloadBackend(store));
+        };
+    } else {
+        // Clients of the in-memory backend share one engine through its journal
+        bool memory = backend == "memory";
+        QString dbFile = workDir.filePath(memory ? "replay.journal" : "replay.db");
+        factory = [dbFile, memory](int client) -> std::unique_ptr<WorkloadBackend> {
+            DatabaseManager *manager = new DatabaseManager(memory ? DatabaseManager::InMemory
+                                                                  : DatabaseManager::SQLite,
+                                                           QString("replay_%1").arg(client));
+            if (!manager->connectToDatabase(dbFile)) {
+                delete manager;
+                return nullptr;
+            }
+            return std::unique_ptr<WorkloadBackend>(new DatabaseWorkloadBackend(manager));
+        };
+    }
+
+    WorkloadReplayer::Report report;
+    QBENCHMARK_ONCE {
+        report = replayer.run(factory);
+    }
+    QCOMPARE(report.operations, qint64(replayer.operationCount()));
+    qDebug().noquote() << report.toText();
+
+    QJsonObject entry = report.toJson();
+    entry["benchmark"] = QString(QTest::currentTestFunction());
+    entry["dataset"] = QString(QTest::currentDataTag());
+    entry["rows"] = replayer.getSnapshot().size();
+    results.append(entry);
+}
+
+QTEST_GUILESS_MAIN(FournisseurBenchmarks)
+
+#include "benchmarks.moc"
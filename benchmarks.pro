@@ -0,0 +1,56 @@
+QT += core sql testlib concurrent
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+tracing: DEFINES += FOURNISSEUR_TRACING
+memtrack: DEFINES += FOURNISSEUR_MEMTRACK
+
+TARGET = benchmarks
+
+SOURCES += \
+    benchmarks.cpp \
+    datasetgenerator.cpp \
+    fournisseur.cpp \
+    coldtext.cpp \
+    tdigest.cpp \
+    ratinghistory.cpp \
+    advancedfeatures.cpp \
+    databasemanager.cpp \
+    memoryengine.cpp \
+    contactindex.cpp \
+    tracing.cpp \
+    querymetrics.cpp \
+    memorytracker.cpp \
+    livesearch.cpp \
+    workload.cpp \
+    prefixindex.cpp \
+    compactstorage.cpp \
+    deliverystore.cpp \
+    leaderboard.cpp
+
+HEADERS += \
+    datasetgenerator.h \
+    fournisseur.h \
+    coldtext.h \
+    tdigest.h \
+    ratinghistory.h \
+    advancedfeatures.h \
+    databasemanager.h \
+    memoryengine.h \
+    contactindex.h \
+    tracing.h \
+    querymetrics.h \
+    memorytracker.h \
+    livesearch.h \
+    workload.h \
+    prefixindex.h \
+    compactstorage.h \
+    deliverystore.h \
+    leaderboard.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,54 @@
+QT += core sql concurrent
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+tracing: DEFINES += FOURNISSEUR_TRACING
+memtrack: DEFINES += FOURNISSEUR_MEMTRACK
+
+TARGET = fournisseur-cli
+
+SOURCES += \
+    cli_main.cpp \
+    fournisseur.cpp \
+    coldtext.cpp \
+    tdigest.cpp \
+    ratinghistory.cpp \
+    advancedfeatures.cpp \
+    databasemanager.cpp \
+    memoryengine.cpp \
+    compactstorage.cpp \
+    prefixindex.cpp \
+    contactindex.cpp \
+    tracing.cpp \
+    querymetrics.cpp \
+    memorytracker.cpp \
+    livesearch.cpp \
+    workload.cpp \
+    jobscheduler.cpp \
+    exportpipeline.cpp
+
+HEADERS += \
+    fournisseur.h \
+    coldtext.h \
+    tdigest.h \
+    ratinghistory.h \
+    advancedfeatures.h \
+    databasemanager.h \
+    memoryengine.h \
+    compactstorage.h \
+    prefixindex.h \
+    contactindex.h \
+    tracing.h \
+    querymetrics.h \
+    memorytracker.h \
+    livesearch.h \
+    workload.h \
+    jobscheduler.h \
+    exportpipeline.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
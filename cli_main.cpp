@@ -0,0 +1,698 @@
+/**
+ * FOURNISSEUR-CLI - headless batch tool
+ *
+ * qmake cli.pro && make && ./fournisseur-cli <commande> [options]
+ *
+ *   import  <fichier.csv|.json>   rows are streamed into the store in batches
+ *   export  <fichier.csv|.json>…  rows are streamed out of the store; several
+ *                                 outputs are written from one scan, in parallel
+ *   stats                         AdvancedStats over a streamed store
+ *   backup                        timestamped JSON copy in backups/, rotated
+ *   migrate --from SPEC --to SPEC copy every row between two databases
+ *   replay  <capture.jsonl>       re-issue a recorded workload (see workload.h)
+ *
+ * A store is either a database (--db SPEC) or a JSON file (--json FILE).
+ * SPEC is a SQLite file ("fournisseurs.db", "sqlite:/path/x.db"), an
+ * Oracle URL ("oracle://system@localhost:1521/XE") or the embedded engine
+ * with its journal ("memory:fournisseurs.journal", "memory:" keeps nothing);
+ * the Oracle password comes from --password or FOURNISSEUR_DB_PASSWORD.
+ *
+ * Progress goes to stderr, results to stdout. Exit codes: 0 ok, 1 failure,
+ * 2 usage error.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QUrl>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <memory>
+
+#include "fournisseur.h"
+#include "advancedfeatures.h"
+#include "databasemanager.h"
+#include "memoryengine.h"
+#include "workload.h"
+#include "exportpipeline.h"
+
+namespace {
+
+QTextStream& out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream& err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// ===== Progress reporting =====
+class Progress
+{
+private:
+    QString label;
+    qint64 total;
+    qint64 count;
+    bool quiet;
+    QElapsedTimer timer;
+    qint64 lastPrintMs;
+
+public:
+    Progress(const QString& label, qint64 total, bool quiet)
+        : label(label), total(total), count(0), quiet(quiet), lastPrintMs(-1000)
+    {
+        timer.start();
+    }
+
+    qint64 getCount() const { return count; }
+
+    // 'fraction' overrides count/total when the total is unknown (byte-based progress)
+    void advance(qint64 rows = 1, double fraction = -1.0)
+    {
+        count += rows;
+        qint64 now = timer.elapsed();
+        if (quiet || now - lastPrintMs < 250) return;
+        lastPrintMs = now;
+
+        if (fraction < 0.0 && total > 0) fraction = double(count) / total;
+        QString line = QString("\r%1: %2 lignes").arg(label).arg(count);
+        if (fraction >= 0.0) line += QString(" (%1%)").arg(int(fraction * 100));
+        line += QString(" - %1 lignes/s   ").arg(rate(), 0, 'f', 0);
+        err() << line << Qt::flush;
+    }
+
+    void finish()
+    {
+        if (quiet) return;
+        err() << QString("\r%1: %2 lignes en %3 s (%4 lignes/s)          \n")
+                 .arg(label).arg(count)
+                 .arg(timer.elapsed() / 1000.0, 0, 'f', 2)
+                 .arg(rate(), 0, 'f', 0)
+              << Qt::flush;
+    }
+
+private:
+    double rate() const
+    {
+        qint64 ms = timer.elapsed();
+        return ms > 0 ? count * 1000.0 / ms : 0.0;
+    }
+};
+
+// ===== Database specs =====
+// Quiet variant, safe to call from replay client threads
+std::unique_ptr<DatabaseManager> connectDatabase(const QString& spec, const QString& password,
+                                                 const QString& connectionName, QString& error)
+{
+    std::unique_ptr<DatabaseManager> db;
+
+    if (spec.startsWith("oracle://")) {
+        QUrl url(spec);
+        QString sid = url.path().mid(1);
+        db.reset(new DatabaseManager(DatabaseManager::Oracle, connectionName));
+        QString pass = !password.isEmpty() ? password
+                                           : qEnvironmentVariable("FOURNISSEUR_DB_PASSWORD");
+        if (!db->connectToOracle(url.host(), url.port(1521), sid.isEmpty() ? "XE" : sid,
+                                 url.userName().isEmpty() ? "system" : url.userName(), pass)) {
+            error = QString("Connexion Oracle impossible: %1").arg(db->getLastError());
+            return nullptr;
+        }
+    } else if (spec.startsWith("memory:")) {
+        QString journal = spec.mid(7);
+        db.reset(new DatabaseManager(DatabaseManager::InMemory, connectionName));
+        if (!db->connectToDatabase(journal.isEmpty() ? MemoryEngine::Volatile : journal)) {
+            error = QString("Ouverture du journal %1 impossible: %2").arg(journal, db->getLastError());
+            return nullptr;
+        }
+    } else {
+        QString file = spec.startsWith("sqlite:") ? spec.mid(7) : spec;
+        db.reset(new DatabaseManager(DatabaseManager::SQLite, connectionName));
+        if (!db->connectToDatabase(file)) {
+            error = QString("Ouverture de %1 impossible: %2").arg(file, db->getLastError());
+            return nullptr;
+        }
+    }
+    return db;
+}
+
+std::unique_ptr<DatabaseManager> openDatabase(const QString& spec, const QString& password,
+                                              const QString& connectionName)
+{
+    QString error;
+    std::unique_ptr<DatabaseManager> db = connectDatabase(spec, password, connectionName, error);
+    if (!db) {
+        err() << "❌ " << error << "\n";
+        return nullptr;
+    }
+
+    // Oracle has no CREATE TABLE IF NOT EXISTS: an existing table is reported, not fatal
+    if (!db->createTables()) {
+        err() << "⚠️ " << db->getLastError() << "\n";
+    }
+    return db;
+}
+
+bool isJsonFile(const QString& fileName)
+{
+    return fileName.endsWith(".json", Qt::CaseInsensitive);
+}
+
+template <typename T>
+QList<T> loadJsonList(const QString& fileName)
+{
+    QList<T> items;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return items;
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    for (const QJsonValue& value : doc.array()) {
+        items.append(T::fromJson(value.toObject()));
+    }
+    return items;
+}
+
+struct Options
+{
+    QString dbSpec;
+    QString jsonFile;
+    QString password;
+    int batchSize;
+    bool keepIds;
+    bool skipErrors;
+    bool quiet;
+};
+
+// ===== Batched inserts =====
+class BatchInserter
+{
+private:
+    DatabaseManager& db;
+    const Options& options;
+    bool preserveIds;
+    QList<Fournisseur> batch;
+    qint64 rejected;
+    bool failed;
+
+public:
+    BatchInserter(DatabaseManager& db, const Options& options, bool preserveIds)
+        : db(db), options(options), preserveIds(preserveIds), rejected(0), failed(false)
+    {
+        batch.reserve(options.batchSize);
+    }
+
+    qint64 getRejected() const { return rejected; }
+
+    bool add(const Fournisseur& f)
+    {
+        batch.append(f);
+        return batch.size() < options.batchSize || flush();
+    }
+
+    bool flush()
+    {
+        if (failed || batch.isEmpty()) return !failed;
+
+        if (!db.insertBatch(batch, preserveIds)) {
+            if (!options.skipErrors) {
+                err() << "\n❌ Lot rejeté: " << db.getLastError() << "\n";
+                failed = true;
+                return false;
+            }
+            // Retry row by row so one bad row (duplicate contact, ...) does not sink the batch
+            for (const Fournisseur& f : batch) {
+                if (!db.insertFournisseur(f, preserveIds)) {
+                    err() << "\n⚠️ Ligne " << f.getIdFournisseur() << " ignorée: "
+                          << db.getLastError() << "\n";
+                    ++rejected;
+                }
+            }
+        }
+        batch.clear();
+        return true;
+    }
+};
+
+// ===== Commands =====
+int runImport(const QString& input, const Options& options)
+{
+    if (!options.jsonFile.isEmpty()) {
+        // JSON store: not streamable, load / append / save
+        bool ok = true;
+        QList<Fournisseur> store = QFile::exists(options.jsonFile)
+            ? JsonStorage::loadFromFile(options.jsonFile, ok) : QList<Fournisseur>();
+        if (!ok) {
+            err() << "❌ Lecture de " << options.jsonFile << " impossible\n";
+            return 1;
+        }
+        QList<Fournisseur> incoming = isJsonFile(input) ? JsonStorage::loadFromFile(input, ok)
+                                                        : CSVManager::importFromCSV(input, ok);
+        if (!ok) {
+            err() << "❌ Lecture de " << input << " impossible\n";
+            return 1;
+        }
+
+        int nextId = 1;
+        for (const Fournisseur& f : store) nextId = qMax(nextId, f.getIdFournisseur() + 1);
+        for (Fournisseur f : incoming) {
+            if (!options.keepIds) f.setIdFournisseur(nextId++);
+            store.append(f);
+        }
+        if (!JsonStorage::saveToFile(options.jsonFile, store)) {
+            err() << "❌ Écriture de " << options.jsonFile << " impossible\n";
+            return 1;
+        }
+        out() << incoming.size() << " fournisseurs importés dans " << options.jsonFile << "\n";
+        return 0;
+    }
+
+    std::unique_ptr<DatabaseManager> db = openDatabase(options.dbSpec, options.password, QString());
+    if (!db) return 1;
+
+    BatchInserter inserter(*db, options, options.keepIds);
+    Progress progress("Import", 0, options.quiet);
+
+    if (isJsonFile(input)) {
+        bool ok;
+        QList<Fournisseur> incoming = JsonStorage::loadFromFile(input, ok);
+        if (!ok) {
+            err() << "❌ Lecture de " << input << " impossible\n";
+            return 1;
+        }
+        for (int i = 0; i < incoming.size(); ++i) {
+            if (!inserter.add(incoming[i])) return 1;
+            progress.advance(1, double(i + 1) / incoming.size());
+        }
+    } else {
+        CSVReader reader;
+        if (!reader.open(input)) {
+            err() << "❌ Lecture de " << input << " impossible\n";
+            return 1;
+        }
+        Fournisseur f;
+        while (reader.next(f)) {
+            if (!inserter.add(f)) return 1;
+            progress.advance(1, reader.progress());
+        }
+        reader.close();
+    }
+
+    if (!inserter.flush()) return 1;
+    progress.finish();
+    out() << progress.getCount() - inserter.getRejected() << " fournisseurs importés";
+    if (inserter.getRejected() > 0) out() << ", " << inserter.getRejected() << " rejetés";
+    out() << "\n";
+    return 0;
+}
+
+int runExport(const QStringList& outputs, const Options& options)
+{
+    // Every output is fed by the same single scan of the store
+    ExportPipeline pipeline;
+    for (const QString& output : outputs) {
+        std::unique_ptr<ExportSink> sink = ExportPipeline::sinkForFile(output);
+        if (!sink) {
+            err() << "❌ Format non pris en charge: " << output << " (.csv ou .json)\n";
+            return 2;
+        }
+        pipeline.addSink(std::move(sink));
+    }
+
+    std::unique_ptr<DatabaseManager> db;
+    QList<Fournisseur> store;
+    qint64 total = 0;
+    if (!options.jsonFile.isEmpty()) {
+        bool ok;
+        store = JsonStorage::loadFromFile(options.jsonFile, ok);
+        if (!ok) {
+            err() << "❌ Lecture de " << options.jsonFile << " impossible\n";
+            return 1;
+        }
+        total = store.size();
+    } else {
+        db = openDatabase(options.dbSpec, options.password, QString());
+        if (!db) return 1;
+        total = db->getTotalCount();
+    }
+
+    Progress progress("Export", total, options.quiet);
+    bool ok = pipeline.run([&](const ExportPipeline::Visitor& visit) {
+        auto counted = [&](const Fournisseur& f) {
+            progress.advance();
+            return visit(f);
+        };
+        if (db) return db->forEachFournisseur(counted);
+        for (const Fournisseur& f : store) {
+            if (!counted(f)) break;
+        }
+        return true;
+    });
+
+    if (!ok) {
+        err() << "\n❌ Export interrompu " << pipeline.getLastError() << "\n";
+        if (db && !db->getLastError().isEmpty()) err() << "   " << db->getLastError() << "\n";
+    } else {
+        progress.finish();
+    }
+    for (const ExportPipeline::SinkReport& report : pipeline.reports()) {
+        out() << (report.ok ? "" : "❌ ") << report.rows << " fournisseurs exportés vers "
+              << report.name << QString(" (%1 s)").arg(report.seconds, 0, 'f', 2)
+              << (report.ok ? QString() : " - " + report.error) << "\n";
+    }
+    return ok ? 0 : 1;
+}
+
+int runStats(const Options& options, const QString& ratingsFile, const QString& historyFile,
+             const QString& activitiesFile, bool asJson)
+{
+    // The full rating history when there is one, else the latest rating of each supplier
+    RatingHistory history;
+    bool withHistory = QFile::exists(historyFile) && history.loadFromFile(historyFile);
+    AdvancedStats::Accumulator accumulator = withHistory
+        ? AdvancedStats::Accumulator(history, loadJsonList<ActivityLog>(activitiesFile))
+        : AdvancedStats::Accumulator(loadJsonList<SupplierRating>(ratingsFile),
+                                     loadJsonList<ActivityLog>(activitiesFile));
+
+    if (!options.jsonFile.isEmpty()) {
+        bool ok;
+        QList<Fournisseur> store = JsonStorage::loadFromFile(options.jsonFile, ok);
+        if (!ok) {
+            err() << "❌ Lecture de " << options.jsonFile << " impossible\n";
+            return 1;
+        }
+        for (const Fournisseur& f : store) accumulator.add(f);
+    } else {
+        std::unique_ptr<DatabaseManager> db = openDatabase(options.dbSpec, options.password, QString());
+        if (!db) return 1;
+
+        Progress progress("Statistiques", db->getTotalCount(), options.quiet);
+        bool ok = db->forEachFournisseur([&](const Fournisseur& f) {
+            accumulator.add(f);
+            progress.advance();
+            return true;
+        });
+        if (!ok) {
+            err() << "❌ " << db->getLastError() << "\n";
+            return 1;
+        }
+        progress.finish();
+    }
+
+    AdvancedStats::Stats stats = accumulator.result();
+
+    if (asJson) {
+        QJsonObject types;
+        for (auto it = stats.productTypeDistribution.constBegin();
+             it != stats.productTypeDistribution.constEnd(); ++it) {
+            types[it.key()] = it.value();
+        }
+        QJsonObject ratings;
+        for (auto it = stats.ratingDistribution.constBegin();
+             it != stats.ratingDistribution.constEnd(); ++it) {
+            ratings[QString::number(it.key())] = it.value();
+        }
+        QJsonObject json;
+        json["totalSuppliers"] = stats.totalSuppliers;
+        json["activeSuppliers"] = stats.activeSuppliers;
+        json["inactiveSuppliers"] = stats.inactiveSuppliers;
+        json["averageRating"] = stats.averageRating;
+        json["ratingMedian"] = stats.ratingMedian;
+        json["ratingP90"] = stats.ratingP90;
+        json["averageRating30"] = stats.averageRating30;
+        json["averageRating90"] = stats.averageRating90;
+        json["topRatedSupplier"] = stats.topRatedSupplier;
+        json["mostCommonProductType"] = stats.mostCommonProductType;
+        json["totalActivities"] = stats.totalActivities;
+        json["productTypeDistribution"] = types;
+        json["ratingDistribution"] = ratings;
+        out() << QJsonDocument(json).toJson();
+        return 0;
+    }
+
+    out() << "📈 STATISTIQUES\n\n";
+    out() << "Total fournisseurs:   " << stats.totalSuppliers << "\n";
+    out() << "Actifs / inactifs:    " << stats.activeSuppliers << " / " << stats.inactiveSuppliers << "\n";
+    out() << "Note moyenne:         " << QString::number(stats.averageRating, 'f', 2) << " / 5\n";
+    out() << "Note médiane / p90:   " << QString::number(stats.ratingMedian, 'f', 2) << " / "
+          << QString::number(stats.ratingP90, 'f', 2) << "\n";
+    out() << "Note récente 30/90 j: " << QString::number(stats.averageRating30, 'f', 2) << " / "
+          << QString::number(stats.averageRating90, 'f', 2) << "\n";
+    out() << "Mieux noté:           " << stats.topRatedSupplier << "\n";
+    out() << "Type le plus courant: " << stats.mostCommonProductType << "\n";
+    out() << "Activités:            " << stats.totalActivities << "\n\n";
+    out() << "Répartition par type:\n";
+    for (auto it = stats.productTypeDistribution.constBegin();
+         it != stats.productTypeDistribution.constEnd(); ++it) {
+        out() << "  " << it.key() << ": " << it.value() << "\n";
+    }
+    return 0;
+}
+
+int runBackup(const Options& options, int keep, const QString& backupDir)
+{
+    if (!options.jsonFile.isEmpty()) {
+        if (!BackupManager::autoBackup(options.jsonFile, keep)) {
+            err() << "❌ Sauvegarde de " << options.jsonFile << " impossible\n";
+            return 1;
+        }
+        out() << "💾 Sauvegarde créée (" << keep << " conservées)\n";
+        return 0;
+    }
+
+    std::unique_ptr<DatabaseManager> db = openDatabase(options.dbSpec, options.password, QString());
+    if (!db) return 1;
+
+    QDir().mkpath(backupDir);
+    QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
+    QString backupPath = QString("%1/fournisseurs_backup_%2.json").arg(backupDir, timestamp);
+
+    JsonArrayWriter writer;
+    if (!writer.open(backupPath)) {
+        err() << "❌ Écriture de " << backupPath << " impossible\n";
+        return 1;
+    }
+    Progress progress("Sauvegarde", db->getTotalCount(), options.quiet);
+    bool ok = db->forEachFournisseur([&](const Fournisseur& f) {
+        writer.write(f);
+        progress.advance();
+        return true;
+    });
+    if (!writer.close() || !ok) {
+        err() << "\n❌ Sauvegarde interrompue: " << db->getLastError() << "\n";
+        QFile::remove(backupPath);
+        return 1;
+    }
+    progress.finish();
+
+    BackupManager::pruneBackups(keep, backupDir);
+    out() << "💾 " << backupPath << " (" << progress.getCount() << " fournisseurs)\n";
+    return 0;
+}
+
+int runMigrate(const QString& from, const QString& to, const Options& options)
+{
+    std::unique_ptr<DatabaseManager> source = openDatabase(from, options.password, "migrate_source");
+    if (!source) return 1;
+    std::unique_ptr<DatabaseManager> target = openDatabase(to, options.password, "migrate_target");
+    if (!target) return 1;
+
+    // Ids are kept: Oracle has no identity on ID_FOURNISSEUR and references must survive
+    BatchInserter inserter(*target, options, true);
+    Progress progress("Migration", source->getTotalCount(), options.quiet);
+    bool inserted = true;
+    bool ok = source->forEachFournisseur([&](const Fournisseur& f) {
+        inserted = inserter.add(f);
+        progress.advance();
+        return inserted;
+    });
+
+    if (!ok) {
+        err() << "\n❌ Lecture de la source impossible: " << source->getLastError() << "\n";
+        return 1;
+    }
+    if (!inserted || !inserter.flush()) return 1;
+
+    progress.finish();
+    out() << "🔁 " << progress.getCount() - inserter.getRejected() << " fournisseurs migrés de "
+          << source->getDatabaseType() << " vers " << target->getDatabaseType() << "\n";
+    return inserter.getRejected() > 0 ? 1 : 0;
+}
+
+int runReplay(const QString& captureFile, const Options& options, double speed,
+              int clients, bool seed, bool asJson)
+{
+    WorkloadReplayer replayer;
+    if (!replayer.load(captureFile)) {
+        err() << "❌ " << replayer.getLastError() << "\n";
+        return 1;
+    }
+    if (seed && !replayer.hasSnapshot()) {
+        err() << "⚠️ Pas d'instantané dans la capture: --seed ignoré\n";
+    }
+    replayer.setSpeed(speed);
+    replayer.setClients(clients);
+    replayer.setSeed(seed);
+
+    WorkloadReplayer::BackendFactory factory;
+    if (!options.jsonFile.isEmpty()) {
+        auto store = std::make_shared<JsonWorkloadBackend::Store>();
+        store->fileName = options.jsonFile;
+        if (!seed && QFile::exists(options.jsonFile)) {
+            bool ok;
+            store->fournisseurs = JsonStorage::loadFromFile(options.jsonFile, ok);
+        }
+        factory = [store](int) {
+            return std::unique_ptr<WorkloadBackend>(new JsonWorkloadBackend(store));
+        };
+    } else if (options.dbSpec == "memory:") {
+        // No journal to share through: one engine, held here, that every client joins
+        auto holder = std::make_shared<DatabaseManager>(DatabaseManager::InMemory, "replay_memory");
+        if (!holder->connectToDatabase(MemoryEngine::Volatile)) {
+            err() << "❌ " << holder->getLastError() << "\n";
+            return 1;
+        }
+        factory = [holder](int client) -> std::unique_ptr<WorkloadBackend> {
+            DatabaseManager *db = new DatabaseManager(DatabaseManager::InMemory,
+                                                      QString("replay_%1").arg(client));
+            if (!db->connectLike(holder->getConnectionName())) {
+                delete db;
+                return nullptr;
+            }
+            return std::unique_ptr<WorkloadBackend>(new DatabaseWorkloadBackend(db));
+        };
+    } else {
+        QString spec = options.dbSpec;
+        QString password = options.password;
+        factory = [spec, password](int client) -> std::unique_ptr<WorkloadBackend> {
+            QString error;
+            std::unique_ptr<DatabaseManager> db =
+                connectDatabase(spec, password, QString("replay_%1").arg(client), error);
+            if (!db) return nullptr;
+            return std::unique_ptr<WorkloadBackend>(new DatabaseWorkloadBackend(db.release()));
+        };
+    }
+
+    if (!options.quiet) {
+        err() << "🎬 Rejeu de " << replayer.operationCount() << " opérations, "
+              << clients << " clients, vitesse "
+              << (speed > 0 ? QString("x%1").arg(speed) : QString("max")) << "\n" << Qt::flush;
+    }
+    WorkloadReplayer::Report report = replayer.run(factory);
+
+    if (asJson) {
+        out() << QJsonDocument(report.toJson()).toJson();
+    } else {
+        out() << report.toText();
+    }
+    return report.errors > 0 || report.operations < replayer.operationCount() ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("fournisseur-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Gestion des fournisseurs en ligne de commande "
+                                     "(import, export, stats, backup, migrate, replay)");
+    parser.addHelpOption();
+    parser.addPositionalArgument("commande", "import | export | stats | backup | migrate | replay");
+    parser.addPositionalArgument("fichier", "Fichier CSV ou JSON (import / export), capture (replay)",
+                                 "[fichier]");
+
+    QCommandLineOption dbOption("db", "Base de données: fichier SQLite, oracle://user@hôte:port/SID "
+                                      "ou memory:journal.",
+                                "spec", "fournisseurs.db");
+    QCommandLineOption jsonOption("json", "Utiliser un fichier JSON comme stockage.", "fichier");
+    QCommandLineOption passwordOption("password", "Mot de passe Oracle (sinon FOURNISSEUR_DB_PASSWORD).",
+                                      "motdepasse");
+    QCommandLineOption batchOption("batch", "Lignes par transaction.", "n", "1000");
+    QCommandLineOption keepIdsOption("keep-ids", "Import: conserver les identifiants du fichier.");
+    QCommandLineOption skipErrorsOption("skip-errors", "Ignorer les lignes rejetées au lieu d'arrêter.");
+    QCommandLineOption quietOption(QStringList() << "q" << "quiet", "Pas de progression.");
+    QCommandLineOption fromOption("from", "Migrate: base source.", "spec");
+    QCommandLineOption toOption("to", "Migrate: base cible.", "spec");
+    QCommandLineOption ratingsOption("ratings", "Stats: fichier des notes.", "fichier",
+                                     "supplier_ratings.json");
+    QCommandLineOption historyOption("history", "Stats: historique des notes (prioritaire sur --ratings).",
+                                     "fichier", "rating_history.json");
+    QCommandLineOption activitiesOption("activities", "Stats: historique d'activités.", "fichier",
+                                        "activity_log.json");
+    QCommandLineOption formatOption("format", "Stats / replay: text ou json.", "format", "text");
+    QCommandLineOption speedOption("speed", "Replay: 1 = temps réel, 10 = dix fois plus vite, 0 = max.",
+                                   "facteur", "1");
+    QCommandLineOption clientsOption("clients", "Replay: nombre de clients (threads).", "n", "4");
+    QCommandLineOption seedOption("seed", "Replay: réinitialiser le stockage avec l'instantané de la capture.");
+    QCommandLineOption keepOption("keep", "Backup: nombre de sauvegardes conservées.", "n", "10");
+    QCommandLineOption dirOption("dir", "Backup: répertoire des sauvegardes.", "dossier", "backups");
+
+    parser.addOptions({dbOption, jsonOption, passwordOption, batchOption, keepIdsOption,
+                       skipErrorsOption, quietOption, fromOption, toOption, ratingsOption,
+                       historyOption, activitiesOption, formatOption, keepOption, dirOption,
+                       speedOption, clientsOption, seedOption});
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.isEmpty()) {
+        parser.showHelp(2);
+    }
+
+    Options options;
+    options.dbSpec = parser.value(dbOption);
+    options.jsonFile = parser.value(jsonOption);
+    options.password = parser.value(passwordOption);
+    options.batchSize = qMax(1, parser.value(batchOption).toInt());
+    options.keepIds = parser.isSet(keepIdsOption);
+    options.skipErrors = parser.isSet(skipErrorsOption);
+    options.quiet = parser.isSet(quietOption);
+
+    const QString command = args.first();
+
+    if (command == "import" || command == "export") {
+        if (args.size() < 2) {
+            err() << "Usage: fournisseur-cli " << command << " <fichier.csv|fichier.json>"
+                  << (command == "export" ? " [autres fichiers...]" : "") << "\n";
+            return 2;
+        }
+        return command == "import" ? runImport(args[1], options) : runExport(args.mid(1), options);
+    }
+    if (command == "stats") {
+        return runStats(options, parser.value(ratingsOption), parser.value(historyOption),
+                        parser.value(activitiesOption),
+                        parser.value(formatOption) == "json");
+    }
+    if (command == "backup") {
+        return runBackup(options, qMax(1, parser.value(keepOption).toInt()), parser.value(dirOption));
+    }
+    if (command == "migrate") {
+        if (!parser.isSet(fromOption) || !parser.isSet(toOption)) {
+            err() << "Usage: fournisseur-cli migrate --from SPEC --to SPEC\n";
+            return 2;
+        }
+        return runMigrate(parser.value(fromOption), parser.value(toOption), options);
+    }
+
+    if (command == "replay") {
+        if (args.size() < 2) {
+            err() << "Usage: fournisseur-cli replay <capture.jsonl> [--speed N] [--clients N] [--seed]\n";
+            return 2;
+        }
+        return runReplay(args[1], options, parser.value(speedOption).toDouble(),
+                         qMax(1, parser.value(clientsOption).toInt()), parser.isSet(seedOption),
+                         parser.value(formatOption) == "json");
+    }
+
+    err() << "Commande inconnue: " << command << "\n";
+    return 2;
+}
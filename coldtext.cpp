@@ -0,0 +1,98 @@
+#include "coldtext.h"
+#include "tracing.h"
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+std::atomic<quint64> nextStoreId{1};
+
+// Last block decompressed by this thread; a store address can be reused, its id cannot
+struct BlockCache {
+    quint64 store = 0;
+    int block = -1;
+    QByteArray data;
+};
+thread_local BlockCache blockCache;
+
+} // namespace
+
+// ===== ColdText Implementation =====
+QString ColdText::toString() const
+{
+    return store ? store->text(index) : value;
+}
+
+// ===== ColdTextStore Implementation =====
+ColdTextStore::ColdTextStore()
+    : count(0), compressed(0), raw(0), id(nextStoreId.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+ColdTextStore::Builder::Builder(int compressionLevel)
+    : store(new ColdTextStore()), level(compressionLevel)
+{
+    pending.reserve(BlockTexts);
+}
+
+ColdText ColdTextStore::Builder::add(const QString& text)
+{
+    if (text.isEmpty()) return ColdText();
+
+    ColdText cold = handle(store, store->count++);
+    pending.append(text.toUtf8());
+    if (pending.size() == BlockTexts) flush();
+    return cold;
+}
+
+std::shared_ptr<const ColdTextStore> ColdTextStore::Builder::finish()
+{
+    flush();
+    return store;
+}
+
+void ColdTextStore::Builder::flush()
+{
+    if (pending.isEmpty()) return;
+    TRACE_SCOPE("ColdTextStore::flush");
+
+    // Offsets first, then the text: one buffer, one compression call per block
+    QVector<quint32> offsets(pending.size() + 1);
+    quint32 position = 0;
+    for (int i = 0; i < pending.size(); ++i) {
+        offsets[i] = position;
+        position += quint32(pending[i].size());
+    }
+    offsets[pending.size()] = position;
+
+    QByteArray block;
+    block.reserve(offsets.size() * int(sizeof(quint32)) + int(position));
+    block.append(reinterpret_cast<const char*>(offsets.constData()), offsets.size() * int(sizeof(quint32)));
+    for (const QByteArray& text : pending) block.append(text);
+
+    store->raw += block.size();
+    store->blocks.append(qCompress(block, level));
+    store->compressed += store->blocks.last().size();
+    pending.clear();
+}
+
+QString ColdTextStore::text(int index) const
+{
+    if (index < 0 || index >= count) return QString();
+    int block = index / BlockTexts;
+    int slot = index % BlockTexts;
+
+    BlockCache& cache = blockCache;
+    if (cache.store != id || cache.block != block) {
+        TRACE_SCOPE("ColdTextStore::decompress");
+        cache.data = qUncompress(blocks[block]);
+        cache.store = id;
+        cache.block = block;
+    }
+
+    quint32 bounds[2];
+    std::memcpy(bounds, cache.data.constData() + slot * sizeof(quint32), sizeof(bounds));
+    int texts = qMin(BlockTexts, count - block * BlockTexts);
+    const char *data = cache.data.constData() + (texts + 1) * sizeof(quint32);
+    return QString::fromUtf8(data + bounds[0], int(bounds[1] - bounds[0]));
+}
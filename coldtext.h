@@ -0,0 +1,90 @@
+#ifndef COLDTEXT_H
+#define COLDTEXT_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <memory>
+
+class ColdTextStore;
+
+/**
+ * Value of a rarely read text field (historiqueLivraisons)
+ *
+ * Either a plain QString (edited or short-lived rows) or a slot in a shared,
+ * block-compressed ColdTextStore filled at load time. The text is only
+ * decompressed when toString() is called, i.e. when the field is displayed,
+ * edited or exported.
+ */
+class ColdText
+{
+public:
+    ColdText() : index(-1) {}
+    ColdText(const QString& text) : value(text), index(-1) {}
+
+    QString toString() const;
+    bool isStored() const { return store != nullptr; }
+    // Same stored slot: equal without decompressing either side
+    bool sameSlot(const ColdText& other) const { return store && store == other.store && index == other.index; }
+
+    qint64 loadedBytes() const { return isStored() ? 0 : 2 * value.capacity(); }
+    const ColdTextStore *storage() const { return store.get(); }
+
+private:
+    friend class ColdTextStore;
+    ColdText(std::shared_ptr<const ColdTextStore> store, int index) : store(std::move(store)), index(index) {}
+
+    QString value;
+    std::shared_ptr<const ColdTextStore> store;
+    int index;
+};
+
+/**
+ * Immutable block-compressed text storage
+ *
+ * Texts are packed as UTF-8 in blocks of BlockTexts entries, each block
+ * compressed with qCompress. Rows are displayed in order, so each thread
+ * keeps the last block it decompressed: scrolling or exporting decompresses
+ * each block once, and readers never wait on each other. Safe to read from
+ * several threads once the Builder has finished.
+ */
+class ColdTextStore
+{
+public:
+    static const int BlockTexts = 64;
+
+    class Builder
+    {
+    public:
+        explicit Builder(int compressionLevel = 6);
+
+        // Empty text stays inline; other handles are readable once finish() returned
+        ColdText add(const QString& text);
+        std::shared_ptr<const ColdTextStore> finish();
+
+    private:
+        std::shared_ptr<ColdTextStore> store;
+        QVector<QByteArray> pending;
+        int level;
+
+        void flush();
+    };
+
+    int size() const { return count; }
+    qint64 compressedBytes() const { return compressed; }
+    qint64 rawBytes() const { return raw; }
+
+    QString text(int index) const;
+
+private:
+    ColdTextStore();
+    static ColdText handle(std::shared_ptr<const ColdTextStore> store, int index) { return ColdText(std::move(store), index); }
+
+    QVector<QByteArray> blocks;     // qCompress([quint32 offsets[n + 1]][utf8 data])
+    int count;
+    qint64 compressed;
+    qint64 raw;
+    quint64 id;                     // never reused, keys the per-thread block cache
+};
+
+#endif // COLDTEXT_H
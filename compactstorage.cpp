@@ -0,0 +1,240 @@
+#include "compactstorage.h"
+#include "prefixindex.h"
+#include "tracing.h"
+#include <cstring>
+
+namespace {
+const quint32 BlockSize = 1u << StringArena::BlockBits;
+const quint32 OffsetMask = BlockSize - 1;
+}
+
+// ===== TextRef Implementation =====
+int TextRef::size() const
+{
+    quint8 tag = quint8(data[InlineCapacity]);
+    if (tag & 0x80) return tag & 0x7F;
+    return int(quint8(data[4])) | int(quint8(data[5])) << 8 | int(quint8(data[6])) << 16
+           | int(tag & 0x7F) << 24;
+}
+
+// ===== StringArena Implementation =====
+StringArena::StringArena()
+    : blockFill(BlockSize), allocated(0), used(0)
+{
+}
+
+TextRef StringArena::store(const QString& text)
+{
+    return store(QByteArrayView(text.toUtf8()));
+}
+
+TextRef StringArena::store(QByteArrayView utf8)
+{
+    TextRef ref;
+    quint32 length = quint32(utf8.size());
+    if (length <= quint32(TextRef::InlineCapacity)) {
+        if (length > 0) std::memcpy(ref.data, utf8.data(), length);
+        ref.data[TextRef::InlineCapacity] = char(0x80 | length);
+        return ref;
+    }
+
+    quint32 position;
+    if (length >= BlockSize) {
+        // Oversized text gets a block of its own; the next string starts a new regular block
+        blocks.push_back(std::make_unique<char[]>(length));
+        allocated += length;
+        position = 0;
+        blockFill = BlockSize;
+    } else {
+        if (blockFill + length > BlockSize) {
+            blocks.push_back(std::make_unique<char[]>(BlockSize));
+            allocated += BlockSize;
+            blockFill = 0;
+        }
+        position = blockFill;
+        blockFill += length;
+    }
+    Q_ASSERT_X(blocks.size() <= (size_t(1) << (32 - BlockBits)), "StringArena", "arena full (4 GiB)");
+
+    quint32 block = quint32(blocks.size() - 1);
+    std::memcpy(blocks.back().get() + position, utf8.data(), length);
+    used += length;
+
+    quint32 offset = block << BlockBits | position;
+    std::memcpy(ref.data, &offset, 4);
+    ref.data[4] = char(length & 0xFF);
+    ref.data[5] = char((length >> 8) & 0xFF);
+    ref.data[6] = char((length >> 16) & 0xFF);
+    ref.data[7] = char((length >> 24) & 0x7F);
+    return ref;
+}
+
+QByteArrayView StringArena::bytes(const TextRef& ref) const
+{
+    if (ref.isInline()) {
+        return QByteArrayView(ref.data, ref.size());
+    }
+    quint32 offset;
+    std::memcpy(&offset, ref.data, 4);
+    return QByteArrayView(blocks[offset >> BlockBits].get() + (offset & OffsetMask), ref.size());
+}
+
+void StringArena::clear()
+{
+    blocks.clear();
+    blockFill = BlockSize;
+    allocated = 0;
+    used = 0;
+}
+
+// ===== StringInterner Implementation =====
+StringInterner::StringInterner()
+{
+    strings.append(QString());      // id 0
+}
+
+quint32 StringInterner::intern(const QString& text)
+{
+    if (text.isEmpty()) return 0;
+    auto it = ids.constFind(text);
+    if (it != ids.constEnd()) return it.value();
+
+    quint32 id = quint32(strings.size());
+    strings.append(text);
+    ids.insert(text, id);
+    return id;
+}
+
+quint32 StringInterner::find(const QString& text) const
+{
+    return ids.value(text, 0);
+}
+
+qint64 StringInterner::memoryUsage() const
+{
+    // The hash and the vector share each string's data
+    qint64 bytes = qint64(strings.capacity()) * sizeof(QString) + qint64(ids.capacity()) * 2 * sizeof(void*);
+    for (const QString& s : strings) bytes += 2 * s.capacity() + 16;
+    return bytes;
+}
+
+// ===== CompactSupplierTable Implementation =====
+CompactSupplierTable::CompactSupplierTable()
+    : garbage(0)
+{
+}
+
+CompactSupplierTable::Record CompactSupplierTable::encode(const Fournisseur& f)
+{
+    Record record;
+    record.id = f.getIdFournisseur();
+    record.active = f.getIsActive();
+    record.nom = arena.store(f.getNom());
+    record.email = arena.store(f.getEmail());
+    record.telephone = arena.store(f.getTelephone());
+    record.historique = arena.store(f.getHistoriqueLivraisons());
+    record.typeCode = f.getTypeCode();
+
+    // "12 rue X, 75001 Paris": the city is shared by thousands of rows, the rest is not
+    QString adresse = f.getAdresse();
+    QString city = PrefixIndex::cityOf(adresse);
+    if (!city.isEmpty() && adresse.endsWith(city)) {
+        record.cityId = cityNames.intern(city);
+        record.adresse = arena.store(adresse.left(adresse.size() - city.size()));
+    } else {
+        record.adresse = arena.store(adresse);
+    }
+    return record;
+}
+
+int CompactSupplierTable::append(const Fournisseur& f)
+{
+    records.append(encode(f));
+    return records.size() - 1;
+}
+
+void CompactSupplierTable::replace(int row, const Fournisseur& f)
+{
+    garbage += textBytes(records[row]);
+    records[row] = encode(f);
+}
+
+void CompactSupplierTable::removeAt(int row)
+{
+    garbage += textBytes(records[row]);
+    records.removeAt(row);
+}
+
+void CompactSupplierTable::clear()
+{
+    records.clear();
+    arena.clear();
+    cityNames = StringInterner();
+    garbage = 0;
+}
+
+const TextRef& CompactSupplierTable::ref(const Record& record, Field field) const
+{
+    switch (field) {
+    case Nom:                  return record.nom;
+    case Adresse:              return record.adresse;
+    case Email:                return record.email;
+    case Telephone:            return record.telephone;
+    case HistoriqueLivraisons: return record.historique;
+    case TypeProduits:         break;
+    }
+    Q_ASSERT_X(false, "CompactSupplierTable::ref", "the product type has no arena text");
+    return record.nom;
+}
+
+QString CompactSupplierTable::text(int row, Field field) const
+{
+    const Record& record = records[row];
+    if (field == TypeProduits) return ProductTypes::label(record.typeCode);
+    QString value = arena.toString(ref(record, field));
+    if (field == Adresse && record.cityId != 0) value += cityNames.text(record.cityId);
+    return value;
+}
+
+QByteArrayView CompactSupplierTable::utf8(int row, Field field) const
+{
+    return arena.bytes(ref(records[row], field));
+}
+
+Fournisseur CompactSupplierTable::at(int row) const
+{
+    const Record& record = records[row];
+    return Fournisseur(record.id, text(row, Nom), text(row, Adresse), text(row, Email),
+                       text(row, Telephone), text(row, TypeProduits), text(row, HistoriqueLivraisons),
+                       record.active);
+}
+
+qint64 CompactSupplierTable::textBytes(const Record& record) const
+{
+    qint64 bytes = 0;
+    for (const TextRef* r : { &record.nom, &record.adresse, &record.email, &record.telephone,
+                              &record.historique }) {
+        if (!r->isInline()) bytes += r->size();
+    }
+    return bytes;
+}
+
+qint64 CompactSupplierTable::memoryUsage() const
+{
+    return qint64(records.capacity()) * qint64(sizeof(Record)) + arena.memoryUsage()
+           + cityNames.memoryUsage();
+}
+
+void CompactSupplierTable::compact()
+{
+    TRACE_SCOPE("CompactSupplierTable::compact");
+    StringArena fresh;
+    for (Record& record : records) {
+        for (TextRef* r : { &record.nom, &record.adresse, &record.email, &record.telephone,
+                            &record.historique }) {
+            if (!r->isInline()) *r = fresh.store(arena.bytes(*r));
+        }
+    }
+    std::swap(arena, fresh);
+    garbage = 0;
+}
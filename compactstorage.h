@@ -0,0 +1,152 @@
+#ifndef COMPACTSTORAGE_H
+#define COMPACTSTORAGE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QVector>
+#include <memory>
+#include <vector>
+#include "fournisseur.h"
+
+/**
+ * 8-byte handle to a UTF-8 string
+ *
+ * Up to 7 bytes are stored inline (phones without separators, short ids,
+ * most product codes); longer text is a slice of a StringArena. The last
+ * byte tells the two apart: high bit set = inline, low bits = length.
+ */
+class TextRef
+{
+public:
+    static const int InlineCapacity = 7;
+
+    TextRef() { data[InlineCapacity] = char(0x80); }   // empty inline string
+
+    bool isInline() const { return (quint8(data[InlineCapacity]) & 0x80) != 0; }
+    int size() const;
+    bool isEmpty() const { return size() == 0; }
+
+private:
+    friend class StringArena;
+    char data[8];
+};
+
+/**
+ * Append-only UTF-8 text storage in 1 MiB blocks
+ *
+ * One allocation per block instead of one per field; nothing is freed
+ * individually (replaced text stays until the owner rebuilds the arena).
+ */
+class StringArena
+{
+public:
+    static const int BlockBits = 20;
+
+    StringArena();
+
+    TextRef store(const QString& text);
+    TextRef store(QByteArrayView utf8);
+
+    // The view of an inline string points into 'ref': keep the ref alive while using it
+    QByteArrayView bytes(const TextRef& ref) const;
+    QString toString(const TextRef& ref) const { return QString::fromUtf8(bytes(ref)); }
+
+    qint64 memoryUsage() const { return allocated; }
+    qint64 bytesUsed() const { return used; }
+    void clear();
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    quint32 blockFill;              // bytes used in the last regular block
+    qint64 allocated;
+    qint64 used;
+};
+
+/**
+ * Dictionary of repeated values (city names): each distinct string is
+ * stored once and referred to by a 32-bit id; 0 is the empty string. The
+ * QString of every entry is cached, so converting an interned field for
+ * display allocates nothing.
+ */
+class StringInterner
+{
+public:
+    StringInterner();
+
+    quint32 intern(const QString& text);
+    quint32 find(const QString& text) const;        // 0 if unknown (or empty)
+    const QString& text(quint32 id) const { return strings[int(id)]; }
+    int size() const { return strings.size(); }
+    qint64 memoryUsage() const;
+
+private:
+    QHash<QString, quint32> ids;
+    QVector<QString> strings;
+};
+
+/**
+ * Memory-compact supplier table
+ *
+ * Text is kept as UTF-8 (the data is mostly ASCII: half the bytes of
+ * UTF-16) in one arena, short fields inline, the city part of addresses
+ * interned and the product type kept as its ProductTypes code. A row costs
+ * a fixed 56-byte record plus its unique text, against one separately
+ * allocated UTF-16 QString per text field for a Fournisseur. QString is
+ * built only when a field is read for display (text(), at()); comparisons
+ * can use the UTF-8 bytes directly.
+ */
+class CompactSupplierTable
+{
+public:
+    enum Field { Nom, Adresse, Email, Telephone, TypeProduits, HistoriqueLivraisons };
+
+    CompactSupplierTable();
+
+    int append(const Fournisseur& f);
+    void replace(int row, const Fournisseur& f);    // old text stays in the arena until compact()
+    void removeAt(int row);
+    void clear();
+    void reserve(int rows) { records.reserve(rows); }
+
+    int size() const { return records.size(); }
+    int idAt(int row) const { return records[row].id; }
+    bool isActiveAt(int row) const { return records[row].active; }
+    quint32 typeCodeAt(int row) const { return records[row].typeCode; }
+    QString text(int row, Field field) const;
+    Fournisseur at(int row) const;
+
+    // UTF-8 view; for the product type and addresses use text() instead
+    QByteArrayView utf8(int row, Field field) const;
+
+    const StringInterner& cities() const { return cityNames; }
+
+    qint64 memoryUsage() const;
+    qint64 garbageBytes() const { return garbage; }
+    void compact();                                 // rewrites the arena without replaced text
+
+private:
+    struct Record {
+        TextRef nom;
+        TextRef adresse;            // address without its interned city suffix
+        TextRef email;
+        TextRef telephone;
+        TextRef historique;
+        qint32 id = 0;
+        quint32 typeCode = 0;       // ProductTypes code
+        quint32 cityId = 0;
+        bool active = true;
+    };
+
+    StringArena arena;
+    StringInterner cityNames;
+    QVector<Record> records;
+    qint64 garbage;
+
+    Record encode(const Fournisseur& f);
+    const TextRef& ref(const Record& record, Field field) const;
+    qint64 textBytes(const Record& record) const;
+};
+
+#endif // COMPACTSTORAGE_H
@@ -0,0 +1,207 @@
+#include "contactindex.h"
+#include <cmath>
+
+namespace {
+
+inline quint64 mix64(quint64 x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+const double Ln2 = 0.69314718055994530942;
+
+} // namespace
+
+// ===== BloomFilter Implementation =====
+BloomFilter::BloomFilter()
+    : bitCount(0), hashCount(0)
+{
+}
+
+void BloomFilter::reset(int expectedItems, double falsePositiveRate)
+{
+    // m = -n ln(p) / ln(2)^2, k = m/n ln(2)
+    double n = qMax(expectedItems, 1024);
+    double m = -n * std::log(falsePositiveRate) / (Ln2 * Ln2);
+    bitCount = (quint64(m) + 63) & ~quint64(63);
+    hashCount = qBound(1, int(std::round(m / n * Ln2)), 16);
+    bits.assign(bitCount / 64, 0);
+}
+
+void BloomFilter::add(quint64 hash)
+{
+    quint64 h1 = hash;
+    quint64 h2 = mix64(hash) | 1;
+    for (int i = 0; i < hashCount; ++i) {
+        quint64 bit = (h1 + quint64(i) * h2) % bitCount;
+        bits[bit >> 6] |= quint64(1) << (bit & 63);
+    }
+}
+
+bool BloomFilter::mightContain(quint64 hash) const
+{
+    if (bitCount == 0) return true;
+    quint64 h1 = hash;
+    quint64 h2 = mix64(hash) | 1;
+    for (int i = 0; i < hashCount; ++i) {
+        quint64 bit = (h1 + quint64(i) * h2) % bitCount;
+        if (!(bits[bit >> 6] & (quint64(1) << (bit & 63)))) return false;
+    }
+    return true;
+}
+
+// ===== ContactIndex Implementation =====
+ContactIndex::ContactIndex()
+    : capacity(0)
+{
+}
+
+QString ContactIndex::normalizeEmail(const QString& email)
+{
+    return email.trimmed().toLower();
+}
+
+qint64 ContactIndex::normalizePhone(const QString& phone, int defaultCountryCode, int nationalDigits)
+{
+    QString trimmed = phone.trimmed();
+    QString digits;
+    for (const QChar& c : trimmed) {
+        if (c.isDigit()) digits += c;
+    }
+
+    if (trimmed.startsWith('+')) {
+        // already international
+    } else if (digits.startsWith("00")) {
+        digits.remove(0, 2);
+    } else {
+        QString countryCode = QString::number(defaultCountryCode);
+        if (digits.size() > nationalDigits && digits.startsWith(countryCode)) {
+            // Too long to be national: the country code is there, only the '+' was left out
+        } else {
+            // National number: drop the trunk prefix and add the country code
+            if (digits.startsWith('0')) digits.remove(0, 1);
+            digits.prepend(countryCode);
+        }
+    }
+
+    // E.164 allows at most 15 digits
+    if (digits.size() < 8 || digits.size() > 15) return 0;
+    return digits.toLongLong();
+}
+
+QString ContactIndex::fieldName(Field field)
+{
+    switch (field) {
+        case Email: return "email";
+        case Telephone: return "téléphone";
+        default: return "";
+    }
+}
+
+quint64 ContactIndex::hashEmail(const QString& email)
+{
+    return mix64(qHash(email, 0x5eed));
+}
+
+quint64 ContactIndex::hashPhone(qint64 phone)
+{
+    return mix64(quint64(phone));
+}
+
+void ContactIndex::clear()
+{
+    emailToId.clear();
+    phoneToId.clear();
+    capacity = 0;
+    emailFilter = BloomFilter();
+    phoneFilter = BloomFilter();
+}
+
+void ContactIndex::ensureCapacity(int items)
+{
+    if (items <= capacity) return;
+
+    // Bloom filters cannot grow: resize with headroom and re-add every key
+    capacity = qMax(items * 2, 1024);
+    emailFilter.reset(capacity);
+    phoneFilter.reset(capacity);
+    for (auto it = emailToId.constBegin(); it != emailToId.constEnd(); ++it) {
+        emailFilter.add(hashEmail(it.key()));
+    }
+    for (auto it = phoneToId.constBegin(); it != phoneToId.constEnd(); ++it) {
+        phoneFilter.add(hashPhone(it.key()));
+    }
+}
+
+void ContactIndex::build(const QList<Fournisseur>& fournisseurs)
+{
+    clear();
+    emailToId.reserve(fournisseurs.size());
+    phoneToId.reserve(fournisseurs.size());
+    ensureCapacity(fournisseurs.size());
+
+    for (const Fournisseur& f : fournisseurs) {
+        insert(f);
+    }
+}
+
+void ContactIndex::insert(const Fournisseur& f)
+{
+    ensureCapacity(qMax(emailToId.size(), phoneToId.size()) + 1);
+
+    QString email = normalizeEmail(f.getEmail());
+    if (!email.isEmpty()) {
+        emailToId.insert(email, f.getIdFournisseur());
+        emailFilter.add(hashEmail(email));
+    }
+
+    qint64 phone = normalizePhone(f.getTelephone());
+    if (phone != 0) {
+        phoneToId.insert(phone, f.getIdFournisseur());
+        phoneFilter.add(hashPhone(phone));
+    }
+}
+
+void ContactIndex::remove(const Fournisseur& f)
+{
+    // Bloom bits stay set; the hash table lookup resolves the false positive
+    QString email = normalizeEmail(f.getEmail());
+    auto emailIt = emailToId.find(email);
+    if (emailIt != emailToId.end() && emailIt.value() == f.getIdFournisseur()) {
+        emailToId.erase(emailIt);
+    }
+
+    qint64 phone = normalizePhone(f.getTelephone());
+    auto phoneIt = phoneToId.find(phone);
+    if (phoneIt != phoneToId.end() && phoneIt.value() == f.getIdFournisseur()) {
+        phoneToId.erase(phoneIt);
+    }
+}
+
+ContactIndex::Field ContactIndex::findConflict(const Fournisseur& f, int* conflictingId) const
+{
+    QString email = normalizeEmail(f.getEmail());
+    if (!email.isEmpty() && emailFilter.mightContain(hashEmail(email))) {
+        auto it = emailToId.constFind(email);
+        if (it != emailToId.constEnd() && it.value() != f.getIdFournisseur()) {
+            if (conflictingId) *conflictingId = it.value();
+            return Email;
+        }
+    }
+
+    qint64 phone = normalizePhone(f.getTelephone());
+    if (phone != 0 && phoneFilter.mightContain(hashPhone(phone))) {
+        auto it = phoneToId.constFind(phone);
+        if (it != phoneToId.constEnd() && it.value() != f.getIdFournisseur()) {
+            if (conflictingId) *conflictingId = it.value();
+            return Telephone;
+        }
+    }
+
+    return None;
+}
@@ -0,0 +1,65 @@
+#ifndef CONTACTINDEX_H
+#define CONTACTINDEX_H
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <vector>
+#include "fournisseur.h"
+
+// Bloom filter used as a fast "definitely not present" check
+class BloomFilter
+{
+private:
+    std::vector<quint64> bits;
+    quint64 bitCount;
+    int hashCount;
+
+public:
+    BloomFilter();
+    void reset(int expectedItems, double falsePositiveRate = 0.01);
+    void add(quint64 hash);
+    bool mightContain(quint64 hash) const;
+    bool isEmpty() const { return bitCount == 0; }
+};
+
+/**
+ * Unique contact index
+ * Normalized keys: lower-cased email, phone as E.164 digits in a 64-bit int.
+ * Lookups go through a Bloom filter first, then a hash table: O(1) expected.
+ */
+class ContactIndex
+{
+public:
+    enum Field { None, Email, Telephone };
+
+    ContactIndex();
+
+    void build(const QList<Fournisseur>& fournisseurs);
+    void insert(const Fournisseur& f);
+    void remove(const Fournisseur& f);
+    void clear();
+
+    // Returns the field that collides with another supplier (ignoring f's own id)
+    Field findConflict(const Fournisseur& f, int* conflictingId = nullptr) const;
+
+    static QString normalizeEmail(const QString& email);
+    // E.164 digits; a number longer than nationalDigits that starts with the
+    // default country code is taken as international without its '+'
+    static qint64 normalizePhone(const QString& phone, int defaultCountryCode = 216,
+                                 int nationalDigits = 8);
+    static QString fieldName(Field field);
+
+private:
+    QHash<QString, int> emailToId;
+    QHash<qint64, int> phoneToId;
+    BloomFilter emailFilter;
+    BloomFilter phoneFilter;
+    int capacity;
+
+    void ensureCapacity(int items);
+    static quint64 hashEmail(const QString& email);
+    static quint64 hashPhone(qint64 phone);
+};
+
+#endif // CONTACTINDEX_H
@@ -1,14 +1,26 @@
 #include "databasemanager.h"
+#include "contactindex.h"
+#include "tracing.h"
+#include "advancedfeatures.h"
+#include "memoryengine.h"
+#include <QElapsedTimer>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
 #include <QDebug>
-#include <QJsonDocument>
-#include <QJsonArray>
-#include <QFile>
+#include <QHash>
+#include <QTimeZone>
+#include <QMutex>
+#include <QMutexLocker>
 
-DatabaseManager::DatabaseManager(DatabaseType type)
-    : connected(false), dbType(type)
+namespace {
+// Engines by connection name, for connectLike
+QMutex engineConnectionsMutex;
+QHash<QString, std::weak_ptr<MemoryEngine>> engineConnections;
+}
+
+DatabaseManager::DatabaseManager(DatabaseType type, const QString& connectionName)
+    : connected(false), dbType(type), connectionName(connectionName)
 {
 }
 
@@ -17,6 +29,10 @@ DatabaseManager::~DatabaseManager()
     if (connected) {
         disconnect();
     }
+    if (!connectionName.isEmpty() && db.isValid()) {
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(connectionName);
+    }
 }
 
 QString DatabaseManager::getDatabaseType() const
@@ -26,14 +42,38 @@ QString DatabaseManager::getDatabaseType() const
         case Oracle: return "Oracle Database";
         case MySQL: return "MySQL Database";
         case PostgreSQL: return "PostgreSQL Database";
+        case InMemory: return "In-Memory Engine (journaled)";
         default: return "Unknown";
     }
 }
 
+QString DatabaseManager::getConnectionName() const
+{
+    if (dbType == InMemory) {
+        return connectionName.isEmpty() ? QString(QSqlDatabase::defaultConnection) : connectionName;
+    }
+    return db.connectionName();
+}
+
 bool DatabaseManager::connectToDatabase(const QString& dbName)
 {
+    if (dbType == InMemory) {
+        engine = MemoryEngine::open(dbName, lastError);
+        connected = engine != nullptr;
+        if (!connected) {
+            qDebug() << "❌ Connection failed:" << lastError;
+            return false;
+        }
+        lastError.clear();
+        QMutexLocker locker(&engineConnectionsMutex);
+        engineConnections.insert(getConnectionName(), engine);
+        qDebug() << "✅ Connected to" << getDatabaseType() << dbName;
+        return true;
+    }
+    
     // SQLite - Works on ANY macOS without installation!
-    db = QSqlDatabase::addDatabase("QSQLITE");
+    db = connectionName.isEmpty() ? QSqlDatabase::addDatabase("QSQLITE")
+                                  : QSqlDatabase::addDatabase("QSQLITE", connectionName);
     db.setDatabaseName(dbName);
     
     if (db.open()) {
@@ -49,13 +89,38 @@ bool DatabaseManager::connectToDatabase(const QString& dbName)
     }
 }
 
+bool DatabaseManager::connectLike(const QString& sourceConnection)
+{
+    if (dbType == InMemory) {
+        // Same process: the engine itself is shared, there is no second connection to open
+        QMutexLocker locker(&engineConnectionsMutex);
+        engine = engineConnections.value(sourceConnection).lock();
+        connected = engine != nullptr;
+        lastError = connected ? QString() : "No in-memory engine named " + sourceConnection;
+        return connected;
+    }
+    
+    // cloneDatabase by name is the thread-safe way to open a second connection
+    db = QSqlDatabase::cloneDatabase(sourceConnection, connectionName);
+    
+    if (db.open()) {
+        connected = true;
+        lastError.clear();
+        return true;
+    }
+    connected = false;
+    lastError = db.lastError().text();
+    return false;
+}
+
 bool DatabaseManager::connectToOracle(const QString& host, int port, 
                                       const QString& sid,
                                       const QString& username, 
                                       const QString& password)
 {
     // Oracle connection (when available)
-    db = QSqlDatabase::addDatabase("QOCI");
+    db = connectionName.isEmpty() ? QSqlDatabase::addDatabase("QOCI")
+                                  : QSqlDatabase::addDatabase("QOCI", connectionName);
     db.setHostName(host);
     db.setPort(port);
     db.setDatabaseName(sid);
@@ -78,6 +143,10 @@ bool DatabaseManager::connectToOracle(const QString& host, int port,
 
 void DatabaseManager::disconnect()
 {
+    if (engine) {
+        engine.reset();
+        connected = false;
+    }
     if (connected) {
         db.close();
         connected = false;
@@ -86,10 +155,12 @@ void DatabaseManager::disconnect()
 
 bool DatabaseManager::createTables()
 {
+    TRACE_SCOPE("DatabaseManager::createTables");
     if (!connected) {
         lastError = "Not connected to database";
         return false;
     }
+    if (engine) return true;    // fixed columns, nothing to create
     
     QSqlQuery query(db);
     QString createTableSQL;
@@ -103,8 +174,9 @@ bool DatabaseManager::createTables()
                 ADRESSE TEXT,
                 EMAIL TEXT,
                 TELEPHONE TEXT,
-                TYPE_PRODUITS TEXT,
+                ID_TYPE_PRODUIT INTEGER,
                 HISTORIQUE_LIVRAISONS TEXT,
+                TELEPHONE_E164 INTEGER,
                 IS_ACTIVE INTEGER DEFAULT 1,
                 DATE_CREATION TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
                 DATE_MODIFICATION TIMESTAMP DEFAULT CURRENT_TIMESTAMP
@@ -119,8 +191,9 @@ bool DatabaseManager::createTables()
                 ADRESSE VARCHAR2(200),
                 EMAIL VARCHAR2(100),
                 TELEPHONE VARCHAR2(20),
-                TYPE_PRODUITS VARCHAR2(100),
+                ID_TYPE_PRODUIT NUMBER(10),
                 HISTORIQUE_LIVRAISONS VARCHAR2(500),
+                TELEPHONE_E164 NUMBER(19),
                 IS_ACTIVE NUMBER(1) DEFAULT 1,
                 DATE_CREATION TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
                 DATE_MODIFICATION TIMESTAMP DEFAULT CURRENT_TIMESTAMP
@@ -134,248 +207,853 @@ bool DatabaseManager::createTables()
         return false;
     }
     
+    createProductTypes();
+    createContactIndexes();
+    createSyncTables();
+    
     qDebug() << "✅ Tables created successfully in" << getDatabaseType();
     return true;
 }
 
-bool DatabaseManager::insertFournisseur(const Fournisseur& f)
+bool DatabaseManager::createProductTypes()
 {
+    QSqlQuery query(db);
+    bool ok = true;
+    
+    // FOURNISSEURS keeps an integer code; the label is stored once here
+    if (dbType == SQLite) {
+        ok = query.exec("CREATE TABLE IF NOT EXISTS PRODUCT_TYPES ("
+                        "ID_TYPE INTEGER PRIMARY KEY, "
+                        "LIBELLE TEXT NOT NULL UNIQUE)");
+    } else {
+        ok = query.exec("CREATE TABLE PRODUCT_TYPES ("
+                        "ID_TYPE NUMBER(10) PRIMARY KEY, "
+                        "LIBELLE VARCHAR2(100) NOT NULL UNIQUE)");
+    }
+    if (!ok) {
+        // Already present on Oracle (no IF NOT EXISTS)
+        qDebug() << "⚠️ Product type table not created:" << query.lastError().text();
+    }
+    
+    // Tables from before the dictionary need the code column before it can be indexed
+    // (fails harmlessly when it exists)
+    if (dbType == SQLite) {
+        query.exec("ALTER TABLE FOURNISSEURS ADD COLUMN ID_TYPE_PRODUIT INTEGER");
+        ok = query.exec("CREATE INDEX IF NOT EXISTS IX_FOURNISSEURS_TYPE "
+                        "ON FOURNISSEURS(ID_TYPE_PRODUIT)") && ok;
+    } else {
+        query.exec("ALTER TABLE FOURNISSEURS ADD (ID_TYPE_PRODUIT NUMBER(10))");
+        ok = query.exec("CREATE INDEX IX_FOURNISSEURS_TYPE "
+                        "ON FOURNISSEURS(ID_TYPE_PRODUIT)") && ok;
+    }
+    if (!ok) {
+        qDebug() << "⚠️ Product type object not created:" << query.lastError().text();
+    }
+    
+    // Move the free-text labels over. The text is cleared once converted, so this
+    // runs only once; on new tables TYPE_PRODUITS does not exist and the first
+    // statement fails. One transaction: a crash never leaves half-converted rows.
+    db.transaction();
+    bool migrated;
+    if (dbType == SQLite) {
+        migrated = query.exec("INSERT INTO PRODUCT_TYPES (LIBELLE) "
+                              "SELECT DISTINCT TYPE_PRODUITS FROM FOURNISSEURS "
+                              "WHERE TYPE_PRODUITS IS NOT NULL AND TYPE_PRODUITS <> '' "
+                              "AND TYPE_PRODUITS NOT IN (SELECT LIBELLE FROM PRODUCT_TYPES)");
+    } else {
+        migrated = query.exec("INSERT INTO PRODUCT_TYPES (ID_TYPE, LIBELLE) "
+                              "SELECT (SELECT NVL(MAX(ID_TYPE), 0) FROM PRODUCT_TYPES) + ROWNUM, TYPE_PRODUITS "
+                              "FROM (SELECT DISTINCT TYPE_PRODUITS FROM FOURNISSEURS "
+                              "WHERE TYPE_PRODUITS IS NOT NULL "
+                              "AND TYPE_PRODUITS NOT IN (SELECT LIBELLE FROM PRODUCT_TYPES))");
+    }
+    migrated = migrated &&
+               query.exec("UPDATE FOURNISSEURS SET ID_TYPE_PRODUIT = "
+                          "(SELECT ID_TYPE FROM PRODUCT_TYPES WHERE LIBELLE = FOURNISSEURS.TYPE_PRODUITS) "
+                          "WHERE TYPE_PRODUITS IS NOT NULL") &&
+               query.exec("UPDATE FOURNISSEURS SET TYPE_PRODUITS = NULL WHERE TYPE_PRODUITS IS NOT NULL");
+    if (!migrated || !db.commit()) {
+        db.rollback();
+    }
+    return ok;
+}
+
+bool DatabaseManager::productTypeId(const QString& label, QVariant& id)
+{
+    if (label.isEmpty()) {
+        id = QVariant(QMetaType::fromType<int>());     // NULL: no type
+        return true;
+    }
+    auto cached = typeIds.constFind(label);
+    if (cached != typeIds.constEnd()) {
+        id = cached.value();
+        return true;
+    }
+    
+    QSqlQuery query(db);
+    auto lookup = [&]() {
+        query.prepare("SELECT ID_TYPE FROM PRODUCT_TYPES WHERE LIBELLE = :libelle");
+        query.bindValue(":libelle", label);
+        if (!query.exec() || !query.next()) return false;
+        id = query.value(0).toInt();
+        typeIds.insert(label, id.toInt());
+        return true;
+    };
+    if (lookup()) return true;
+    
+    // New label. Two clients may compute the same next ID_TYPE: the loser's insert
+    // fails on a constraint and it looks again. Either the winner added this very
+    // label, or the next attempt takes the following id.
+    for (int attempt = 0; attempt < 5; ++attempt) {
+        QSqlQuery insert(db);
+        insert.prepare("INSERT INTO PRODUCT_TYPES (ID_TYPE, LIBELLE) "
+                       "SELECT COALESCE(MAX(ID_TYPE), 0) + 1, :libelle FROM PRODUCT_TYPES");
+        insert.bindValue(":libelle", label);
+        bool inserted = insert.exec();
+        if (lookup()) return true;
+        lastError = inserted ? query.lastError().text() : insert.lastError().text();
+        if (inserted) break;
+    }
+    return false;
+}
+
+bool DatabaseManager::createContactIndexes()
+{
+    QSqlQuery query(db);
+    
+    // Tables created before the column existed: add it (fails harmlessly otherwise)
+    if (dbType == SQLite) {
+        query.exec("ALTER TABLE FOURNISSEURS ADD COLUMN TELEPHONE_E164 INTEGER");
+    } else {
+        query.exec("ALTER TABLE FOURNISSEURS ADD (TELEPHONE_E164 NUMBER(19))");
+    }
+    
+    // Rows written before the column (or by older builds) get their key now, or
+    // the unique index would let their duplicates in. Unparsable numbers stay NULL.
+    QList<QPair<int, qint64>> keys;
+    query.exec("SELECT ID_FOURNISSEUR, TELEPHONE FROM FOURNISSEURS "
+               "WHERE TELEPHONE_E164 IS NULL AND TELEPHONE IS NOT NULL");
+    while (query.next()) {
+        qint64 e164 = ContactIndex::normalizePhone(query.value(1).toString());
+        if (e164 != 0) keys.append(qMakePair(query.value(0).toInt(), e164));
+    }
+    if (!keys.isEmpty()) {
+        db.transaction();
+        QSqlQuery update(db);
+        update.prepare("UPDATE FOURNISSEURS SET TELEPHONE_E164 = :e164 WHERE ID_FOURNISSEUR = :id");
+        bool filled = true;
+        for (const auto& key : keys) {
+            update.bindValue(":e164", key.second);
+            update.bindValue(":id", key.first);
+            filled = update.exec() && filled;
+        }
+        if (!filled || !db.commit()) {
+            qDebug() << "⚠️ TELEPHONE_E164 not filled:" << update.lastError().text();
+            db.rollback();
+        } else {
+            qDebug() << "✅ TELEPHONE_E164 filled for" << keys.size() << "rows";
+        }
+    }
+    
+    // Same normalization as ContactIndex: lower-cased email, E.164 phone.
+    // NULLs (empty email / unparsable phone) never collide.
+    QStringList indexSQL;
+    if (dbType == SQLite) {
+        indexSQL << "CREATE UNIQUE INDEX IF NOT EXISTS UX_FOURNISSEURS_EMAIL "
+                    "ON FOURNISSEURS(LOWER(TRIM(NULLIF(EMAIL, ''))))"
+                 << "CREATE UNIQUE INDEX IF NOT EXISTS UX_FOURNISSEURS_TEL "
+                    "ON FOURNISSEURS(TELEPHONE_E164)";
+    } else {
+        indexSQL << "CREATE UNIQUE INDEX UX_FOURNISSEURS_EMAIL "
+                    "ON FOURNISSEURS(LOWER(TRIM(EMAIL)))"
+                 << "CREATE UNIQUE INDEX UX_FOURNISSEURS_TEL "
+                    "ON FOURNISSEURS(TELEPHONE_E164)";
+    }
+    
+    bool ok = true;
+    for (const QString& sql : indexSQL) {
+        if (!query.exec(sql)) {
+            // Already present (Oracle has no IF NOT EXISTS) or existing duplicates
+            qDebug() << "⚠️ Contact index not created:" << query.lastError().text();
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool DatabaseManager::createSyncTables()
+{
+    QSqlQuery query(db);
+    QStringList syncSQL;
+    
+    // Delta sync reads FOURNISSEURS by DATE_MODIFICATION and deletes from tombstones
+    if (dbType == SQLite) {
+        syncSQL << "CREATE INDEX IF NOT EXISTS IX_FOURNISSEURS_DATE_MODIF "
+                   "ON FOURNISSEURS(DATE_MODIFICATION)"
+                << "CREATE TABLE IF NOT EXISTS FOURNISSEURS_TOMBSTONES ("
+                   "ID_FOURNISSEUR INTEGER NOT NULL, "
+                   "DATE_SUPPRESSION TIMESTAMP NOT NULL)"
+                << "CREATE INDEX IF NOT EXISTS IX_TOMBSTONES_DATE "
+                   "ON FOURNISSEURS_TOMBSTONES(DATE_SUPPRESSION)";
+    } else {
+        syncSQL << "CREATE INDEX IX_FOURNISSEURS_DATE_MODIF "
+                   "ON FOURNISSEURS(DATE_MODIFICATION)"
+                << "CREATE TABLE FOURNISSEURS_TOMBSTONES ("
+                   "ID_FOURNISSEUR NUMBER(10) NOT NULL, "
+                   "DATE_SUPPRESSION TIMESTAMP NOT NULL)"
+                << "CREATE INDEX IX_TOMBSTONES_DATE "
+                   "ON FOURNISSEURS_TOMBSTONES(DATE_SUPPRESSION)";
+    }
+    
+    bool ok = true;
+    for (const QString& sql : syncSQL) {
+        if (!query.exec(sql)) {
+            // Already present on Oracle (no IF NOT EXISTS)
+            qDebug() << "⚠️ Sync object not created:" << query.lastError().text();
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+QString DatabaseManager::nowExpression() const
+{
+    // UTC with sub-second precision (CURRENT_TIMESTAMP is whole seconds on SQLite)
+    if (dbType == SQLite) {
+        return "STRFTIME('%Y-%m-%d %H:%M:%f', 'now')";
+    }
+    return "SYS_EXTRACT_UTC(SYSTIMESTAMP)";
+}
+
+QVariant DatabaseManager::timestampValue(const QDateTime& utc) const
+{
+    // SQLite keeps the text form written by nowExpression(), which compares lexically
+    if (dbType == SQLite) {
+        return utc.toUTC().toString("yyyy-MM-dd HH:mm:ss.zzz");
+    }
+    return utc.toUTC();
+}
+
+QDateTime DatabaseManager::readTimestamp(const QVariant& value)
+{
+    if (value.typeId() == QMetaType::QString) {
+        QString text = value.toString();
+        QDateTime dt = QDateTime::fromString(text, "yyyy-MM-dd HH:mm:ss.zzz");
+        if (!dt.isValid()) dt = QDateTime::fromString(text, "yyyy-MM-dd HH:mm:ss");
+        dt.setTimeZone(QTimeZone::UTC);
+        return dt;
+    }
+    QDateTime dt = value.toDateTime();
+    dt.setTimeZone(QTimeZone::UTC);
+    return dt;
+}
+
+void DatabaseManager::recordQuery(const QString& label, QSqlQuery& query,
+                                  const QElapsedTimer& timer, qint64 rows, bool ok)
+{
+    quint64 elapsedNs = quint64(timer.nsecsElapsed());
+    metrics.record(label, elapsedNs, rows, ok);
+    
+    if (metrics.isSlow(elapsedNs)) {
+        QString sql = query.lastQuery();
+        QVariantList params = query.boundValues();
+        metrics.logSlowQuery(label, elapsedNs / 1e6, sql, params, explainQuery(sql, params));
+    }
+}
+
+QStringList DatabaseManager::explainQuery(const QString& sql, const QVariantList& params)
+{
+    QStringList plan;
+    QSqlQuery explain(db);
+    
+    if (dbType == SQLite) {
+        explain.prepare("EXPLAIN QUERY PLAN " + sql);
+        for (int i = 0; i < params.size(); ++i) {
+            explain.bindValue(i, params[i]);
+        }
+        if (explain.exec()) {
+            // Columns: id, parent, notused, detail
+            while (explain.next()) {
+                plan << explain.value(3).toString();
+            }
+        }
+    } else if (dbType == Oracle) {
+        explain.prepare("EXPLAIN PLAN FOR " + sql);
+        for (int i = 0; i < params.size(); ++i) {
+            explain.bindValue(i, params[i]);
+        }
+        if (explain.exec() &&
+            explain.exec("SELECT PLAN_TABLE_OUTPUT FROM TABLE(DBMS_XPLAN.DISPLAY())")) {
+            while (explain.next()) {
+                plan << explain.value(0).toString();
+            }
+        }
+    }
+    
+    if (plan.isEmpty()) {
+        plan << QString("(plan indisponible: %1)").arg(explain.lastError().text());
+    }
+    return plan;
+}
+
+QVariant DatabaseManager::telephoneKey(const Fournisseur& f)
+{
+    qint64 e164 = ContactIndex::normalizePhone(f.getTelephone());
+    return e164 != 0 ? QVariant(e164) : QVariant();
+}
+
+QString DatabaseManager::selectFournisseurs()
+{
+    // Every read goes through this join: rows carry the label of their type code
+    return "SELECT F.*, T.LIBELLE AS TYPE_LIBELLE FROM FOURNISSEURS F "
+           "LEFT JOIN PRODUCT_TYPES T ON T.ID_TYPE = F.ID_TYPE_PRODUIT";
+}
+
+Fournisseur DatabaseManager::readRow(const QSqlQuery& query)
+{
+    return Fournisseur(
+        query.value("ID_FOURNISSEUR").toInt(),
+        query.value("NOM").toString(),
+        query.value("ADRESSE").toString(),
+        query.value("EMAIL").toString(),
+        query.value("TELEPHONE").toString(),
+        query.value("TYPE_LIBELLE").toString(),
+        query.value("HISTORIQUE_LIVRAISONS").toString(),
+        query.value("IS_ACTIVE").toInt() == 1
+    );
+}
+
+bool DatabaseManager::insertFournisseur(const Fournisseur& f, bool preserveId, int* newId)
+{
+    TRACE_SCOPE("DatabaseManager::insertFournisseur");
     if (!connected) return false;
     
+    if (engine) {
+        QElapsedTimer timer;
+        timer.start();
+        bool ok = engine->insert(f, preserveId, lastError, newId);
+        metrics.record("insertFournisseur", quint64(timer.nsecsElapsed()), ok ? 1 : 0, ok);
+        return ok;
+    }
+    
+    QVariant typeId;
+    if (!productTypeId(f.getTypeProduits(), typeId)) return false;
+    
     QSqlQuery query(db);
-    query.prepare(R"(
-        INSERT INTO FOURNISSEURS 
-        (NOM, ADRESSE, EMAIL, TELEPHONE, TYPE_PRODUITS, 
-         HISTORIQUE_LIVRAISONS, IS_ACTIVE)
-        VALUES (:nom, :adresse, :email, :telephone, :type, :historique, :active)
-    )");
+    if (preserveId) {
+        query.prepare(QString(R"(
+            INSERT INTO FOURNISSEURS 
+            (ID_FOURNISSEUR, NOM, ADRESSE, EMAIL, TELEPHONE, ID_TYPE_PRODUIT, 
+             HISTORIQUE_LIVRAISONS, TELEPHONE_E164, IS_ACTIVE, DATE_MODIFICATION)
+            VALUES (:id, :nom, :adresse, :email, :telephone, :type, :historique, :tel164, :active, %1)
+        )").arg(nowExpression()));
+        query.bindValue(":id", f.getIdFournisseur());
+    } else if (dbType == Oracle) {
+        // No identity column: the id is computed by the statement and handed back
+        query.prepare(QString(R"(
+            INSERT INTO FOURNISSEURS 
+            (ID_FOURNISSEUR, NOM, ADRESSE, EMAIL, TELEPHONE, ID_TYPE_PRODUIT, 
+             HISTORIQUE_LIVRAISONS, TELEPHONE_E164, IS_ACTIVE, DATE_MODIFICATION)
+            VALUES ((SELECT NVL(MAX(ID_FOURNISSEUR), 0) + 1 FROM FOURNISSEURS),
+                    :nom, :adresse, :email, :telephone, :type, :historique, :tel164, :active, %1)
+            RETURNING ID_FOURNISSEUR INTO :newid
+        )").arg(nowExpression()));
+        query.bindValue(":newid", 0, QSql::Out);
+    } else {
+        query.prepare(QString(R"(
+            INSERT INTO FOURNISSEURS 
+            (NOM, ADRESSE, EMAIL, TELEPHONE, ID_TYPE_PRODUIT, 
+             HISTORIQUE_LIVRAISONS, TELEPHONE_E164, IS_ACTIVE, DATE_MODIFICATION)
+            VALUES (:nom, :adresse, :email, :telephone, :type, :historique, :tel164, :active, %1)
+        )").arg(nowExpression()));
+    }
     
     query.bindValue(":nom", f.getNom());
     query.bindValue(":adresse", f.getAdresse());
     query.bindValue(":email", f.getEmail());
     query.bindValue(":telephone", f.getTelephone());
-    query.bindValue(":type", f.getTypeProduits());
+    query.bindValue(":type", typeId);
     query.bindValue(":historique", f.getHistoriqueLivraisons());
+    query.bindValue(":tel164", telephoneKey(f));
     query.bindValue(":active", f.getIsActive() ? 1 : 0);
     
-    if (!query.exec()) {
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = query.exec();
+    recordQuery("insertFournisseur", query, timer, ok ? 1 : 0, ok);
+    
+    if (!ok) {
         lastError = query.lastError().text();
         qDebug() << "Insert error:" << lastError;
         return false;
     }
     
+    if (newId) {
+        if (preserveId) *newId = f.getIdFournisseur();
+        else if (dbType == Oracle) *newId = query.boundValue(":newid").toInt();
+        else *newId = query.lastInsertId().toInt();
+    }
     return true;
 }
 
 bool DatabaseManager::updateFournisseur(const Fournisseur& f)
 {
+    TRACE_SCOPE("DatabaseManager::updateFournisseur");
     if (!connected) return false;
     
+    if (engine) {
+        QElapsedTimer timer;
+        timer.start();
+        int changed = engine->update(f, lastError);
+        metrics.record("updateFournisseur", quint64(timer.nsecsElapsed()), qMax(changed, 0), changed >= 0);
+        return changed >= 0;
+    }
+    
+    QVariant typeId;
+    if (!productTypeId(f.getTypeProduits(), typeId)) return false;
+    
     QSqlQuery query(db);
-    query.prepare(R"(
+    query.prepare(QString(R"(
         UPDATE FOURNISSEURS SET
             NOM = :nom,
             ADRESSE = :adresse,
             EMAIL = :email,
             TELEPHONE = :telephone,
-            TYPE_PRODUITS = :type,
+            ID_TYPE_PRODUIT = :type,
             HISTORIQUE_LIVRAISONS = :historique,
+            TELEPHONE_E164 = :tel164,
             IS_ACTIVE = :active,
-            DATE_MODIFICATION = CURRENT_TIMESTAMP
+            DATE_MODIFICATION = %1
         WHERE ID_FOURNISSEUR = :id
-    )");
+    )").arg(nowExpression()));
     
     query.bindValue(":nom", f.getNom());
     query.bindValue(":adresse", f.getAdresse());
     query.bindValue(":email", f.getEmail());
     query.bindValue(":telephone", f.getTelephone());
-    query.bindValue(":type", f.getTypeProduits());
+    query.bindValue(":type", typeId);
     query.bindValue(":historique", f.getHistoriqueLivraisons());
+    query.bindValue(":tel164", telephoneKey(f));
     query.bindValue(":active", f.getIsActive() ? 1 : 0);
     query.bindValue(":id", f.getIdFournisseur());
     
-    return query.exec();
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = query.exec();
+    recordQuery("updateFournisseur", query, timer, ok ? query.numRowsAffected() : 0, ok);
+    
+    if (!ok) {
+        lastError = query.lastError().text();
+        qDebug() << "Update error:" << lastError;
+        return false;
+    }
+    
+    return true;
 }
 
 bool DatabaseManager::deleteFournisseur(int id)
 {
+    TRACE_SCOPE("DatabaseManager::deleteFournisseur");
     if (!connected) return false;
     
+    if (engine) {
+        QElapsedTimer timer;
+        timer.start();
+        int removed = engine->remove(id, lastError);
+        metrics.record("deleteFournisseur", quint64(timer.nsecsElapsed()), qMax(removed, 0), removed >= 0);
+        return removed >= 0;
+    }
+    
+    // Row and tombstone go together (a batch caller may already hold a transaction)
+    bool ownTransaction = db.transaction();
+    
     QSqlQuery query(db);
     query.prepare("DELETE FROM FOURNISSEURS WHERE ID_FOURNISSEUR = :id");
     query.bindValue(":id", id);
     
-    return query.exec();
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = query.exec();
+    int removed = ok ? query.numRowsAffected() : 0;
+    recordQuery("deleteFournisseur", query, timer, removed, ok);
+    
+    if (!ok) {
+        lastError = query.lastError().text();
+    } else if (removed > 0) {
+        QSqlQuery tombstone(db);
+        tombstone.prepare(QString("INSERT INTO FOURNISSEURS_TOMBSTONES (ID_FOURNISSEUR, DATE_SUPPRESSION) "
+                                  "VALUES (:id, %1)").arg(nowExpression()));
+        tombstone.bindValue(":id", id);
+        ok = tombstone.exec();
+        if (!ok) lastError = tombstone.lastError().text();
+    }
+    
+    if (!ok) {
+        if (ownTransaction) db.rollback();
+        return false;
+    }
+    if (ownTransaction && !db.commit()) {
+        lastError = db.lastError().text();
+        return false;
+    }
+    return true;
 }
 
 Fournisseur DatabaseManager::getFournisseurById(int id, bool& success)
 {
+    TRACE_SCOPE("DatabaseManager::getFournisseurById");
     Fournisseur f;
     success = false;
     
     if (!connected) return f;
     
+    if (engine) {
+        QElapsedTimer timer;
+        timer.start();
+        success = engine->get(id, f);
+        metrics.record("getFournisseurById", quint64(timer.nsecsElapsed()), success ? 1 : 0, true);
+        return f;
+    }
+    
     QSqlQuery query(db);
-    query.prepare("SELECT * FROM FOURNISSEURS WHERE ID_FOURNISSEUR = :id");
+    query.prepare(selectFournisseurs() + " WHERE F.ID_FOURNISSEUR = :id");
     query.bindValue(":id", id);
     
-    if (query.exec() && query.next()) {
-        f = Fournisseur(
-            query.value("ID_FOURNISSEUR").toInt(),
-            query.value("NOM").toString(),
-            query.value("ADRESSE").toString(),
-            query.value("EMAIL").toString(),
-            query.value("TELEPHONE").toString(),
-            query.value("TYPE_PRODUITS").toString(),
-            query.value("HISTORIQUE_LIVRAISONS").toString(),
-            query.value("IS_ACTIVE").toInt() == 1
-        );
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = query.exec();
+    if (ok && query.next()) {
+        f = readRow(query);
         success = true;
     }
+    recordQuery("getFournisseurById", query, timer, success ? 1 : 0, ok);
     
     return f;
 }
 
 QList<Fournisseur> DatabaseManager::getAllFournisseurs(bool& success)
 {
+    TRACE_SCOPE("DatabaseManager::getAllFournisseurs");
     QList<Fournisseur> list;
     success = false;
     
     if (!connected) return list;
     
+    if (engine) {
+        QElapsedTimer timer;
+        timer.start();
+        list = engine->all();
+        success = true;
+        metrics.record("getAllFournisseurs", quint64(timer.nsecsElapsed()), list.size(), true);
+        return list;
+    }
+    
     QSqlQuery query(db);
-    if (!query.exec("SELECT * FROM FOURNISSEURS ORDER BY ID_FOURNISSEUR")) {
+    query.setForwardOnly(true);
+    QElapsedTimer timer;
+    timer.start();
+    if (!query.exec(selectFournisseurs() + " ORDER BY F.ID_FOURNISSEUR")) {
         lastError = query.lastError().text();
+        recordQuery("getAllFournisseurs", query, timer, 0, false);
         return list;
     }
     
+    // Delivery history is compressed as it streams in; only displayed rows expand it
+    ColdTextStore::Builder cold;
     while (query.next()) {
-        Fournisseur f(
-            query.value("ID_FOURNISSEUR").toInt(),
-            query.value("NOM").toString(),
-            query.value("ADRESSE").toString(),
-            query.value("EMAIL").toString(),
-            query.value("TELEPHONE").toString(),
-            query.value("TYPE_PRODUITS").toString(),
-            query.value("HISTORIQUE_LIVRAISONS").toString(),
-            query.value("IS_ACTIVE").toInt() == 1
-        );
+        Fournisseur f = readRow(query);
+        f.setHistoriqueLivraisons(cold.add(f.getHistoriqueLivraisons()));
         list.append(f);
     }
+    cold.finish();
     
     success = true;
+    recordQuery("getAllFournisseurs", query, timer, list.size(), true);
     return list;
 }
 
 QList<Fournisseur> DatabaseManager::searchFournisseurs(const QString& searchText, bool& success)
 {
+    TRACE_SCOPE("DatabaseManager::searchFournisseurs");
     QList<Fournisseur> list;
     success = false;
     
     if (!connected) return list;
     
+    if (engine) {
+        QElapsedTimer timer;
+        timer.start();
+        list = engine->search(searchText);
+        success = true;
+        metrics.record("searchFournisseurs", quint64(timer.nsecsElapsed()), list.size(), true);
+        return list;
+    }
+    
     QSqlQuery query(db);
-    query.prepare(R"(
-        SELECT * FROM FOURNISSEURS 
-        WHERE NOM LIKE :search 
-           OR EMAIL LIKE :search
-           OR TYPE_PRODUITS LIKE :search
-        ORDER BY ID_FOURNISSEUR
+    query.prepare(selectFournisseurs() + R"(
+        WHERE F.NOM LIKE :search 
+           OR F.EMAIL LIKE :search
+           OR T.LIBELLE LIKE :search
+        ORDER BY F.ID_FOURNISSEUR
     )");
     
     QString searchPattern = "%" + searchText + "%";
     query.bindValue(":search", searchPattern);
     
+    QElapsedTimer timer;
+    timer.start();
     if (!query.exec()) {
         lastError = query.lastError().text();
+        recordQuery("searchFournisseurs", query, timer, 0, false);
         return list;
     }
     
     while (query.next()) {
-        Fournisseur f(
-            query.value("ID_FOURNISSEUR").toInt(),
-            query.value("NOM").toString(),
-            query.value("ADRESSE").toString(),
-            query.value("EMAIL").toString(),
-            query.value("TELEPHONE").toString(),
-            query.value("TYPE_PRODUITS").toString(),
-            query.value("HISTORIQUE_LIVRAISONS").toString(),
-            query.value("IS_ACTIVE").toInt() == 1
-        );
-        list.append(f);
+        list.append(readRow(query));
     }
     
     success = true;
+    recordQuery("searchFournisseurs", query, timer, list.size(), true);
     return list;
 }
 
-int DatabaseManager::getTotalCount()
+bool DatabaseManager::forEachFournisseur(const std::function<bool(const Fournisseur&)>& visitor)
+{
+    TRACE_SCOPE("DatabaseManager::forEachFournisseur");
+    if (!connected) {
+        lastError = "Not connected to database";
+        return false;
+    }
+    
+    if (engine) {
+        QElapsedTimer timer;
+        timer.start();
+        qint64 rows = engine->forEach(visitor);
+        metrics.record("forEachFournisseur", quint64(timer.nsecsElapsed()), rows, true);
+        return true;
+    }
+    
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    QElapsedTimer timer;
+    timer.start();
+    if (!query.exec(selectFournisseurs() + " ORDER BY F.ID_FOURNISSEUR")) {
+        lastError = query.lastError().text();
+        recordQuery("forEachFournisseur", query, timer, 0, false);
+        return false;
+    }
+    
+    qint64 rows = 0;
+    while (query.next()) {
+        ++rows;
+        if (!visitor(readRow(query))) break;
+    }
+    
+    recordQuery("forEachFournisseur", query, timer, rows, true);
+    return true;
+}
+
+bool DatabaseManager::insertBatch(const QList<Fournisseur>& fournisseurs, bool preserveIds)
+{
+    TRACE_SCOPE("DatabaseManager::insertBatch");
+    if (!connected) {
+        lastError = "Not connected to database";
+        return false;
+    }
+    
+    if (engine) {
+        QElapsedTimer timer;
+        timer.start();
+        bool ok = engine->insertBatch(fournisseurs, preserveIds, lastError);
+        metrics.record("insertBatch", quint64(timer.nsecsElapsed()), ok ? fournisseurs.size() : 0, ok);
+        return ok;
+    }
+    
+    db.transaction();
+    
+    for (const Fournisseur& f : fournisseurs) {
+        if (!insertFournisseur(f, preserveIds)) {
+            db.rollback();
+            typeIds.clear();    // may hold types inserted by the rolled back transaction
+            return false;
+        }
+    }
+    
+    if (!db.commit()) {
+        lastError = db.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+QDateTime DatabaseManager::currentServerTime(bool& success)
+{
+    success = false;
+    if (!connected) return QDateTime();
+    
+    if (engine) {
+        success = true;
+        return engine->currentTime();
+    }
+    
+    QSqlQuery query(db);
+    QString sql = "SELECT " + nowExpression();
+    if (dbType == Oracle) sql += " FROM DUAL";
+    if (!query.exec(sql) || !query.next()) {
+        lastError = query.lastError().text();
+        return QDateTime();
+    }
+    success = true;
+    return readTimestamp(query.value(0));
+}
+
+bool DatabaseManager::fetchChangesSince(const QDateTime& since, ChangeSet& changes)
+{
+    TRACE_SCOPE("DatabaseManager::fetchChangesSince");
+    changes = ChangeSet();
+    if (!connected) {
+        lastError = "Not connected to database";
+        return false;
+    }
+    
+    if (engine) {
+        QElapsedTimer timer;
+        timer.start();
+        engine->changesSince(since, changes.upserts, changes.deletedIds, changes.serverTime);
+        metrics.record("fetchChangesSince", quint64(timer.nsecsElapsed()),
+                       changes.upserts.size() + changes.deletedIds.size(), true);
+        return true;
+    }
+    
+    // Read the clock first: anything committed after this is picked up next time
+    bool ok;
+    changes.serverTime = currentServerTime(ok);
+    if (!ok) return false;
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    QSqlQuery tombstones(db);
+    tombstones.setForwardOnly(true);
+    tombstones.prepare("SELECT ID_FOURNISSEUR, MAX(DATE_SUPPRESSION) FROM FOURNISSEURS_TOMBSTONES "
+                       "WHERE DATE_SUPPRESSION >= :since GROUP BY ID_FOURNISSEUR");
+    tombstones.bindValue(":since", timestampValue(since));
+    if (!tombstones.exec()) {
+        lastError = tombstones.lastError().text();
+        recordQuery("fetchChangesSince", tombstones, timer, 0, false);
+        return false;
+    }
+    QHash<int, QDateTime> deleted;
+    while (tombstones.next()) {
+        deleted.insert(tombstones.value(0).toInt(), readTimestamp(tombstones.value(1)));
+    }
+    
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare(selectFournisseurs() + " WHERE F.DATE_MODIFICATION >= :since "
+                  "ORDER BY F.ID_FOURNISSEUR");
+    query.bindValue(":since", timestampValue(since));
+    if (!query.exec()) {
+        lastError = query.lastError().text();
+        recordQuery("fetchChangesSince", query, timer, 0, false);
+        return false;
+    }
+    while (query.next()) {
+        Fournisseur f = readRow(query);
+        // Id deleted and re-inserted in the window: the latest event wins
+        auto tomb = deleted.find(f.getIdFournisseur());
+        if (tomb != deleted.end()) {
+            if (tomb.value() > readTimestamp(query.value("DATE_MODIFICATION"))) continue;
+            deleted.erase(tomb);
+        }
+        changes.upserts.append(f);
+    }
+    changes.deletedIds = deleted.keys();
+    
+    recordQuery("fetchChangesSince", query, timer,
+                changes.upserts.size() + changes.deletedIds.size(), true);
+    return true;
+}
+
+int DatabaseManager::purgeTombstones(const QDateTime& olderThan)
 {
     if (!connected) return 0;
+    if (engine) return engine->purgeTombstones(olderThan);
     
     QSqlQuery query(db);
-    if (query.exec("SELECT COUNT(*) FROM FOURNISSEURS") && query.next()) {
-        return query.value(0).toInt();
+    query.prepare("DELETE FROM FOURNISSEURS_TOMBSTONES WHERE DATE_SUPPRESSION < :before");
+    query.bindValue(":before", timestampValue(olderThan));
+    if (!query.exec()) {
+        lastError = query.lastError().text();
+        return 0;
     }
-    return 0;
+    return query.numRowsAffected();
+}
+
+int DatabaseManager::getTotalCount()
+{
+    TRACE_SCOPE("DatabaseManager::getTotalCount");
+    if (!connected) return 0;
+    if (engine) return engine->count();
+    
+    QSqlQuery query(db);
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = query.exec("SELECT COUNT(*) FROM FOURNISSEURS");
+    int count = (ok && query.next()) ? query.value(0).toInt() : 0;
+    recordQuery("getTotalCount", query, timer, 1, ok);
+    return count;
 }
 
 QMap<QString, int> DatabaseManager::getProductTypeDistribution()
 {
+    TRACE_SCOPE("DatabaseManager::getProductTypeDistribution");
     QMap<QString, int> distribution;
     
     if (!connected) return distribution;
+    if (engine) return engine->typeDistribution();
     
     QSqlQuery query(db);
-    if (query.exec("SELECT TYPE_PRODUITS, COUNT(*) as CNT FROM FOURNISSEURS GROUP BY TYPE_PRODUITS")) {
+    QElapsedTimer timer;
+    timer.start();
+    // Counted on the integer code; only the few resulting groups are joined to their label
+    bool ok = query.exec("SELECT T.LIBELLE, C.CNT FROM "
+                         "(SELECT ID_TYPE_PRODUIT, COUNT(*) AS CNT FROM FOURNISSEURS GROUP BY ID_TYPE_PRODUIT) C "
+                         "LEFT JOIN PRODUCT_TYPES T ON T.ID_TYPE = C.ID_TYPE_PRODUIT");
+    if (ok) {
         while (query.next()) {
             QString type = query.value(0).toString();
             int count = query.value(1).toInt();
-            distribution[type] = count;
+            distribution[type] += count;
         }
     }
+    recordQuery("getProductTypeDistribution", query, timer, distribution.size(), ok);
     
     return distribution;
 }
 
 bool DatabaseManager::importFromJson(const QList<Fournisseur>& fournisseurs)
 {
-    if (!connected) return false;
-    
-    db.transaction();
-    
-    for (const Fournisseur& f : fournisseurs) {
-        if (!insertFournisseur(f)) {
-            db.rollback();
-            return false;
-        }
-    }
-    
-    return db.commit();
+    TRACE_SCOPE("DatabaseManager::importFromJson");
+    return insertBatch(fournisseurs);
 }
 
 bool DatabaseManager::exportToJson(const QString& filename)
 {
-    bool success;
-    QList<Fournisseur> fournisseurs = getAllFournisseurs(success);
-    
-    if (!success) return false;
-    
-    QJsonArray jsonArray;
-    for (const Fournisseur& f : fournisseurs) {
-        jsonArray.append(f.toJson());
+    TRACE_SCOPE("DatabaseManager::exportToJson");
+    // Streamed from the cursor: no QList or JSON DOM of the whole table
+    JsonArrayWriter writer;
+    if (!writer.open(filename)) {
+        lastError = "Cannot write " + filename;
+        return false;
     }
     
-    QJsonDocument doc(jsonArray);
-    QFile file(filename);
-    
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(doc.toJson());
-        file.close();
+    bool success = forEachFournisseur([&writer](const Fournisseur& f) {
+        writer.write(f);
         return true;
-    }
-    
-    return false;
+    });
+    bool written = writer.close();
+    return success && written;
 }
 
 QString DatabaseManager::getDatabaseInfo()
@@ -391,7 +1069,12 @@ QString DatabaseManager::getDatabaseInfo()
     info += QString("✅ Search & Filter\n");
     info += QString("✅ Statistics\n");
     info += QString("✅ JSON Import/Export\n");
-    info += QString("✅ Professional SQL queries\n");
+    if (engine) {
+        info += QString("✅ Journal: %1 (%2 records)\n").arg(engine->journalPath())
+                                                        .arg(engine->journalRecords());
+    } else {
+        info += QString("✅ Professional SQL queries\n");
+    }
     
     return info;
 }
@@ -399,8 +1082,18 @@ QString DatabaseManager::getDatabaseInfo()
 bool DatabaseManager::dropTables()
 {
     if (!connected) return false;
+    if (engine) return engine->clear(lastError);
     
     QSqlQuery query(db);
+    typeIds.clear();
+    // Oracle has no IF EXISTS
+    if (dbType == Oracle) {
+        query.exec("DROP TABLE FOURNISSEURS_TOMBSTONES");
+        query.exec("DROP TABLE PRODUCT_TYPES");
+        return query.exec("DROP TABLE FOURNISSEURS");
+    }
+    query.exec("DROP TABLE IF EXISTS FOURNISSEURS_TOMBSTONES");
+    query.exec("DROP TABLE IF EXISTS PRODUCT_TYPES");
     return query.exec("DROP TABLE IF EXISTS FOURNISSEURS");
 }
 
@@ -6,11 +6,22 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QList>
+#include <QVariant>
+#include <QHash>
+#include <QDateTime>
+#include <QMetaType>
 #include "fournisseur.h"
+#include "querymetrics.h"
+#include <functional>
+#include <memory>
+
+class QElapsedTimer;
+class MemoryEngine;
 
 /**
  * Universal Database Manager
- * Supports: SQLite (default), Oracle, MySQL, PostgreSQL
+ * Supports: SQLite (default), Oracle, MySQL, PostgreSQL and an embedded
+ * in-memory engine (journaled to a file, no SQL layer)
  * 
  * Teacher will be impressed: Professional multi-database support!
  */
@@ -21,7 +32,8 @@ public:
         SQLite,      // No installation needed! Perfect for macOS
         Oracle,      // For when Docker/Oracle is available
         MySQL,       // Alternative option
-        PostgreSQL   // Another alternative
+        PostgreSQL,  // Another alternative
+        InMemory     // MemoryEngine: the database name is its journal file
     };
 
 private:
@@ -29,34 +41,81 @@ private:
     bool connected;
     QString lastError;
     DatabaseType dbType;
+    QString connectionName;     // empty = Qt's default connection
+    QueryMetrics metrics;
+    std::shared_ptr<MemoryEngine> engine;   // InMemory only
+    
+    QHash<QString, int> typeIds;  // PRODUCT_TYPES cache: label -> ID_TYPE
+    
+    bool createProductTypes();
+    bool createContactIndexes();
+    bool createSyncTables();
+    bool productTypeId(const QString& label, QVariant& id);
+    QString nowExpression() const;
+    QVariant timestampValue(const QDateTime& utc) const;
+    static QDateTime readTimestamp(const QVariant& value);
+    static QVariant telephoneKey(const Fournisseur& f);
+    static QString selectFournisseurs();
+    static Fournisseur readRow(const QSqlQuery& query);
+    
+    // Latency / row / error accounting; slow statements get their plan logged
+    void recordQuery(const QString& label, QSqlQuery& query,
+                     const QElapsedTimer& timer, qint64 rows, bool ok);
+    QStringList explainQuery(const QString& sql, const QVariantList& params);
 
 public:
-    DatabaseManager(DatabaseType type = SQLite);
+    // Rows changed since a point in time, for incremental refresh
+    struct ChangeSet {
+        QList<Fournisseur> upserts;     // inserted or updated, current values
+        QList<int> deletedIds;
+        QDateTime serverTime;           // database clock (UTC) when the fetch started
+    };
+    
+    // A distinct connectionName lets several managers be open at once (migration)
+    DatabaseManager(DatabaseType type = SQLite, const QString& connectionName = QString());
     ~DatabaseManager();
     
-    // Connection Management
+    // Connection Management (InMemory: dbName is the journal, ":memory:" for none)
     bool connectToDatabase(const QString& dbName = "fournisseurs.db");
     bool connectToOracle(const QString& host, int port, const QString& sid,
                         const QString& username, const QString& password);
     
+    // Second connection to the same database (e.g. for a worker thread);
+    // requires a connectionName and the same DatabaseType as the source
+    bool connectLike(const QString& sourceConnection);
+    
     bool isConnected() const { return connected; }
+    QString getConnectionName() const;
     void disconnect();
     QString getLastError() const { return lastError; }
     QString getDatabaseType() const;
+    DatabaseType getType() const { return dbType; }
     
     // Database Operations
     bool createTables();
     bool dropTables();
     
     // CRUD Operations
-    bool insertFournisseur(const Fournisseur& f);
+    // Without preserveId the backend picks the id; newId receives it either way
+    bool insertFournisseur(const Fournisseur& f, bool preserveId = false, int* newId = nullptr);
     bool updateFournisseur(const Fournisseur& f);
     bool deleteFournisseur(int id);
     Fournisseur getFournisseurById(int id, bool& success);
     QList<Fournisseur> getAllFournisseurs(bool& success);
     QList<Fournisseur> searchFournisseurs(const QString& searchText, bool& success);
     
-    // Statistics
+    // Streaming: rows are read with a forward-only cursor and never collected.
+    // The visitor returns false to stop early.
+    bool forEachFournisseur(const std::function<bool(const Fournisseur&)>& visitor);
+    // One transaction for the whole batch, rolled back on the first failure
+    bool insertBatch(const QList<Fournisseur>& fournisseurs, bool preserveIds = false);
+    
+    // Delta sync: DATE_MODIFICATION (indexed) for upserts, FOURNISSEURS_TOMBSTONES for deletes
+    QDateTime currentServerTime(bool& success);
+    bool fetchChangesSince(const QDateTime& since, ChangeSet& changes);
+    int purgeTombstones(const QDateTime& olderThan);
+    
+    // Statistics (grouped on ID_TYPE_PRODUIT, labels joined afterwards)
     int getTotalCount();
     QMap<QString, int> getProductTypeDistribution();
     
@@ -64,9 +123,16 @@ public:
     bool importFromJson(const QList<Fournisseur>& fournisseurs);
     bool exportToJson(const QString& filename);
     
+    // Diagnostics
+    QueryMetrics& getMetrics() { return metrics; }
+    bool dumpMetrics(const QString& filename) const { return metrics.dumpToFile(filename); }
+    
     // Demo for teacher!
     QString getDatabaseInfo();
 };
 
+// Delivered across threads by the delta sync poller
+Q_DECLARE_METATYPE(DatabaseManager::ChangeSet)
+
 #endif // DATABASEMANAGER_H
 
@@ -0,0 +1,186 @@
+#include "datasetgenerator.h"
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QJsonObject>
+
+namespace {
+
+const char* const NamePrefixes[] = {
+    "Tech", "Food", "Textile", "Build", "Medi", "Agri", "Auto", "Eco", "Pharma",
+    "Nova", "Euro", "Atlas", "Delta", "Sigma", "Prime", "Global", "Metro", "Alpha"
+};
+const char* const NameSuffixes[] = {
+    "Supply", "Master", "Pro", "Mat", "Care", "Tech", "Parts", "Logistics",
+    "Distribution", "Services", "Trading", "Industries", "Solutions", "Group"
+};
+const char* const LegalForms[] = {
+    "SARL", "SA", "Corp", "International", "SAS", "& Fils", "Ltd"
+};
+const char* const Streets[] = {
+    "Avenue de Paris", "Rue du Commerce", "Boulevard Haussmann", "Rue Industrie",
+    "Avenue Habib Bourguiba", "Rue de la République", "Zone Industrielle", "Rue Victor Hugo"
+};
+const char* const Cities[] = {
+    "Paris", "Lyon", "Marseille", "Toulouse", "Lille", "Bordeaux", "Nantes",
+    "Tunis", "Sfax", "Sousse", "Casablanca", "Bruxelles", "Genève"
+};
+const char* const TypeLabels[] = {
+    "Électronique et Informatique", "Produits Alimentaires", "Textile et Mode",
+    "Matériaux de Construction", "Fournitures Médicales", "Équipement Agricole",
+    "Pièces Automobiles", "Produits Chimiques", "Mobilier de Bureau", "Emballage"
+};
+const char* const Domains[] = { "fr", "com", "tn", "net", "eu" };
+const char* const Actions[] = { "ADD", "MODIFY", "DELETE", "FILTER", "IMPORT_CSV", "EXPORT_CSV", "RATE" };
+
+template <typename T, int N>
+constexpr int countOf(T (&)[N]) { return N; }
+
+} // namespace
+
+DatasetGenerator::DatasetGenerator(quint32 seed)
+    : rng(seed)
+{
+}
+
+int DatasetGenerator::skewedScore()
+{
+    // Rough real-world shape: few 1-2 star, most 3-4, a good share of 5
+    static const int weights[] = { 4, 8, 25, 38, 25 };
+    int roll = rng.bounded(100);
+    for (int score = 1; score <= 5; ++score) {
+        roll -= weights[score - 1];
+        if (roll < 0) return score;
+    }
+    return 5;
+}
+
+Fournisseur DatasetGenerator::makeFournisseur(int id)
+{
+    QString prefix = NamePrefixes[rng.bounded(countOf(NamePrefixes))];
+    QString suffix = NameSuffixes[rng.bounded(countOf(NameSuffixes))];
+    QString nom = QString("%1%2 %3").arg(prefix, suffix,
+                                         QString(LegalForms[rng.bounded(countOf(LegalForms))]));
+
+    QString city = Cities[rng.bounded(countOf(Cities))];
+    QString adresse = QString("%1 %2 %3 %4")
+        .arg(rng.bounded(1, 300))
+        .arg(Streets[rng.bounded(countOf(Streets))])
+        .arg(rng.bounded(10000, 99999))
+        .arg(city);
+
+    // Unique per id so generated rows never trip the contact indexes
+    QString email = QString("contact%1@%2%3.%4")
+        .arg(id)
+        .arg(prefix.toLower(), suffix.toLower(), QString(Domains[rng.bounded(countOf(Domains))]));
+    QString telephone = QString("+331%1").arg(id, 8, 10, QChar('0'));
+
+    int livraisons = rng.bounded(1, 500);
+    QString historique = QString("%1 livraisons - Moyenne %2 jours")
+        .arg(livraisons)
+        .arg(rng.bounded(1, 15));
+
+    bool active = rng.bounded(100) < 88;
+    return Fournisseur(id, nom, adresse, email, telephone,
+                       TypeLabels[rng.bounded(countOf(TypeLabels))],
+                       historique, active);
+}
+
+QList<Fournisseur> DatasetGenerator::generate(int count, int firstId)
+{
+    QList<Fournisseur> fournisseurs;
+    fournisseurs.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        fournisseurs.append(makeFournisseur(firstId + i));
+    }
+    return fournisseurs;
+}
+
+QList<SupplierRating> DatasetGenerator::generateRatings(const QList<Fournisseur>& fournisseurs,
+                                                        double ratedFraction)
+{
+    QList<SupplierRating> ratings;
+    ratings.reserve(int(fournisseurs.size() * ratedFraction) + 1);
+
+    for (const Fournisseur& f : fournisseurs) {
+        if (rng.generateDouble() >= ratedFraction) continue;
+
+        SupplierRating rating(f.getIdFournisseur(), skewedScore(), skewedScore(),
+                              skewedScore(), skewedScore());
+        int orders = rng.bounded(1, 400);
+        rating.setTotalOrders(orders);
+        rating.setOnTimeDeliveries(orders - rng.bounded(orders / 4 + 1));
+        rating.setAverageDeliveryTime(1.0 + rng.generateDouble() * 12.0);
+        ratings.append(rating);
+    }
+    return ratings;
+}
+
+QList<ActivityLog> DatasetGenerator::generateActivities(int count, int maxSupplierId, int days)
+{
+    QList<ActivityLog> activities;
+    activities.reserve(count);
+
+    QDateTime start = QDateTime::currentDateTime().addDays(-days);
+    qint64 spanSecs = qint64(days) * 86400;
+    for (int i = 0; i < count; ++i) {
+        QJsonObject json;
+        QString action = Actions[rng.bounded(countOf(Actions))];
+        json["action"] = action;
+        json["description"] = QString("%1 généré #%2").arg(action).arg(i);
+        json["timestamp"] = start.addSecs(spanSecs * i / qMax(1, count)).toString(Qt::ISODate);
+        json["userName"] = "Admin";
+        json["fournisseurId"] = maxSupplierId > 0 ? int(rng.bounded(1, maxSupplierId + 1)) : -1;
+        activities.append(ActivityLog::fromJson(json));
+    }
+    return activities;
+}
+
+QVector<DeliveryEvent> DatasetGenerator::generateDeliveries(int supplierCount, int perSupplier, int days)
+{
+    QVector<DeliveryEvent> events;
+    events.reserve(qint64(supplierCount) * perSupplier);
+
+    QDate start = QDate::currentDate().addDays(-days);
+    for (int id = 1; id <= supplierCount; ++id) {
+        for (int i = 0; i < perSupplier; ++i) {
+            DeliveryEvent event;
+            event.fournisseurId = id;
+            event.orderDate = start.addDays(qint64(days) * i / qMax(1, perSupplier));
+            event.promisedDate = event.orderDate.addDays(rng.bounded(2, 15));
+            int roll = rng.bounded(100);
+            if (roll < 80) {
+                event.actualDate = event.orderDate.addDays(rng.bounded(1, int(event.orderDate.daysTo(event.promisedDate)) + 1));
+            } else if (roll < 95) {
+                event.actualDate = event.promisedDate.addDays(rng.bounded(1, 10));
+            }
+            event.quantity = rng.bounded(1, 500);
+            events.append(event);
+        }
+    }
+    return events;
+}
+
+bool DatasetGenerator::writeCSV(const QString& fileName, int count)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "ID,Nom,Adresse,Email,Telephone,TypeProduits,HistoriqueLivraisons\n";
+    for (int id = 1; id <= count; ++id) {
+        Fournisseur f = makeFournisseur(id);
+        out << f.getIdFournisseur() << ","
+            << CSVManager::escapeCSV(f.getNom()) << ","
+            << CSVManager::escapeCSV(f.getAdresse()) << ","
+            << CSVManager::escapeCSV(f.getEmail()) << ","
+            << CSVManager::escapeCSV(f.getTelephone()) << ","
+            << CSVManager::escapeCSV(f.getTypeProduits()) << ","
+            << CSVManager::escapeCSV(f.getHistoriqueLivraisons()) << "\n";
+    }
+
+    file.close();
+    return true;
+}
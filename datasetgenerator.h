@@ -0,0 +1,46 @@
+#ifndef DATASETGENERATOR_H
+#define DATASETGENERATOR_H
+
+#include <QString>
+#include <QList>
+#include <QRandomGenerator>
+#include "fournisseur.h"
+#include "advancedfeatures.h"
+#include "deliverystore.h"
+
+/**
+ * Deterministic synthetic supplier data
+ * Produces sample_fournisseurs.csv-style rows at any scale (10k .. 10M):
+ * same seed + same count = same dataset, so benchmark runs are comparable.
+ * Emails and phones are unique per id (they satisfy the contact indexes).
+ */
+class DatasetGenerator
+{
+private:
+    QRandomGenerator rng;
+
+public:
+    explicit DatasetGenerator(quint32 seed = 20251019);
+
+    Fournisseur makeFournisseur(int id);
+    QList<Fournisseur> generate(int count, int firstId = 1);
+
+    // About 'ratedFraction' of suppliers get a rating, skewed towards 3-5 stars
+    QList<SupplierRating> generateRatings(const QList<Fournisseur>& fournisseurs,
+                                          double ratedFraction = 0.6);
+
+    // Activity spread over the last 'days' days, in chronological order
+    QList<ActivityLog> generateActivities(int count, int maxSupplierId, int days = 365);
+
+    // 'perSupplier' orders for each of suppliers 1..supplierCount over the last 'days' days;
+    // about 80% on time, 5% still pending
+    QVector<DeliveryEvent> generateDeliveries(int supplierCount, int perSupplier, int days = 730);
+
+    // Streams rows straight to disk (no list in memory), for the 10M case
+    bool writeCSV(const QString& fileName, int count);
+
+private:
+    int skewedScore();
+};
+
+#endif // DATASETGENERATOR_H
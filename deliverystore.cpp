@@ -0,0 +1,525 @@
+#include "deliverystore.h"
+#include "tracing.h"
+#include <QFile>
+#include <QDataStream>
+#include <QDebug>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <limits>
+
+namespace {
+const quint32 FileMagic = 0x46444C56;     // "FDLV"
+const quint16 FileVersion = 2;          // 1: snapshot only
+enum Record : quint8 { EventRecord = 1, DeliveredRecord = 2 };
+
+bool fitsLead(qint64 days)
+{
+    return days > std::numeric_limits<qint16>::min() && days <= std::numeric_limits<qint16>::max();
+}
+}
+
+// ===== DeliveryMetrics Implementation =====
+void DeliveryMetrics::merge(const DeliveryMetrics& other)
+{
+    orders += other.orders;
+    delivered += other.delivered;
+    onTime += other.onTime;
+    quantity += other.quantity;
+    deliveryDays += other.deliveryDays;
+}
+
+// ===== DeliveryEventStore Implementation =====
+DeliveryEventStore::DeliveryEventStore()
+    : totalEvents(0), replayed(0)
+{
+}
+
+bool DeliveryEventStore::append(const DeliveryEvent& event)
+{
+    if (!event.orderDate.isValid() || !event.promisedDate.isValid()) {
+        lastError = "date de commande ou date promise invalide";
+        return false;
+    }
+    qint64 day = event.orderDate.toJulianDay();
+    qint64 promised = event.promisedDate.toJulianDay() - day;
+    qint64 actual = event.actualDate.isValid() ? event.actualDate.toJulianDay() - day : 0;
+    if (!fitsLead(promised) || !fitsLead(actual)) {
+        lastError = "délai hors limites (plus de 89 ans)";
+        return false;
+    }
+
+    auto existing = series.constFind(event.fournisseurId);
+    int count = existing != series.constEnd() ? existing->orderGap.size() : 0;
+    qint64 gap = count > 0 ? day - existing->lastDay : 0;
+    if (gap < 0 && day < existing->blockStart.last()) {
+        lastError = QString("événement antérieur au dernier bloc du fournisseur %1").arg(event.fournisseurId);
+        return false;
+    }
+    bool newBlock = count % BlockEvents == 0;
+    if (!newBlock && gap > std::numeric_limits<quint16>::max()) {
+        lastError = "écart entre deux commandes trop grand";
+        return false;
+    }
+
+    Series& s = series[event.fournisseurId];
+    qint16 actualLead = event.actualDate.isValid() ? qint16(actual) : NotDelivered;
+    if (gap < 0) {
+        insertLate(s, day, qint16(promised), actualLead, event.quantity);
+    } else {
+        if (newBlock) {
+            s.blockStart.append(qint32(day));
+            gap = 0;
+        }
+        s.orderGap.append(quint16(gap));
+        s.promisedLead.append(qint16(promised));
+        s.actualLead.append(actualLead);
+        s.quantity.append(event.quantity);
+        s.lastDay = qint32(day);
+    }
+
+    s.totals.orders++;
+    s.totals.quantity += event.quantity;
+    if (event.actualDate.isValid()) countDelivery(s, promised, actual);
+    totalEvents++;
+    return true;
+}
+
+void DeliveryEventStore::insertLate(Series& s, qint64 day, qint16 promised, qint16 actual, qint32 quantity)
+{
+    // Decode the last block, insert after the orders of the same day, re-encode its gaps
+    int first = (int(s.blockStart.size()) - 1) * BlockEvents;
+    int end = s.orderGap.size();
+    QVector<qint64> days;
+    days.reserve(end - first + 1);
+    qint64 current = s.blockStart.last();
+    for (int i = first; i < end; ++i) {
+        if (i > first) current += s.orderGap[i];
+        days.append(current);
+    }
+    int at = int(std::upper_bound(days.begin(), days.end(), day) - days.begin());
+    days.insert(at, day);
+
+    s.orderGap.insert(first + at, 0);
+    s.promisedLead.insert(first + at, promised);
+    s.actualLead.insert(first + at, actual);
+    s.quantity.insert(first + at, quantity);
+    for (int i = 1; i < days.size(); ++i) {
+        s.orderGap[first + i] = quint16(days[i] - days[i - 1]);   // a split gap still fits
+    }
+
+    // A full block hands its last order (lastDay) to a new one
+    if (days.size() > BlockEvents) {
+        s.orderGap[first + BlockEvents] = 0;
+        s.blockStart.append(qint32(days.last()));
+    }
+}
+
+void DeliveryEventStore::countDelivery(Series& s, qint64 promised, qint64 actual)
+{
+    s.totals.delivered++;
+    s.totals.deliveryDays += actual;
+    if (actual <= promised) s.totals.onTime++;
+    s.leadTime.add(double(actual));
+}
+
+qint64 DeliveryEventStore::orderDay(const Series& s, int index)
+{
+    int block = index / BlockEvents;
+    qint64 day = s.blockStart[block];
+    for (int i = block * BlockEvents + 1; i <= index; ++i) day += s.orderGap[i];
+    return day;
+}
+
+bool DeliveryEventStore::markDelivered(int fournisseurId, int index, const QDate& actualDate)
+{
+    auto it = series.find(fournisseurId);
+    if (it == series.end() || index < 0 || index >= it->orderGap.size()) {
+        lastError = QString("commande %1 inconnue pour le fournisseur %2").arg(index).arg(fournisseurId);
+        return false;
+    }
+    Series& s = *it;
+    if (s.actualLead[index] != NotDelivered) {
+        lastError = "commande déjà livrée";
+        return false;
+    }
+    if (!actualDate.isValid()) {
+        lastError = "date de livraison invalide";
+        return false;
+    }
+    qint64 actual = actualDate.toJulianDay() - orderDay(s, index);
+    if (!fitsLead(actual)) {
+        lastError = "délai hors limites (plus de 89 ans)";
+        return false;
+    }
+
+    s.actualLead[index] = qint16(actual);
+    countDelivery(s, s.promisedLead[index], actual);
+    return true;
+}
+
+int DeliveryEventStore::appendAll(QVector<DeliveryEvent> events)
+{
+    TRACE_SCOPE("DeliveryEventStore::appendAll");
+    std::stable_sort(events.begin(), events.end(), [](const DeliveryEvent& a, const DeliveryEvent& b) {
+        return a.orderDate < b.orderDate;
+    });
+    int stored = 0;
+    for (const DeliveryEvent& event : events) {
+        if (append(event)) stored++;
+    }
+    // Drop the sketches' insert buffers, up to 400 values per supplier
+    for (Series& s : series) s.leadTime.compress();
+    return stored;
+}
+
+int DeliveryEventStore::lowerBound(const Series& s, qint64 day)
+{
+    // The block before the first one starting at or after 'day' may still hold it
+    auto block = std::lower_bound(s.blockStart.constBegin(), s.blockStart.constEnd(), day);
+    if (block == s.blockStart.constBegin()) return 0;
+    int b = int(block - s.blockStart.constBegin()) - 1;
+
+    int i = b * BlockEvents;
+    int end = qMin(int(s.orderGap.size()), i + BlockEvents);
+    qint64 current = s.blockStart[b];
+    for (++i; i < end; ++i) {
+        current += s.orderGap[i];
+        if (current >= day) return i;
+    }
+    return end;
+}
+
+DeliveryMetrics DeliveryEventStore::scan(const Series& s, int begin, int end)
+{
+    // No branches in the loop: every event adds 0 or 1 to each counter
+    const qint16 *promised = s.promisedLead.constData();
+    const qint16 *actual = s.actualLead.constData();
+    const qint32 *quantity = s.quantity.constData();
+    int delivered = 0;
+    int onTime = 0;
+    qint64 days = 0;
+    qint64 units = 0;
+    for (int i = begin; i < end; ++i) {
+        int a = actual[i];
+        int done = a != NotDelivered;
+        delivered += done;
+        onTime += done & int(a <= promised[i]);
+        days += done * a;
+        units += quantity[i];
+    }
+
+    DeliveryMetrics m;
+    m.orders = end - begin;
+    m.delivered = delivered;
+    m.onTime = onTime;
+    m.deliveryDays = days;
+    m.quantity = units;
+    return m;
+}
+
+DeliveryMetrics DeliveryEventStore::metrics(int fournisseurId) const
+{
+    auto it = series.constFind(fournisseurId);
+    return it != series.constEnd() ? it->totals : DeliveryMetrics();
+}
+
+DeliveryMetrics DeliveryEventStore::metrics(int fournisseurId, const QDate& from, const QDate& to) const
+{
+    auto it = series.constFind(fournisseurId);
+    if (it == series.constEnd()) return DeliveryMetrics();
+    int begin = from.isValid() ? lowerBound(*it, from.toJulianDay()) : 0;
+    int end = to.isValid() ? lowerBound(*it, to.toJulianDay() + 1) : it->orderGap.size();
+    return begin < end ? scan(*it, begin, end) : DeliveryMetrics();
+}
+
+DeliveryMetrics DeliveryEventStore::metricsAll(const QDate& from, const QDate& to) const
+{
+    TRACE_SCOPE("DeliveryEventStore::metricsAll");
+    DeliveryMetrics all;
+    for (auto it = series.constBegin(); it != series.constEnd(); ++it) {
+        all.merge(from.isValid() || to.isValid() ? metrics(it.key(), from, to) : it->totals);
+    }
+    return all;
+}
+
+const TDigest& DeliveryEventStore::leadTimes(int fournisseurId) const
+{
+    static const TDigest empty(LeadTimeCompression);
+    auto it = series.constFind(fournisseurId);
+    return it != series.constEnd() ? it->leadTime : empty;
+}
+
+QHash<quint32, TDigest> DeliveryEventStore::leadTimesByGroup(const QHash<int, quint32>& groupOf) const
+{
+    TRACE_SCOPE("DeliveryEventStore::leadTimesByGroup");
+    struct Shard {
+        QVector<const Series*> members;
+        QVector<quint32> groups;
+        QHash<quint32, TDigest> digests;
+    };
+
+    // Round-robin shards, each merged on its own core, then the shards merged together
+    int shardCount = qMax(1, QThread::idealThreadCount());
+    QVector<Shard> shards(shardCount);
+    int next = 0;
+    for (auto it = series.constBegin(); it != series.constEnd(); ++it) {
+        auto group = groupOf.constFind(it.key());
+        if (group == groupOf.constEnd() || it->leadTime.isEmpty()) continue;
+        Shard& shard = shards[next++ % shardCount];
+        shard.members.append(&*it);
+        shard.groups.append(*group);
+    }
+
+    QtConcurrent::blockingMap(shards, [](Shard& shard) {
+        for (int i = 0; i < shard.members.size(); ++i) {
+            const TDigest& digest = shard.members[i]->leadTime;
+            auto target = shard.digests.find(shard.groups[i]);
+            if (target == shard.digests.end()) target = shard.digests.insert(shard.groups[i], TDigest(LeadTimeCompression));
+            target->merge(digest);
+        }
+    });
+
+    QHash<quint32, TDigest> merged;
+    TDigest all(LeadTimeCompression);
+    for (const Shard& shard : shards) {
+        for (auto it = shard.digests.constBegin(); it != shard.digests.constEnd(); ++it) {
+            auto target = merged.find(it.key());
+            if (target == merged.end()) target = merged.insert(it.key(), TDigest(LeadTimeCompression));
+            target->merge(*it);
+            all.merge(*it);
+        }
+    }
+    for (TDigest& digest : merged) digest.compress();
+    all.compress();
+    merged.insert(AllGroups, all);
+    return merged;
+}
+
+void DeliveryEventStore::rebuildLeadTimes(Series& s)
+{
+    s.leadTime = TDigest(LeadTimeCompression);
+    for (qint16 lead : s.actualLead) {
+        if (lead != NotDelivered) s.leadTime.add(double(lead));
+    }
+    s.leadTime.compress();
+}
+
+QVector<DeliveryEvent> DeliveryEventStore::events(int fournisseurId) const
+{
+    QVector<DeliveryEvent> decoded;
+    auto it = series.constFind(fournisseurId);
+    if (it == series.constEnd()) return decoded;
+
+    const Series& s = *it;
+    decoded.reserve(s.orderGap.size());
+    qint64 day = 0;
+    for (int i = 0; i < s.orderGap.size(); ++i) {
+        day = i % BlockEvents == 0 ? s.blockStart[i / BlockEvents] : day + s.orderGap[i];
+        DeliveryEvent event;
+        event.fournisseurId = fournisseurId;
+        event.orderDate = QDate::fromJulianDay(day);
+        event.promisedDate = QDate::fromJulianDay(day + s.promisedLead[i]);
+        if (s.actualLead[i] != NotDelivered) event.actualDate = QDate::fromJulianDay(day + s.actualLead[i]);
+        event.quantity = s.quantity[i];
+        decoded.append(event);
+    }
+    return decoded;
+}
+
+QString DeliveryEventStore::summary(int fournisseurId) const
+{
+    DeliveryMetrics m = metrics(fournisseurId);
+    QString text = QString("%1 livraisons - Moyenne %2 jours - %3% à l'heure")
+        .arg(m.delivered)
+        .arg(m.averageDeliveryTime(), 0, 'f', 1)
+        .arg(m.onTimePercentage(), 0, 'f', 0);
+    if (m.orders > m.delivered) text += QString(" - %1 en cours").arg(m.orders - m.delivered);
+    return text;
+}
+
+qint64 DeliveryEventStore::memoryUsage() const
+{
+    qint64 bytes = qint64(series.capacity()) * qint64(sizeof(Series) + sizeof(int) + sizeof(void*));
+    for (const Series& s : series) {
+        bytes += s.blockStart.capacity() * qint64(sizeof(qint32)) +
+                 s.orderGap.capacity() * qint64(sizeof(quint16)) +
+                 s.promisedLead.capacity() * qint64(sizeof(qint16)) +
+                 s.actualLead.capacity() * qint64(sizeof(qint16)) +
+                 s.quantity.capacity() * qint64(sizeof(qint32)) +
+                 s.leadTime.memoryUsage() - qint64(sizeof(TDigest));
+    }
+    return bytes;
+}
+
+void DeliveryEventStore::clear()
+{
+    series.clear();
+    totalEvents = 0;
+}
+
+bool DeliveryEventStore::saveToFile(const QString& fileName) const
+{
+    TRACE_SCOPE("DeliveryEventStore::saveToFile");
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        lastError = "écriture impossible: " + fileName;
+        return false;
+    }
+
+    // The columns as they are in memory: loading needs no re-encoding
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << FileMagic << FileVersion << qint32(series.size());
+    for (auto it = series.constBegin(); it != series.constEnd(); ++it) {
+        const Series& s = *it;
+        out << qint32(it.key()) << s.lastDay << s.blockStart << s.orderGap
+            << s.promisedLead << s.actualLead << s.quantity;
+    }
+
+    file.close();
+    if (out.status() != QDataStream::Ok || file.error() != QFileDevice::NoError) {
+        lastError = "erreur d'écriture: " + fileName;
+        return false;
+    }
+    return true;
+}
+
+bool DeliveryEventStore::appendToFile(const QString& fileName, const DeliveryEvent& event) const
+{
+    QByteArray record;
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << quint8(EventRecord) << qint32(event.fournisseurId) << event.orderDate
+        << event.promisedDate << event.actualDate << qint32(event.quantity);
+    return appendRecord(fileName, record);
+}
+
+bool DeliveryEventStore::appendDeliveredToFile(const QString& fileName, int fournisseurId, int index,
+                                               const QDate& actualDate) const
+{
+    QByteArray record;
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << quint8(DeliveredRecord) << qint32(fournisseurId) << qint32(index) << actualDate;
+    return appendRecord(fileName, record);
+}
+
+bool DeliveryEventStore::appendRecord(const QString& fileName, const QByteArray& record) const
+{
+    // The change is already in memory: a missing or older file simply gets a full snapshot
+    QFile file(fileName);
+    if (!file.exists()) return saveToFile(fileName);
+    if (!file.open(QIODevice::ReadWrite)) {
+        lastError = "écriture impossible: " + fileName;
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != FileMagic || version != FileVersion) {
+        file.close();
+        return saveToFile(fileName);
+    }
+
+    if (!file.seek(file.size()) || file.write(record) != record.size() || !file.flush()) {
+        lastError = "erreur d'écriture: " + fileName;
+        return false;
+    }
+    return true;
+}
+
+bool DeliveryEventStore::loadFromFile(const QString& fileName)
+{
+    TRACE_SCOPE("DeliveryEventStore::loadFromFile");
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        lastError = "lecture impossible: " + fileName;
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint16 version = 0;
+    qint32 count = 0;
+    in >> magic >> version >> count;
+    if (magic != FileMagic || (version != 1 && version != FileVersion) || count < 0) {
+        lastError = "format de fichier inconnu: " + fileName;
+        return false;
+    }
+
+    // Read into a fresh table: a damaged file leaves the current data untouched
+    QHash<int, Series> loaded;
+    QVector<Series*> digests;
+    qint64 events = 0;
+    loaded.reserve(count);
+    for (qint32 n = 0; n < count && in.status() == QDataStream::Ok; ++n) {
+        qint32 id;
+        Series s;
+        in >> id >> s.lastDay >> s.blockStart >> s.orderGap >> s.promisedLead >> s.actualLead >> s.quantity;
+        int size = s.orderGap.size();
+        if (s.promisedLead.size() != size || s.actualLead.size() != size || s.quantity.size() != size ||
+            s.blockStart.size() != (size + BlockEvents - 1) / BlockEvents) {
+            lastError = "fichier corrompu: " + fileName;
+            return false;
+        }
+        s.totals = scan(s, 0, size);
+        events += size;
+        loaded.insert(id, s);
+    }
+    if (in.status() != QDataStream::Ok) {
+        lastError = "fichier tronqué: " + fileName;
+        return false;
+    }
+
+    // Changes recorded after the snapshot, replayed in order; an unreadable tail
+    // (a write cut short) is dropped from the file so appends resume after the last good one
+    DeliveryEventStore result;
+    result.series = std::move(loaded);
+    result.totalEvents = events;
+    int records = 0;
+    if (version >= 2) {
+        qint64 goodEnd = file.pos();
+        while (!in.atEnd()) {
+            quint8 kind = 0;
+            qint32 id = 0;
+            bool applied = false;
+            in >> kind >> id;
+            if (kind == EventRecord) {
+                DeliveryEvent event;
+                qint32 quantity = 0;
+                in >> event.orderDate >> event.promisedDate >> event.actualDate >> quantity;
+                event.fournisseurId = id;
+                event.quantity = quantity;
+                applied = in.status() == QDataStream::Ok && result.append(event);
+            } else if (kind == DeliveredRecord) {
+                qint32 index = 0;
+                QDate actual;
+                in >> index >> actual;
+                applied = in.status() == QDataStream::Ok && result.markDelivered(id, index, actual);
+            }
+            if (!applied) break;
+            goodEnd = file.pos();
+            records++;
+        }
+        if (goodEnd < file.size()) {
+            qint64 size = file.size();
+            file.close();
+            qWarning() << "⚠️ Livraisons tronquées:" << size - goodEnd << "octets ignorés dans" << fileName;
+            QFile::resize(fileName, goodEnd);
+        }
+    }
+
+    // Sketches are not saved: rebuilding them is one pass per supplier, on all cores
+    digests.reserve(result.series.size());
+    for (Series& s : result.series) digests.append(&s);
+    QtConcurrent::blockingMap(digests, [](Series *s) { rebuildLeadTimes(*s); });
+
+    series = std::move(result.series);
+    totalEvents = result.totalEvents;
+    replayed = records;
+    return true;
+}
@@ -0,0 +1,127 @@
+#ifndef DELIVERYSTORE_H
+#define DELIVERYSTORE_H
+
+#include <QString>
+#include <QDate>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include "tdigest.h"
+
+// One order of a supplier and, once it arrived, its delivery
+struct DeliveryEvent
+{
+    int fournisseurId = 0;
+    QDate orderDate;
+    QDate promisedDate;
+    QDate actualDate;           // invalid while the order is pending
+    int quantity = 0;
+};
+
+// Aggregates over a set of events; pending orders only count in 'orders'
+struct DeliveryMetrics
+{
+    int orders = 0;
+    int delivered = 0;
+    int onTime = 0;             // delivered on or before the promised date
+    qint64 quantity = 0;
+    qint64 deliveryDays = 0;    // sum of (actual - order) over delivered events
+
+    double onTimePercentage() const { return delivered > 0 ? onTime * 100.0 / delivered : 0.0; }
+    double averageDeliveryTime() const { return delivered > 0 ? double(deliveryDays) / delivered : 0.0; }
+    void merge(const DeliveryMetrics& other);
+};
+
+/**
+ * Delivery event time series, one per supplier
+ *
+ * Columnar and in order date order: for each event the order date is a
+ * 16-bit gap from the previous one (blocks of BlockEvents keep an absolute
+ * date to seek), promised and actual dates are 16-bit offsets from the
+ * order date, plus the quantity: 10 bytes per event instead of a ~100 byte
+ * struct. Only the last block of a supplier is ever re-encoded: an order
+ * that arrives late is inserted there, and a pending order can be marked
+ * delivered in place.
+ * Window metrics run as one branch-free pass over contiguous arrays, which
+ * the compiler vectorizes; whole-history metrics are kept up to date at
+ * append and cost nothing, and so is a t-digest of each supplier's lead
+ * times (actual - order) for p50 / p90 / p99 without sorting the events.
+ */
+class DeliveryEventStore
+{
+public:
+    static const int BlockEvents = 1024;
+
+    DeliveryEventStore();
+
+    // Orders older than the supplier's last block are refused; false (see getLastError)
+    bool append(const DeliveryEvent& event);
+    // Pending order 'index' (its position in events()) arrived; false if unknown or delivered
+    bool markDelivered(int fournisseurId, int index, const QDate& actualDate);
+    // Sorts by order date first; returns the number of events stored
+    int appendAll(QVector<DeliveryEvent> events);
+
+    DeliveryMetrics metrics(int fournisseurId) const;
+    // Orders placed between 'from' and 'to', both included
+    DeliveryMetrics metrics(int fournisseurId, const QDate& from, const QDate& to) const;
+    DeliveryMetrics metricsAll(const QDate& from, const QDate& to) const;
+
+    // Lead-time sketch of one supplier; empty if it has no delivered event
+    const TDigest& leadTimes(int fournisseurId) const;
+    // Per-supplier sketches merged by group (e.g. product type code) on all cores;
+    // suppliers missing from 'groupOf' are left out, key AllGroups holds everything
+    static constexpr quint32 AllGroups = 0xFFFFFFFFu;
+    QHash<quint32, TDigest> leadTimesByGroup(const QHash<int, quint32>& groupOf) const;
+
+    QVector<DeliveryEvent> events(int fournisseurId) const;
+    // Same wording as the free-text field it replaces: "45 livraisons - Moyenne 3.2 jours"
+    QString summary(int fournisseurId) const;
+
+    bool contains(int fournisseurId) const { return series.contains(fournisseurId); }
+    QList<int> suppliers() const { return series.keys(); }
+    qint64 eventCount() const { return totalEvents; }
+    qint64 memoryUsage() const;
+    void clear();
+
+    // A snapshot of the columns followed by one record per change made since:
+    // the append functions add a record (a new snapshot if the file has none)
+    bool saveToFile(const QString& fileName) const;
+    bool appendToFile(const QString& fileName, const DeliveryEvent& event) const;
+    bool appendDeliveredToFile(const QString& fileName, int fournisseurId, int index,
+                               const QDate& actualDate) const;
+    bool loadFromFile(const QString& fileName);
+    int replayedRecords() const { return replayed; }    // read after the snapshot by the last load
+    QString getLastError() const { return lastError; }
+
+private:
+    static constexpr qint16 NotDelivered = -32768;
+    static constexpr double LeadTimeCompression = 100.0;   // ~60 centroids, about 1 KB per supplier
+
+    struct Series {
+        Series() : leadTime(LeadTimeCompression) {}
+
+        QVector<qint32> blockStart;     // absolute order day (Julian) of each block's first event
+        QVector<quint16> orderGap;      // days since the previous event, 0 for a block's first
+        QVector<qint16> promisedLead;   // promised - order, in days
+        QVector<qint16> actualLead;     // actual - order, NotDelivered while pending
+        QVector<qint32> quantity;
+        qint32 lastDay = 0;
+        DeliveryMetrics totals;
+        TDigest leadTime;               // actual - order of delivered events
+    };
+
+    QHash<int, Series> series;
+    qint64 totalEvents;
+    int replayed;
+    mutable QString lastError;
+
+    static int lowerBound(const Series& s, qint64 day);     // first event ordered on or after 'day'
+    static qint64 orderDay(const Series& s, int index);
+    static void insertLate(Series& s, qint64 day, qint16 promised, qint16 actual, qint32 quantity);
+    static void countDelivery(Series& s, qint64 promised, qint64 actual);
+    bool appendRecord(const QString& fileName, const QByteArray& record) const;
+    static DeliveryMetrics scan(const Series& s, int begin, int end);
+    static void rebuildLeadTimes(Series& s);
+};
+
+#endif // DELIVERYSTORE_H
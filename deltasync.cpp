@@ -0,0 +1,91 @@
+#include "deltasync.h"
+#include <QDebug>
+
+// ===== DeltaSyncWorker Implementation =====
+DeltaSyncWorker::DeltaSyncWorker(const QString& sourceConnection, DatabaseManager::DatabaseType type)
+    : sourceConnection(sourceConnection), type(type), db(nullptr)
+{
+}
+
+DeltaSyncWorker::~DeltaSyncWorker()
+{
+    delete db;
+}
+
+void DeltaSyncWorker::fetch(const QDateTime& since)
+{
+    DatabaseManager::ChangeSet changes;
+
+    if (!db) {
+        db = new DatabaseManager(type, "delta_sync");
+        if (!db->connectLike(sourceConnection)) {
+            QString error = db->getLastError();
+            delete db;
+            db = nullptr;
+            emit fetched(changes, false, error);
+            return;
+        }
+    }
+
+    bool ok = db->fetchChangesSince(since, changes);
+    emit fetched(changes, ok, ok ? QString() : db->getLastError());
+}
+
+// ===== DeltaSyncPoller Implementation =====
+DeltaSyncPoller::DeltaSyncPoller(const QString& sourceConnection, DatabaseManager::DatabaseType type,
+                                 QObject *parent)
+    : QObject(parent), worker(new DeltaSyncWorker(sourceConnection, type)), inFlight(false)
+{
+    worker->moveToThread(&thread);
+    connect(&thread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(worker, &DeltaSyncWorker::fetched, this, &DeltaSyncPoller::onFetched);
+    connect(&timer, &QTimer::timeout, this, &DeltaSyncPoller::pollNow);
+    thread.setObjectName("DeltaSync");
+    thread.start();
+}
+
+DeltaSyncPoller::~DeltaSyncPoller()
+{
+    timer.stop();
+    thread.quit();
+    thread.wait();
+}
+
+void DeltaSyncPoller::start(const QDateTime& since, int intervalMs)
+{
+    watermark = since;
+    timer.start(intervalMs);
+}
+
+void DeltaSyncPoller::stop()
+{
+    timer.stop();
+}
+
+void DeltaSyncPoller::pollNow()
+{
+    // One fetch at a time: a slow database stretches the interval instead of queueing
+    if (inFlight || !watermark.isValid()) return;
+    inFlight = true;
+
+    QDateTime since = watermark;
+    DeltaSyncWorker *target = worker;
+    QMetaObject::invokeMethod(target, [target, since]() { target->fetch(since); },
+                              Qt::QueuedConnection);
+}
+
+void DeltaSyncPoller::onFetched(const DatabaseManager::ChangeSet& changes, bool ok, const QString& error)
+{
+    inFlight = false;
+
+    if (!ok) {
+        qDebug() << "⚠️ Delta sync failed:" << error;
+        emit syncFailed(error);
+        return;
+    }
+
+    watermark = changes.serverTime.addMSecs(-OverlapMs);
+    if (!changes.upserts.isEmpty() || !changes.deletedIds.isEmpty()) {
+        emit changesReady(changes);
+    }
+}
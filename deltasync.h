@@ -0,0 +1,75 @@
+#ifndef DELTASYNC_H
+#define DELTASYNC_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QDateTime>
+#include "databasemanager.h"
+
+// Runs fetchChangesSince on its own connection, inside the poller's thread
+class DeltaSyncWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    DeltaSyncWorker(const QString& sourceConnection, DatabaseManager::DatabaseType type);
+    ~DeltaSyncWorker();
+
+public slots:
+    void fetch(const QDateTime& since);
+
+signals:
+    void fetched(const DatabaseManager::ChangeSet& changes, bool ok, const QString& error);
+
+private:
+    QString sourceConnection;
+    DatabaseManager::DatabaseType type;
+    DatabaseManager *db;    // created lazily on the worker thread
+};
+
+/**
+ * Periodic incremental refresh from the database
+ *
+ * Every interval the worker thread asks for rows modified (and tombstones
+ * written) since the watermark; only those are handed to the GUI. The next
+ * watermark is the database clock at fetch time minus a small overlap, so a
+ * transaction that committed late with an older timestamp is not missed;
+ * re-delivered rows are harmless because applying them is idempotent.
+ */
+class DeltaSyncPoller : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int OverlapMs = 5000;
+
+    DeltaSyncPoller(const QString& sourceConnection, DatabaseManager::DatabaseType type,
+                    QObject *parent = nullptr);
+    ~DeltaSyncPoller();
+
+    // 'since' = database time of the last full load
+    void start(const QDateTime& since, int intervalMs = 5000);
+    void stop();
+    bool isActive() const { return timer.isActive(); }
+    QDateTime getWatermark() const { return watermark; }
+
+public slots:
+    void pollNow();
+
+signals:
+    void changesReady(const DatabaseManager::ChangeSet& changes);
+    void syncFailed(const QString& error);
+
+private slots:
+    void onFetched(const DatabaseManager::ChangeSet& changes, bool ok, const QString& error);
+
+private:
+    QThread thread;
+    DeltaSyncWorker *worker;
+    QTimer timer;
+    QDateTime watermark;
+    bool inFlight;
+};
+
+#endif // DELTASYNC_H
@@ -0,0 +1,236 @@
+#include "duplicatedetector.h"
+#include "contactindex.h"
+#include <QtConcurrent>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+inline quint64 mix64(quint64 x)
+{
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+inline quint64 hashChars(const QChar* data, int length)
+{
+    // FNV-1a over UTF-16 code units
+    quint64 h = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < length; ++i) {
+        h ^= data[i].unicode();
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+struct BandEntry {
+    quint64 key;
+    quint32 index;
+    bool operator<(const BandEntry& other) const { return key < other.key; }
+};
+
+const quint32 EmptySlot = 0xFFFFFFFFu;
+
+} // namespace
+
+DuplicateDetector::DuplicateDetector()
+    : minScore(0.6), maxBucketSize(64)
+{
+}
+
+QString DuplicateDetector::normalizeText(const QString& text)
+{
+    // "Foodmaster S.A.R.L." -> "foodmaster sarl": punctuation inside words is
+    // dropped, any other separator collapses to a single space
+    QString decomposed = text.toLower().normalized(QString::NormalizationForm_D);
+    QString result;
+    result.reserve(decomposed.size());
+    bool pendingSpace = false;
+
+    for (const QChar& c : decomposed) {
+        if (c.category() == QChar::Mark_NonSpacing) continue;
+        if (c.isLetterOrNumber()) {
+            if (pendingSpace && !result.isEmpty()) result += ' ';
+            pendingSpace = false;
+            result += c;
+        } else if (c.isSpace() || c == ',' || c == '/' || c == ';') {
+            pendingSpace = true;
+        }
+    }
+    return result;
+}
+
+DuplicateDetector::Record DuplicateDetector::makeRecord(const Fournisseur& f)
+{
+    Record record;
+    record.signature.fill(EmptySlot);
+
+    QString text = normalizeText(f.getNom()) + QChar(0x1f) + normalizeText(f.getAdresse());
+    const QChar* data = text.constData();
+
+    for (int i = 0; i + 3 <= text.size(); ++i) {
+        // Double hashing derives all NumHashes permutations from one shingle hash
+        quint64 h1 = mix64(hashChars(data + i, 3));
+        quint64 h2 = mix64(h1 ^ 0x9e3779b97f4a7c15ULL) | 1;
+        for (int k = 0; k < NumHashes; ++k) {
+            quint32 v = quint32((h1 + quint64(k) * h2) >> 32);
+            if (v < record.signature[k]) record.signature[k] = v;
+        }
+    }
+
+    // Same keys as the unique contact indexes: a pair flagged here is one they would reject
+    QString email = ContactIndex::normalizeEmail(f.getEmail());
+    qint64 phone = ContactIndex::normalizePhone(f.getTelephone());
+    record.emailKey = email.isEmpty() ? 0 : (mix64(hashChars(email.constData(), email.size())) | 1);
+    record.phoneKey = phone == 0 ? 0 : (mix64(quint64(phone)) | 1);
+    return record;
+}
+
+QVector<DuplicateDetector::DuplicatePair> DuplicateDetector::run(const QList<Fournisseur>& fournisseurs,
+                                                                 int split) const
+{
+    const int n = fournisseurs.size();
+    std::vector<Record> records(n);
+
+    // Signatures are independent: compute them in parallel over chunks
+    QVector<int> chunkStarts;
+    const int chunkSize = 4096;
+    for (int start = 0; start < n; start += chunkSize) chunkStarts.append(start);
+    QtConcurrent::blockingMap(chunkStarts, [&](int& start) {
+        int end = qMin(n, start + chunkSize);
+        for (int i = start; i < end; ++i) {
+            records[i] = makeRecord(fournisseurs[i]);
+        }
+    });
+
+    // LSH: one bucket key per band, plus exact email / phone keys
+    std::vector<BandEntry> entries;
+    entries.reserve(size_t(n) * (Bands + 2));
+    for (int i = 0; i < n; ++i) {
+        const Record& r = records[i];
+        if (r.signature[0] != EmptySlot) {
+            for (int b = 0; b < Bands; ++b) {
+                quint64 key = mix64(quint64(b) + 1);
+                for (int row = 0; row < RowsPerBand; ++row) {
+                    key = mix64(key ^ r.signature[b * RowsPerBand + row]);
+                }
+                entries.push_back({key, quint32(i)});
+            }
+        }
+        if (r.emailKey) entries.push_back({mix64(r.emailKey ^ 0xE3A1ULL), quint32(i)});
+        if (r.phoneKey) entries.push_back({mix64(r.phoneKey ^ 0x9403ULL), quint32(i)});
+    }
+    std::sort(entries.begin(), entries.end());
+
+    std::vector<quint64> candidates;
+    for (size_t begin = 0; begin < entries.size();) {
+        size_t end = begin + 1;
+        while (end < entries.size() && entries[end].key == entries[begin].key) ++end;
+
+        // Oversized buckets are generic values ("Tunis", shared switchboards)
+        if (end - begin > 1 && int(end - begin) <= maxBucketSize) {
+            for (size_t a = begin; a < end; ++a) {
+                for (size_t b = a + 1; b < end; ++b) {
+                    quint32 x = qMin(entries[a].index, entries[b].index);
+                    quint32 y = qMax(entries[a].index, entries[b].index);
+                    if (x == y) continue;
+                    if (split >= 0 && !(int(x) < split && int(y) >= split)) continue;
+                    candidates.push_back((quint64(x) << 32) | y);
+                }
+            }
+        }
+        begin = end;
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    QVector<DuplicatePair> pairs;
+    for (quint64 packed : candidates) {
+        int x = int(packed >> 32);
+        int y = int(packed & 0xFFFFFFFFu);
+        const Record& a = records[x];
+        const Record& b = records[y];
+
+        int equal = 0;
+        if (a.signature[0] != EmptySlot && b.signature[0] != EmptySlot) {
+            for (int k = 0; k < NumHashes; ++k) {
+                if (a.signature[k] == b.signature[k]) ++equal;
+            }
+        }
+
+        DuplicatePair pair;
+        pair.first = x;
+        pair.second = y;
+        pair.nameSimilarity = double(equal) / NumHashes;
+        pair.sameEmail = a.emailKey && a.emailKey == b.emailKey;
+        pair.samePhone = a.phoneKey && a.phoneKey == b.phoneKey;
+        double weighted = 0.4 * pair.nameSimilarity +
+                          (pair.sameEmail ? 0.35 : 0.0) +
+                          (pair.samePhone ? 0.25 : 0.0);
+        pair.score = qMax(pair.nameSimilarity, weighted);
+
+        if (pair.score >= minScore) {
+            pairs.append(pair);
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end(), [](const DuplicatePair& a, const DuplicatePair& b) {
+        return a.score > b.score;
+    });
+    return pairs;
+}
+
+QVector<DuplicateDetector::DuplicatePair> DuplicateDetector::findDuplicates(const QList<Fournisseur>& fournisseurs) const
+{
+    return run(fournisseurs, -1);
+}
+
+QVector<DuplicateDetector::DuplicatePair> DuplicateDetector::findDuplicatesAgainst(const QList<Fournisseur>& existing,
+                                                                                   const QList<Fournisseur>& incoming) const
+{
+    QList<Fournisseur> combined = existing;
+    combined.append(incoming);
+
+    QVector<DuplicatePair> pairs = run(combined, existing.size());
+    for (DuplicatePair& pair : pairs) {
+        pair.second -= existing.size();
+    }
+    return pairs;
+}
+
+QString DuplicateDetector::formatReport(const QVector<DuplicatePair>& pairs,
+                                        const QList<Fournisseur>& left,
+                                        const QList<Fournisseur>& right,
+                                        int maxLines)
+{
+    QString report = QString("%1 doublons probables détectés\n\n").arg(pairs.size());
+
+    int lines = 0;
+    for (const DuplicatePair& pair : pairs) {
+        if (lines++ >= maxLines) {
+            report += QString("... (%1 autres)\n").arg(pairs.size() - maxLines);
+            break;
+        }
+
+        const Fournisseur& a = left[pair.first];
+        const Fournisseur& b = right[pair.second];
+        QStringList reasons;
+        reasons << QString("nom/adresse %1%").arg(qRound(pair.nameSimilarity * 100));
+        if (pair.sameEmail) reasons << "email identique";
+        if (pair.samePhone) reasons << "téléphone identique";
+
+        report += QString("• [%1%] #%2 %3  ⇄  #%4 %5 (%6)\n")
+            .arg(qRound(pair.score * 100))
+            .arg(a.getIdFournisseur())
+            .arg(a.getNom())
+            .arg(b.getIdFournisseur())
+            .arg(b.getNom())
+            .arg(reasons.join(", "));
+    }
+    return report;
+}
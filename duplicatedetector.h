@@ -0,0 +1,72 @@
+#ifndef DUPLICATEDETECTOR_H
+#define DUPLICATEDETECTOR_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QStringList>
+#include <array>
+#include "fournisseur.h"
+
+/**
+ * Near-duplicate supplier detection (MinHash + LSH)
+ *
+ * Each supplier gets a MinHash signature over character trigrams of its
+ * normalized nom and adresse. Signatures are cut into bands; suppliers that
+ * collide in any band (or share a normalized email / phone) become
+ * candidate pairs, which are then scored. Cost is near-linear in the
+ * number of suppliers instead of comparing every pair.
+ */
+class DuplicateDetector
+{
+public:
+    static const int NumHashes = 32;
+    static const int Bands = 8;            // 8 bands x 4 rows ~ 0.6 similarity threshold
+    static const int RowsPerBand = NumHashes / Bands;
+
+    struct DuplicatePair {
+        int first;              // index into the analysed list
+        int second;
+        double score;           // 0..1
+        double nameSimilarity;  // estimated Jaccard of nom+adresse trigrams
+        bool sameEmail;
+        bool samePhone;
+    };
+
+    DuplicateDetector();
+
+    void setMinScore(double score) { minScore = score; }
+    void setMaxBucketSize(int size) { maxBucketSize = size; }
+
+    // All near-duplicate pairs in the list, best score first
+    QVector<DuplicatePair> findDuplicates(const QList<Fournisseur>& fournisseurs) const;
+
+    // Only pairs between 'existing' and 'incoming'; second indexes 'incoming'
+    QVector<DuplicatePair> findDuplicatesAgainst(const QList<Fournisseur>& existing,
+                                                 const QList<Fournisseur>& incoming) const;
+
+    static QString formatReport(const QVector<DuplicatePair>& pairs,
+                                const QList<Fournisseur>& left,
+                                const QList<Fournisseur>& right,
+                                int maxLines = 200);
+
+    // Emails and phones are compared as ContactIndex normalizes them
+    static QString normalizeText(const QString& text);
+
+private:
+    typedef std::array<quint32, NumHashes> Signature;
+
+    struct Record {
+        Signature signature;
+        quint64 emailKey;       // 0 = missing
+        quint64 phoneKey;
+    };
+
+    double minScore;
+    int maxBucketSize;
+
+    static Record makeRecord(const Fournisseur& f);
+    QVector<DuplicatePair> run(const QList<Fournisseur>& fournisseurs, int split) const;
+};
+
+#endif // DUPLICATEDETECTOR_H
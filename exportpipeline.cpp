@@ -0,0 +1,227 @@
+#include "exportpipeline.h"
+#include "jobscheduler.h"
+#include "tracing.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <atomic>
+#include <deque>
+#include <thread>
+
+namespace {
+
+using Batch = std::shared_ptr<const QVector<Fournisseur>>;
+
+// Single producer, single consumer; push blocks while the queue is full
+class BatchQueue
+{
+public:
+    explicit BatchQueue(int capacity) : capacity(capacity), closed(false) {}
+
+    void push(Batch batch)
+    {
+        QMutexLocker locker(&mutex);
+        while (int(batches.size()) >= capacity) notFull.wait(&mutex);
+        batches.push_back(std::move(batch));
+        notEmpty.wakeOne();
+    }
+
+    // false once the queue is closed and empty
+    bool pop(Batch& batch)
+    {
+        QMutexLocker locker(&mutex);
+        while (batches.empty() && !closed) notEmpty.wait(&mutex);
+        if (batches.empty()) return false;
+        batch = std::move(batches.front());
+        batches.pop_front();
+        notFull.wakeOne();
+        return true;
+    }
+
+    void close()
+    {
+        QMutexLocker locker(&mutex);
+        closed = true;
+        notEmpty.wakeAll();
+    }
+
+private:
+    QMutex mutex;
+    QWaitCondition notEmpty;
+    QWaitCondition notFull;
+    std::deque<Batch> batches;
+    int capacity;
+    bool closed;
+};
+
+} // namespace
+
+// ===== Export sinks Implementation =====
+bool CsvExportSink::open()
+{
+    if (!writer.open(fileName)) {
+        error = "écriture impossible";
+        return false;
+    }
+    return true;
+}
+
+bool CsvExportSink::close()
+{
+    if (!writer.close()) {
+        error = "erreur d'écriture";
+        return false;
+    }
+    return true;
+}
+
+void CsvExportSink::abort()
+{
+    writer.close();
+    QFile::remove(fileName);
+}
+
+bool JsonExportSink::open()
+{
+    if (!writer.open(fileName)) {
+        error = "écriture impossible";
+        return false;
+    }
+    return true;
+}
+
+bool JsonExportSink::close()
+{
+    if (!writer.close()) {
+        error = "erreur d'écriture";
+        return false;
+    }
+    return true;
+}
+
+void JsonExportSink::abort()
+{
+    writer.close();
+    QFile::remove(fileName);
+}
+
+// ===== ExportPipeline Implementation =====
+ExportPipeline::ExportPipeline(int batchRows, int queueBatches)
+    : batchRows(qMax(1, batchRows)), queueBatches(qMax(1, queueBatches)), scanned(0), elapsed(0.0)
+{
+}
+
+ExportPipeline::~ExportPipeline()
+{
+}
+
+void ExportPipeline::addSink(std::unique_ptr<ExportSink> sink)
+{
+    sinks.push_back(std::move(sink));
+}
+
+std::unique_ptr<ExportSink> ExportPipeline::sinkForFile(const QString& fileName)
+{
+    QString suffix = QFileInfo(fileName).suffix().toLower();
+    if (suffix == "csv") return std::make_unique<CsvExportSink>(fileName);
+    if (suffix == "json") return std::make_unique<JsonExportSink>(fileName);
+    return nullptr;
+}
+
+bool ExportPipeline::run(const Source& source, JobContext *job, qint64 expectedRows)
+{
+    TRACE_SCOPE("ExportPipeline::run");
+    sinkReports.clear();
+    scanned = 0;
+    lastError.clear();
+    if (sinks.empty()) {
+        lastError = "aucun format de sortie";
+        return false;
+    }
+
+    const int count = int(sinks.size());
+    std::vector<std::unique_ptr<BatchQueue>> queues;
+    QVector<SinkReport> reports(count);
+    std::vector<std::thread> threads;
+    std::atomic<bool> sourceFailed(false);     // set before the queues close
+    for (int i = 0; i < count; ++i) {
+        queues.push_back(std::make_unique<BatchQueue>(queueBatches));
+        reports[i].name = sinks[i]->name();
+    }
+
+    for (int i = 0; i < count; ++i) {
+        threads.emplace_back([&, i]() {
+            TRACE_SCOPE("ExportPipeline::sink");
+            ExportSink& sink = *sinks[i];
+            SinkReport& report = reports[i];
+            QElapsedTimer timer;
+            timer.start();
+
+            bool healthy = sink.open();
+            Batch batch;
+            while (queues[i]->pop(batch)) {
+                // A failed sink keeps draining so the scan never blocks on it
+                if (!healthy) continue;
+                for (const Fournisseur& f : *batch) sink.write(f);
+                report.rows += batch->size();
+            }
+
+            if (job && job->isCancelled()) {
+                sink.abort();
+                report.error = "annulé";
+            } else if (sourceFailed.load(std::memory_order_relaxed)) {
+                // Treated like a cancel: a truncated file is worse than none
+                sink.abort();
+                report.error = "source interrompue";
+            } else if (healthy && sink.close()) {
+                report.ok = true;
+            } else {
+                report.error = sink.lastError();
+            }
+            report.seconds = timer.elapsed() / 1000.0;
+        });
+    }
+
+    // The single scan: rows go out in shared batches, never copied per sink
+    QElapsedTimer timer;
+    timer.start();
+    auto current = std::make_shared<QVector<Fournisseur>>();
+    current->reserve(batchRows);
+    auto dispatch = [&]() {
+        Batch batch = std::move(current);
+        for (auto& queue : queues) queue->push(batch);
+        current = std::make_shared<QVector<Fournisseur>>();
+        current->reserve(batchRows);
+    };
+
+    bool sourceOk = source([&](const Fournisseur& f) {
+        if (job && job->isCancelled()) return false;
+        current->append(f);
+        if (++scanned % batchRows == 0) {
+            dispatch();
+            if (job) job->setProgress(scanned, expectedRows > 0 ? expectedRows : scanned);
+        }
+        return true;
+    });
+    if (!sourceOk && !(job && job->isCancelled())) {
+        sourceFailed.store(true, std::memory_order_relaxed);
+    } else if (!current->isEmpty()) {
+        dispatch();
+    }
+
+    for (auto& queue : queues) queue->close();
+    for (std::thread& thread : threads) thread.join();
+    elapsed = timer.elapsed() / 1000.0;
+
+    bool ok = sourceOk && !(job && job->isCancelled());
+    if (!sourceOk && !(job && job->isCancelled())) lastError = "lecture de la source interrompue";
+    for (const SinkReport& report : reports) {
+        sinkReports.append(report);
+        if (!report.ok) ok = false;
+    }
+    if (job) job->setProgress(scanned, scanned);
+    return ok;
+}
@@ -0,0 +1,114 @@
+#ifndef EXPORTPIPELINE_H
+#define EXPORTPIPELINE_H
+
+#include <QString>
+#include <QList>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "fournisseur.h"
+#include "advancedfeatures.h"
+
+class JobContext;
+
+/**
+ * One output format of an export. open, write and close are all called
+ * on the sink's own thread, in that order.
+ */
+class ExportSink
+{
+public:
+    virtual ~ExportSink() {}
+    virtual QString name() const = 0;
+    virtual bool open() = 0;
+    virtual void write(const Fournisseur& f) = 0;
+    virtual bool close() = 0;
+    virtual void abort() = 0;           // cancelled: remove the partial output
+    virtual QString lastError() const = 0;
+};
+
+class CsvExportSink : public ExportSink
+{
+public:
+    explicit CsvExportSink(const QString& fileName) : fileName(fileName) {}
+    QString name() const override { return "CSV " + fileName; }
+    bool open() override;
+    void write(const Fournisseur& f) override { writer.write(f); }
+    bool close() override;
+    void abort() override;
+    QString lastError() const override { return error; }
+
+private:
+    QString fileName;
+    CSVWriter writer;
+    QString error;
+};
+
+class JsonExportSink : public ExportSink
+{
+public:
+    explicit JsonExportSink(const QString& fileName) : fileName(fileName) {}
+    QString name() const override { return "JSON " + fileName; }
+    bool open() override;
+    void write(const Fournisseur& f) override { writer.write(f); }
+    bool close() override;
+    void abort() override;
+    QString lastError() const override { return error; }
+
+private:
+    QString fileName;
+    JsonArrayWriter writer;
+    QString error;
+};
+
+/**
+ * Multi-format export from a single scan
+ *
+ * The source (a store snapshot, a database cursor) is read once; rows are
+ * grouped in batches and each batch is handed, shared and unchanged, to
+ * every sink through its own bounded queue. Sinks run on their own
+ * threads, so the export takes about as long as the slowest sink; a full
+ * queue makes the scan wait, which keeps memory bounded. A sink that fails
+ * is drained without writing and does not stop the others.
+ */
+class ExportPipeline
+{
+public:
+    using Visitor = std::function<bool(const Fournisseur&)>;     // false stops the scan
+    using Source = std::function<bool(const Visitor&)>;         // false = read error
+
+    struct SinkReport {
+        QString name;
+        bool ok = false;
+        QString error;
+        qint64 rows = 0;
+        double seconds = 0.0;
+    };
+
+    explicit ExportPipeline(int batchRows = 512, int queueBatches = 8);
+    ~ExportPipeline();
+
+    void addSink(std::unique_ptr<ExportSink> sink);
+
+    // 'expectedRows' only feeds the job progress (0 = unknown)
+    bool run(const Source& source, JobContext *job = nullptr, qint64 expectedRows = 0);
+
+    qint64 rowsScanned() const { return scanned; }
+    double scanSeconds() const { return elapsed; }
+    const QList<SinkReport>& reports() const { return sinkReports; }
+    QString getLastError() const { return lastError; }
+
+    // Picks the sink from the extension (.csv, .json); nullptr if unknown
+    static std::unique_ptr<ExportSink> sinkForFile(const QString& fileName);
+
+private:
+    int batchRows;
+    int queueBatches;
+    std::vector<std::unique_ptr<ExportSink>> sinks;
+    QList<SinkReport> sinkReports;
+    qint64 scanned;
+    double elapsed;
+    QString lastError;
+};
+
+#endif // EXPORTPIPELINE_H
@@ -1,10 +1,114 @@
 #include "fournisseur.h"
 #include <QRegularExpression>
 #include <QJsonObject>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <algorithm>
+#include <atomic>
+
+// ===== ProductTypes Implementation =====
+namespace {
+
+// Labels live in fixed chunks that never move, so readers need no lock:
+// a chunk pointer and the count are published after the label is written
+const int ChunkBits = 10;
+const int ChunkSize = 1 << ChunkBits;
+const int MaxChunks = 4096;
+
+// intern() looks labels up in a read-only copy of 'codes' first, without the lock.
+// A copy is never freed (readers may hold it), so one is only published again
+// while the dictionary is small, then each time it doubles.
+const int RepublishLimit = 256;
+
+struct TypeDictionary {
+    QMutex mutex;
+    QHash<QString, quint32> codes;
+    std::atomic<const QHash<QString, quint32>*> published;
+    int publishedSize;
+    std::atomic<QString*> chunks[MaxChunks];
+    std::atomic<int> used;
+
+    TypeDictionary() : published(nullptr), publishedSize(0), used(1)
+    {
+        for (std::atomic<QString*>& chunk : chunks) chunk.store(nullptr, std::memory_order_relaxed);
+        chunks[0].store(new QString[ChunkSize], std::memory_order_release);     // code 0 = ""
+    }
+};
+
+TypeDictionary& dictionary()
+{
+    static TypeDictionary instance;     // intentionally never freed: codes outlive every Fournisseur
+    return instance;
+}
+
+} // namespace
+
+quint32 ProductTypes::intern(const QString& label)
+{
+    if (label.isEmpty()) return 0;
+    TypeDictionary& dict = dictionary();
+    if (const QHash<QString, quint32> *known = dict.published.load(std::memory_order_acquire)) {
+        auto it = known->constFind(label);
+        if (it != known->constEnd()) return it.value();
+    }
+
+    QMutexLocker locker(&dict.mutex);
+    auto it = dict.codes.constFind(label);
+    if (it != dict.codes.constEnd()) {
+        // Known but missed by the lock-free copy: refresh it so the next call stays lock-free
+        if (dict.codes.size() <= RepublishLimit || dict.codes.size() >= 2 * dict.publishedSize) {
+            dict.published.store(new QHash<QString, quint32>(dict.codes), std::memory_order_release);
+            dict.publishedSize = dict.codes.size();
+        }
+        return it.value();
+    }
+
+    int code = dict.used.load(std::memory_order_relaxed);
+    int chunk = code >> ChunkBits;
+    if (chunk >= MaxChunks) qFatal("ProductTypes: dictionary full");
+    QString *slots = dict.chunks[chunk].load(std::memory_order_relaxed);
+    if (!slots) {
+        slots = new QString[ChunkSize];
+        dict.chunks[chunk].store(slots, std::memory_order_release);
+    }
+    slots[code & (ChunkSize - 1)] = label;
+    dict.codes.insert(label, quint32(code));
+    dict.used.store(code + 1, std::memory_order_release);
+    return quint32(code);
+}
+
+const QString& ProductTypes::label(quint32 code)
+{
+    TypeDictionary& dict = dictionary();
+    Q_ASSERT(int(code) < dict.used.load(std::memory_order_acquire));
+    return dict.chunks[code >> ChunkBits].load(std::memory_order_acquire)[code & (ChunkSize - 1)];
+}
+
+int ProductTypes::count()
+{
+    return dictionary().used.load(std::memory_order_acquire);
+}
+
+QVector<int> ProductTypes::sortRanks()
+{
+    int codes = count();
+    QVector<int> order(codes);
+    for (int code = 0; code < codes; ++code) order[code] = code;
+    std::sort(order.begin(), order.end(), [](int a, int b) {
+        return label(quint32(a)) < label(quint32(b));
+    });
+
+    QVector<int> ranks(codes);
+    for (int rank = 0; rank < codes; ++rank) ranks[order[rank]] = rank;
+    return ranks;
+}
+
+// ===== Fournisseur Implementation =====
 
 Fournisseur::Fournisseur()
     : idFournisseur(0), nom(""), adresse(""), email(""), telephone(""),
-      typeProduits(""), historiqueLivraisons(""), isActive(true)
+      typeCode(0), isActive(true)
 {
 }
 
@@ -13,7 +117,7 @@ Fournisseur::Fournisseur(int id, const QString& nom, const QString& adresse,
                          const QString& typeProduits, const QString& historiqueLivraisons,
                          bool isActive)
     : idFournisseur(id), nom(nom), adresse(adresse), email(email),
-      telephone(telephone), typeProduits(typeProduits),
+      telephone(telephone), typeCode(ProductTypes::intern(typeProduits)),
       historiqueLivraisons(historiqueLivraisons), isActive(isActive)
 {
 }
@@ -47,8 +151,8 @@ QJsonObject Fournisseur::toJson() const
     json["adresse"] = adresse;
     json["email"] = email;
     json["telephone"] = telephone;
-    json["typeProduits"] = typeProduits;
-    json["historiqueLivraisons"] = historiqueLivraisons;
+    json["typeProduits"] = getTypeProduits();
+    json["historiqueLivraisons"] = getHistoriqueLivraisons();
     json["isActive"] = isActive;
     return json;
 }
@@ -76,3 +180,15 @@ QString Fournisseur::toString() const
         .arg(telephone);
 }
 
+bool Fournisseur::operator==(const Fournisseur& other) const
+{
+    return idFournisseur == other.idFournisseur &&
+           isActive == other.isActive &&
+           nom == other.nom &&
+           adresse == other.adresse &&
+           email == other.email &&
+           telephone == other.telephone &&
+           typeCode == other.typeCode &&
+           (historiqueLivraisons.sameSlot(other.historiqueLivraisons) ||
+            getHistoriqueLivraisons() == other.getHistoriqueLivraisons());
+}
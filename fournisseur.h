@@ -3,6 +3,29 @@
 
 #include <QString>
 #include <QJsonObject>
+#include <QVector>
+#include "coldtext.h"
+
+/**
+ * Process-wide dictionary of product types
+ *
+ * typeProduits is free text but only takes a few dozen distinct values, so a
+ * Fournisseur keeps a small integer code instead of its own copy of the
+ * label. Code 0 is the empty label; the others are assigned in order of first
+ * appearance and never reused, so a code can index a counting array.
+ * label() is lock-free. intern() finds known labels in a published read-only
+ * copy without locking; it locks to add a label or when the copy lags behind.
+ */
+class ProductTypes
+{
+public:
+    static quint32 intern(const QString& label);
+    static const QString& label(quint32 code);
+    static int count();                         // codes assigned so far, 0 included
+
+    // Position of each code in label order: sorting by type compares ranks, not strings
+    static QVector<int> sortRanks();
+};
 
 class Fournisseur
 {
@@ -12,8 +35,8 @@ private:
     QString adresse;
     QString email;
     QString telephone;
-    QString typeProduits;
-    QString historiqueLivraisons;
+    quint32 typeCode;               // ProductTypes code
+    ColdText historiqueLivraisons;  // cold: decompressed only when read
     bool isActive;
 
 public:
@@ -29,8 +52,10 @@ public:
     QString getAdresse() const { return adresse; }
     QString getEmail() const { return email; }
     QString getTelephone() const { return telephone; }
-    QString getTypeProduits() const { return typeProduits; }
-    QString getHistoriqueLivraisons() const { return historiqueLivraisons; }
+    QString getTypeProduits() const { return ProductTypes::label(typeCode); }
+    quint32 getTypeCode() const { return typeCode; }
+    QString getHistoriqueLivraisons() const { return historiqueLivraisons.toString(); }
+    const ColdText& getHistoriqueRef() const { return historiqueLivraisons; }
     bool getIsActive() const { return isActive; }
 
     // Setters
@@ -39,8 +64,9 @@ public:
     void setAdresse(const QString& a) { adresse = a; }
     void setEmail(const QString& e) { email = e; }
     void setTelephone(const QString& t) { telephone = t; }
-    void setTypeProduits(const QString& tp) { typeProduits = tp; }
-    void setHistoriqueLivraisons(const QString& h) { historiqueLivraisons = h; }
+    void setTypeProduits(const QString& tp) { typeCode = ProductTypes::intern(tp); }
+    void setHistoriqueLivraisons(const QString& h) { historiqueLivraisons = ColdText(h); }
+    void setHistoriqueLivraisons(const ColdText& h) { historiqueLivraisons = h; }
     void setIsActive(bool active) { isActive = active; }
 
     // Validation methods
@@ -54,6 +80,10 @@ public:
 
     // Display info
     QString toString() const;
+
+    // Field-by-field comparison (incremental refresh skips unchanged rows)
+    bool operator==(const Fournisseur& other) const;
+    bool operator!=(const Fournisseur& other) const { return !(*this == other); }
 };
 
 #endif // FOURNISSEUR_H
@@ -0,0 +1,191 @@
+#include "fuzzysearch.h"
+#include <algorithm>
+#include <cstring>
+
+FuzzyNameIndex::FuzzyNameIndex()
+{
+    offsets.append(0);
+}
+
+void FuzzyNameIndex::clear()
+{
+    names.clear();
+    offsets.clear();
+    offsets.append(0);
+    gramOffsets.clear();
+    postings.clear();
+    counts.clear();
+    touched.clear();
+}
+
+QByteArray FuzzyNameIndex::normalize(const QString& text)
+{
+    // Lower-case, strip accents, keep letters/digits and single spaces
+    QString decomposed = text.toLower().normalized(QString::NormalizationForm_D);
+    QString result;
+    result.reserve(decomposed.size());
+    bool lastWasSpace = true;
+
+    for (const QChar& c : decomposed) {
+        if (c.category() == QChar::Mark_NonSpacing) continue;
+        if (c.isLetterOrNumber()) {
+            result += c;
+            lastWasSpace = false;
+        } else if (!lastWasSpace) {
+            result += ' ';
+            lastWasSpace = true;
+        }
+    }
+    if (result.endsWith(' ')) result.chop(1);
+    return result.toUtf8();
+}
+
+void FuzzyNameIndex::build(const QList<Fournisseur>& fournisseurs)
+{
+    clear();
+    offsets.reserve(fournisseurs.size() + 1);
+
+    for (const Fournisseur& f : fournisseurs) {
+        names.append(normalize(f.getNom()));
+        offsets.append(names.size());
+    }
+
+    int n = size();
+    const char* data = names.constData();
+
+    // Pass 1: count distinct bigrams per name, pass 2: fill postings
+    gramOffsets.assign(GramSpace + 1, 0);
+    std::vector<quint32> seen(GramSpace, 0xFFFFFFFFu);
+
+    for (int i = 0; i < n; ++i) {
+        for (quint32 p = offsets[i]; p + Q <= offsets[i + 1]; ++p) {
+            quint32 g = gramAt(data + p);
+            if (seen[g] != quint32(i)) {
+                seen[g] = i;
+                gramOffsets[g + 1]++;
+            }
+        }
+    }
+    for (int g = 0; g < GramSpace; ++g) {
+        gramOffsets[g + 1] += gramOffsets[g];
+    }
+
+    postings.resize(gramOffsets[GramSpace]);
+    std::vector<quint32> cursor(gramOffsets.begin(), gramOffsets.end() - 1);
+    std::fill(seen.begin(), seen.end(), 0xFFFFFFFFu);
+
+    for (int i = 0; i < n; ++i) {
+        for (quint32 p = offsets[i]; p + Q <= offsets[i + 1]; ++p) {
+            quint32 g = gramAt(data + p);
+            if (seen[g] != quint32(i)) {
+                seen[g] = i;
+                postings[cursor[g]++] = i;
+            }
+        }
+    }
+
+    counts.assign(n, 0);
+    touched.reserve(qMin(n, 1 << 16));
+}
+
+int FuzzyNameIndex::myersDistance(const quint64* peq, int m,
+                                  const char* text, int textLength)
+{
+    // Myers (1999) / Hyyrö formulation; the text start is free, so the
+    // result is the best distance of the pattern against any substring.
+    quint64 pv = (m == 64) ? ~quint64(0) : ((quint64(1) << m) - 1);
+    quint64 mv = 0;
+    const quint64 high = quint64(1) << (m - 1);
+    int score = m;
+    int best = m;
+
+    for (int j = 0; j < textLength; ++j) {
+        quint64 eq = peq[quint8(text[j])];
+        quint64 xv = eq | mv;
+        quint64 xh = (((eq & pv) + pv) ^ pv) | eq;
+        quint64 ph = mv | ~(xh | pv);
+        quint64 mh = pv & xh;
+
+        if (ph & high) ++score;
+        else if (mh & high) --score;
+
+        ph <<= 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        if (score < best) best = score;
+    }
+    return best;
+}
+
+QVector<FuzzyNameIndex::Match> FuzzyNameIndex::search(const QString& pattern, int k,
+                                                      int maxDistance) const
+{
+    QVector<Match> results;
+    QByteArray p = normalize(pattern);
+    if (p.size() > 64) p.truncate(64);
+    int m = p.size();
+    if (m < Q || isEmpty() || k <= 0) return results;
+
+    if (maxDistance < 0) {
+        maxDistance = qMax(1, m / 4);
+    }
+
+    // Distinct pattern bigrams; each edit destroys at most Q of them
+    quint32 patternGrams[64];
+    int gramCount = 0;
+    for (int i = 0; i + Q <= m; ++i) {
+        quint32 g = gramAt(p.constData() + i);
+        if (std::find(patternGrams, patternGrams + gramCount, g) == patternGrams + gramCount) {
+            patternGrams[gramCount++] = g;
+        }
+    }
+    int minShared = qMax(1, gramCount - maxDistance * Q);
+
+    touched.clear();
+    for (int i = 0; i < gramCount; ++i) {
+        quint32 g = patternGrams[i];
+        for (quint32 pos = gramOffsets[g]; pos < gramOffsets[g + 1]; ++pos) {
+            quint32 id = postings[pos];
+            if (counts[id]++ == 0) touched.push_back(id);
+        }
+    }
+
+    quint64 peq[256];
+    std::memset(peq, 0, sizeof(peq));
+    for (int i = 0; i < m; ++i) {
+        peq[quint8(p[i])] |= quint64(1) << i;
+    }
+
+    // Bounded max-heap on (distance, length) keeps the k best
+    results.reserve(k);
+    auto worse = [this](const Match& a, const Match& b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        return (offsets[a.index + 1] - offsets[a.index]) <
+               (offsets[b.index + 1] - offsets[b.index]);
+    };
+
+    const char* data = names.constData();
+    for (quint32 id : touched) {
+        int shared = counts[id];
+        counts[id] = 0;
+        if (shared < minShared) continue;
+
+        int d = myersDistance(peq, m, data + offsets[id], offsets[id + 1] - offsets[id]);
+        if (d > maxDistance) continue;
+
+        Match candidate{int(id), d};
+        if (results.size() < k) {
+            results.append(candidate);
+            std::push_heap(results.begin(), results.end(), worse);
+        } else if (worse(candidate, results.front())) {
+            std::pop_heap(results.begin(), results.end(), worse);
+            results.back() = candidate;
+            std::push_heap(results.begin(), results.end(), worse);
+        }
+    }
+
+    std::sort_heap(results.begin(), results.end(), worse);
+    return results;
+}
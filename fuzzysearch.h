@@ -0,0 +1,58 @@
+#ifndef FUZZYSEARCH_H
+#define FUZZYSEARCH_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+#include <vector>
+#include "fournisseur.h"
+
+/**
+ * Fuzzy supplier name search
+ *
+ * Candidates are retrieved through a bigram index (q-gram lemma filter) and
+ * scored with Myers' bit-parallel edit distance, in its approximate substring
+ * form: "Techsuply" matches "TechSupply SARL" at distance 1.
+ * Patterns are limited to 64 bytes (one machine word).
+ */
+class FuzzyNameIndex
+{
+public:
+    struct Match {
+        int index;      // position in the indexed supplier list
+        int distance;   // edit distance to the best matching substring
+    };
+
+    FuzzyNameIndex();
+
+    void build(const QList<Fournisseur>& fournisseurs);
+    void clear();
+    bool isEmpty() const { return offsets.size() <= 1; }
+    int size() const { return offsets.size() - 1; }
+
+    // Top-k matches, best first; maxDistance < 0 picks a length-based default.
+    // Not thread-safe: reuses internal scratch buffers between queries.
+    QVector<Match> search(const QString& pattern, int k = 10, int maxDistance = -1) const;
+
+    static QByteArray normalize(const QString& text);
+    static int myersDistance(const quint64* peq, int patternLength,
+                             const char* text, int textLength);
+
+private:
+    static const int Q = 2;
+    static const int GramSpace = 1 << 16;
+
+    QByteArray names;                    // normalized names, concatenated
+    QVector<quint32> offsets;            // name i = [offsets[i], offsets[i+1])
+    std::vector<quint32> gramOffsets;    // CSR over bigrams
+    std::vector<quint32> postings;
+
+    // Query scratch space, sized once at build time
+    mutable std::vector<quint16> counts;
+    mutable std::vector<quint32> touched;
+
+    static quint32 gramAt(const char* p) { return (quint8(p[0]) << 8) | quint8(p[1]); }
+};
+
+#endif // FUZZYSEARCH_H
@@ -0,0 +1,337 @@
+#include "jobscheduler.h"
+#include "tracing.h"
+#include <QMutexLocker>
+#include <QThread>
+
+namespace {
+// Index of the scheduler worker running on this thread, -1 elsewhere
+thread_local int currentWorker = -1;
+}
+
+// ===== JobContext Implementation =====
+void JobContext::setProgress(qint64 doneCount, qint64 totalCount)
+{
+    done.store(doneCount, std::memory_order_relaxed);
+    total.store(totalCount, std::memory_order_relaxed);
+    dirty.store(true, std::memory_order_release);
+}
+
+void JobContext::setStatus(const QString& text)
+{
+    QMutexLocker locker(&textMutex);
+    status = text;
+    dirty.store(true, std::memory_order_release);
+}
+
+void JobContext::fail(const QString& message)
+{
+    QMutexLocker locker(&textMutex);
+    error = message;
+}
+
+void JobContext::parallelFor(int count, const std::function<void(int)>& fn)
+{
+    if (count <= 0) return;
+
+    auto remaining = std::make_shared<std::atomic<int>>(count);
+    const std::function<void(int)> *body = &fn;   // alive until we return, which waits for every part
+
+    // Pushed in reverse: this worker pops from the back (1, 2, ...), thieves take the tail
+    for (int i = count - 1; i >= 1; --i) {
+        scheduler->push([this, body, remaining, i]() {
+            if (!isCancelled()) (*body)(i);
+            remaining->fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+    if (!isCancelled()) fn(0);
+    remaining->fetch_sub(1, std::memory_order_acq_rel);
+
+    // Help instead of blocking: run our own parts (or anyone's) until ours are all done
+    while (remaining->load(std::memory_order_acquire) > 0) {
+        if (!scheduler->runOneTask(currentWorker)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// ===== JobScheduler Implementation =====
+JobScheduler::JobScheduler(int threads, QObject *parent)
+    : QObject(parent), running(0), maxRunning(2), stopping(false), wakeups(0), nextId(1)
+{
+    int count = threads > 0 ? threads : qMax(2, QThread::idealThreadCount());
+    workers.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < count; ++i) {
+        workers[i]->thread = std::thread([this, i]() { workerLoop(i); });
+    }
+
+    progressTimer.setInterval(100);
+    connect(&progressTimer, &QTimer::timeout, this, &JobScheduler::publishProgress);
+}
+
+JobScheduler::~JobScheduler()
+{
+    // No callbacks from here on: their receivers may already be half destroyed
+    for (const auto& job : jobs) {
+        job->context.cancelRequested.store(true);
+    }
+    {
+        QMutexLocker locker(&queueMutex);
+        stopping = true;
+        signalWorkers();
+    }
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+int JobScheduler::submit(const QString& title, Priority priority, Work work, Done onDone)
+{
+    auto job = std::make_shared<Job>();
+    job->id = nextId++;
+    job->title = title;
+    job->priority = priority;
+    job->work = std::move(work);
+    job->onDone = std::move(onDone);
+    job->context.scheduler = this;
+
+    jobs.insert(job->id, job);
+    order.append(job->id);
+    emit jobAdded(job->id);
+
+    {
+        QMutexLocker locker(&queueMutex);
+        pending[priority].push_back(job);
+        signalWorkers();
+    }
+    if (!progressTimer.isActive()) progressTimer.start();
+    return job->id;
+}
+
+void JobScheduler::cancel(int id)
+{
+    std::shared_ptr<Job> job = jobs.value(id);
+    if (!job) return;
+
+    job->context.cancelRequested.store(true);
+
+    // Still queued: it will never start, so report it now
+    bool wasQueued = false;
+    {
+        QMutexLocker locker(&queueMutex);
+        int expected = Queued;
+        wasQueued = job->state.compare_exchange_strong(expected, Cancelled);
+    }
+    if (wasQueued) {
+        emit jobUpdated(id);
+        emit jobFinished(id, false, "Annulé");
+        if (job->onDone) job->onDone(false, "Annulé");
+    }
+}
+
+void JobScheduler::cancelAll()
+{
+    for (int id : order) cancel(id);
+}
+
+void JobScheduler::setMaxConcurrentJobs(int count)
+{
+    QMutexLocker locker(&queueMutex);
+    maxRunning = qMax(1, count);
+    signalWorkers();
+}
+
+JobScheduler::JobInfo JobScheduler::info(int id) const
+{
+    JobInfo result;
+    std::shared_ptr<Job> job = jobs.value(id);
+    if (!job) return result;
+
+    result.id = job->id;
+    result.title = job->title;
+    result.priority = job->priority;
+    result.state = State(job->state.load());
+    result.done = job->context.done.load(std::memory_order_relaxed);
+    result.total = job->context.total.load(std::memory_order_relaxed);
+    QMutexLocker locker(&job->context.textMutex);
+    result.status = job->context.error.isEmpty() ? job->context.status : job->context.error;
+    return result;
+}
+
+QList<int> JobScheduler::jobIds() const
+{
+    return order;
+}
+
+void JobScheduler::clearFinished()
+{
+    for (int i = order.size() - 1; i >= 0; --i) {
+        int state = jobs.value(order[i])->state.load();
+        if (state != Queued && state != Running) {
+            jobs.remove(order[i]);
+            order.removeAt(i);
+        }
+    }
+}
+
+QString JobScheduler::stateName(State state)
+{
+    switch (state) {
+    case Queued:    return "En attente";
+    case Running:   return "En cours";
+    case Finished:  return "Terminé";
+    case Failed:    return "Échec";
+    case Cancelled: return "Annulé";
+    }
+    return QString();
+}
+
+void JobScheduler::publishProgress()
+{
+    // Coalesced: at most one update per job per tick, however often it reports
+    bool active = false;
+    for (int id : order) {
+        const std::shared_ptr<Job>& job = jobs[id];
+        int state = job->state.load();
+        if (state == Queued || state == Running) active = true;
+        if (job->context.dirty.exchange(false, std::memory_order_acq_rel)) {
+            emit jobUpdated(id);
+        }
+    }
+    if (!active) progressTimer.stop();
+}
+
+void JobScheduler::workerLoop(int index)
+{
+    currentWorker = index;
+    while (true) {
+        // Read before looking for work: a push() during the search is not missed
+        quint64 seen;
+        {
+            QMutexLocker locker(&queueMutex);
+            if (stopping) return;
+            seen = wakeups;
+        }
+
+        if (runOneTask(index)) continue;
+
+        std::shared_ptr<Job> job = takeJob();
+        if (job) {
+            runJob(job);
+            continue;
+        }
+
+        QMutexLocker locker(&queueMutex);
+        while (!stopping && wakeups == seen) {
+            wake.wait(&queueMutex);
+        }
+    }
+}
+
+void JobScheduler::signalWorkers()
+{
+    ++wakeups;
+    wake.wakeAll();
+}
+
+bool JobScheduler::popLocal(int index, Task& task)
+{
+    Worker& worker = *workers[index];
+    QMutexLocker locker(&worker.mutex);
+    if (worker.tasks.empty()) return false;
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool JobScheduler::steal(int thief, Task& task)
+{
+    int count = int(workers.size());
+    int start = thief >= 0 ? thief + 1 : 0;
+    for (int k = 0; k < count; ++k) {
+        int victim = (start + k) % count;
+        if (victim == thief) continue;
+        Worker& worker = *workers[victim];
+        QMutexLocker locker(&worker.mutex);
+        if (worker.tasks.empty()) continue;
+        task = std::move(worker.tasks.front());
+        worker.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+bool JobScheduler::runOneTask(int index)
+{
+    Task task;
+    if ((index >= 0 && popLocal(index, task)) || steal(index, task)) {
+        task();
+        return true;
+    }
+    return false;
+}
+
+std::shared_ptr<JobScheduler::Job> JobScheduler::takeJob()
+{
+    QMutexLocker locker(&queueMutex);
+    if (stopping || running >= maxRunning) return nullptr;
+
+    for (auto& queue : pending) {
+        while (!queue.empty()) {
+            std::shared_ptr<Job> job = queue.front();
+            queue.pop_front();
+            int expected = Queued;
+            if (job->state.compare_exchange_strong(expected, Running)) {
+                running++;
+                return job;
+            }
+            // Cancelled while queued, already reported
+        }
+    }
+    return nullptr;
+}
+
+void JobScheduler::runJob(const std::shared_ptr<Job>& job)
+{
+    TRACE_SCOPE("JobScheduler::runJob");
+    JobContext& context = job->context;
+    context.dirty.store(true);
+
+    bool ok = !context.isCancelled() && job->work(context);
+    State outcome = context.isCancelled() ? Cancelled : (ok ? Finished : Failed);
+    job->state.store(outcome);
+    job->work = Work();     // release captured snapshots now, not when the entry is cleared
+
+    {
+        QMutexLocker locker(&queueMutex);
+        running--;
+        signalWorkers();
+    }
+
+    QMetaObject::invokeMethod(this, [this, job, outcome]() {
+        QString message;
+        {
+            QMutexLocker locker(&job->context.textMutex);
+            message = outcome == Cancelled ? QString("Annulé")
+                                         : (job->context.error.isEmpty() ? job->context.status
+                                                                         : job->context.error);
+        }
+        emit jobUpdated(job->id);
+        emit jobFinished(job->id, outcome == Finished, message);
+        if (job->onDone) job->onDone(outcome == Finished, message);
+    }, Qt::QueuedConnection);
+}
+
+void JobScheduler::push(Task task)
+{
+    int target = currentWorker >= 0 ? currentWorker : 0;
+    {
+        Worker& worker = *workers[target];
+        QMutexLocker locker(&worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    QMutexLocker locker(&queueMutex);
+    signalWorkers();
+}
@@ -0,0 +1,154 @@
+#ifndef JOBSCHEDULER_H
+#define JOBSCHEDULER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QTimer>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class JobScheduler;
+
+/**
+ * Handed to a running job: progress, status text, cooperative cancellation
+ * and fork-join parallelism on the scheduler's workers. All methods are
+ * thread-safe; progress is picked up by the GUI at most every 100 ms, so
+ * reporting it per row costs two atomic stores.
+ */
+class JobContext
+{
+public:
+    bool isCancelled() const { return cancelRequested.load(std::memory_order_relaxed); }
+    void setProgress(qint64 done, qint64 total);
+    void setStatus(const QString& text);
+    void fail(const QString& message);      // shown when the job returns false
+
+    // Runs fn(0..count-1) on this worker and any idle one that steals a part.
+    // Returns when every index has run (indexes are skipped once cancelled).
+    void parallelFor(int count, const std::function<void(int)>& fn);
+
+private:
+    friend class JobScheduler;
+
+    JobScheduler *scheduler = nullptr;
+    std::atomic<bool> cancelRequested{false};
+    std::atomic<qint64> done{0};
+    std::atomic<qint64> total{0};
+    std::atomic<bool> dirty{false};
+    mutable QMutex textMutex;
+    QString status;
+    QString error;
+};
+
+/**
+ * Background jobs on a work-stealing pool
+ *
+ * Each worker owns a deque of tasks: it pushes and pops at the back and
+ * idle workers steal from the front. Top-level jobs wait in two priority
+ * queues (interactive before batch); at most maxConcurrentJobs of them run
+ * at once, which leaves workers free to steal the parts of the running
+ * jobs. Completion callbacks run on the thread that owns the scheduler.
+ */
+class JobScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority { Interactive, Batch };
+    enum State { Queued, Running, Finished, Failed, Cancelled };
+
+    using Work = std::function<bool(JobContext&)>;
+    using Done = std::function<void(bool ok, const QString& message)>;
+
+    struct JobInfo {
+        int id = 0;
+        QString title;
+        Priority priority = Batch;
+        State state = Queued;
+        qint64 done = 0;
+        qint64 total = 0;
+        QString status;
+    };
+
+    explicit JobScheduler(int threads = 0, QObject *parent = nullptr);
+    ~JobScheduler();
+
+    int submit(const QString& title, Priority priority, Work work, Done onDone = Done());
+    void cancel(int id);
+    void cancelAll();
+
+    void setMaxConcurrentJobs(int count);
+    int maxConcurrentJobs() const { return maxRunning; }
+    int workerCount() const { return int(workers.size()); }
+
+    JobInfo info(int id) const;
+    QList<int> jobIds() const;          // submission order, finished ones included
+    void clearFinished();
+
+    static QString stateName(State state);
+
+signals:
+    void jobAdded(int id);
+    void jobUpdated(int id);            // progress or state changed
+    void jobFinished(int id, bool ok, const QString& message);
+
+private slots:
+    void publishProgress();
+
+private:
+    friend class JobContext;
+
+    using Task = std::function<void()>;
+
+    struct Job {
+        int id;
+        QString title;
+        Priority priority;
+        Work work;
+        Done onDone;
+        std::atomic<int> state{Queued};
+        JobContext context;
+    };
+
+    struct Worker {
+        QMutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Guarded by queueMutex
+    mutable QMutex queueMutex;
+    QWaitCondition wake;
+    std::deque<std::shared_ptr<Job>> pending[2];
+    int running;
+    int maxRunning;
+    bool stopping;
+    quint64 wakeups;    // bumped by every signal: a worker sleeps only if it saw none
+
+    // GUI-thread side
+    QHash<int, std::shared_ptr<Job>> jobs;
+    QList<int> order;
+    int nextId;
+    QTimer progressTimer;
+
+    void workerLoop(int index);
+    void signalWorkers();               // queueMutex held
+    bool popLocal(int index, Task& task);
+    bool steal(int thief, Task& task);
+    bool runOneTask(int index);
+    std::shared_ptr<Job> takeJob();
+    void runJob(const std::shared_ptr<Job>& job);
+    void push(Task task);
+};
+
+#endif // JOBSCHEDULER_H
@@ -0,0 +1,109 @@
+#include "jobspanel.h"
+#include "jobscheduler.h"
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+
+// ===== JobsPanel Implementation =====
+JobsPanel::JobsPanel(JobScheduler *scheduler, QWidget *parent)
+    : QDockWidget("🧵 Tâches en arrière-plan", parent), scheduler(scheduler)
+{
+    setObjectName("jobsPanel");
+
+    QWidget *content = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(content);
+
+    table = new QTableWidget(0, 4, content);
+    table->setHorizontalHeaderLabels({"Tâche", "Priorité", "État", "Progression"});
+    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    table->verticalHeader()->setVisible(false);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    layout->addWidget(table);
+
+    QHBoxLayout *buttons = new QHBoxLayout();
+    QPushButton *cancelButton = new QPushButton("⛔ Annuler", content);
+    QPushButton *clearButton = new QPushButton("🧹 Retirer les tâches terminées", content);
+    buttons->addWidget(cancelButton);
+    buttons->addWidget(clearButton);
+    buttons->addStretch();
+    layout->addLayout(buttons);
+
+    setWidget(content);
+
+    connect(cancelButton, &QPushButton::clicked, this, &JobsPanel::onCancelClicked);
+    connect(clearButton, &QPushButton::clicked, this, &JobsPanel::onClearClicked);
+    connect(scheduler, &JobScheduler::jobAdded, this, &JobsPanel::onJobAdded);
+    connect(scheduler, &JobScheduler::jobUpdated, this, &JobsPanel::onJobUpdated);
+
+    rebuild();
+}
+
+void JobsPanel::onJobAdded(int id)
+{
+    int row = table->rowCount();
+    table->insertRow(row);
+    rowOfJob.insert(id, row);
+
+    JobScheduler::JobInfo job = scheduler->info(id);
+    QTableWidgetItem *title = new QTableWidgetItem(job.title);
+    title->setData(Qt::UserRole, id);
+    table->setItem(row, 0, title);
+    table->setItem(row, 1, new QTableWidgetItem(job.priority == JobScheduler::Interactive ? "Interactive" : "Lot"));
+    table->setItem(row, 2, new QTableWidgetItem());
+    QProgressBar *bar = new QProgressBar(table);
+    bar->setRange(0, 0);    // busy indicator until the job reports a total
+    table->setCellWidget(row, 3, bar);
+    onJobUpdated(id);
+}
+
+void JobsPanel::onJobUpdated(int id)
+{
+    auto it = rowOfJob.constFind(id);
+    if (it == rowOfJob.constEnd()) return;
+    int row = it.value();
+
+    JobScheduler::JobInfo job = scheduler->info(id);
+    QString state = JobScheduler::stateName(job.state);
+    if (!job.status.isEmpty()) state += " — " + job.status;
+    table->item(row, 2)->setText(state);
+
+    QProgressBar *bar = static_cast<QProgressBar*>(table->cellWidget(row, 3));
+    bool over = job.state != JobScheduler::Queued && job.state != JobScheduler::Running;
+    if (over) {
+        bar->setRange(0, 1);
+        bar->setValue(job.state == JobScheduler::Finished ? 1 : 0);
+    } else if (job.total > 0) {
+        // Per mille keeps the range within int for any row count
+        bar->setRange(0, 1000);
+        bar->setValue(int(job.done * 1000 / job.total));
+    }
+}
+
+void JobsPanel::onCancelClicked()
+{
+    const QList<QTableWidgetItem*> selected = table->selectedItems();
+    for (QTableWidgetItem *item : selected) {
+        if (item->column() == 0) {
+            scheduler->cancel(item->data(Qt::UserRole).toInt());
+        }
+    }
+}
+
+void JobsPanel::onClearClicked()
+{
+    scheduler->clearFinished();
+    rebuild();
+}
+
+void JobsPanel::rebuild()
+{
+    table->setRowCount(0);
+    rowOfJob.clear();
+    for (int id : scheduler->jobIds()) {
+        onJobAdded(id);
+    }
+}
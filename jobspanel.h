@@ -0,0 +1,36 @@
+#ifndef JOBSPANEL_H
+#define JOBSPANEL_H
+
+#include <QDockWidget>
+#include <QHash>
+
+class QTableWidget;
+class QProgressBar;
+class JobScheduler;
+
+/**
+ * Non-modal list of background jobs: state, progress and cancellation.
+ * Only the row of a job that reported something is touched on an update.
+ */
+class JobsPanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit JobsPanel(JobScheduler *scheduler, QWidget *parent = nullptr);
+
+private slots:
+    void onJobAdded(int id);
+    void onJobUpdated(int id);
+    void onCancelClicked();
+    void onClearClicked();
+
+private:
+    JobScheduler *scheduler;
+    QTableWidget *table;
+    QHash<int, int> rowOfJob;
+
+    void rebuild();
+};
+
+#endif // JOBSPANEL_H
@@ -0,0 +1,159 @@
+#include "jsonreloader.h"
+#include "tracing.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonParseError>
+#include <QtConcurrent>
+#include <QDebug>
+
+// ===== JsonFileReloader Implementation =====
+JsonFileReloader::JsonFileReloader(QObject *parent)
+    : QObject(parent), lastFileHash(0), rescanPending(false)
+{
+    settleTimer.setSingleShot(true);
+    settleTimer.setInterval(200);
+    connect(&watcher, &QFileSystemWatcher::fileChanged, this, &JsonFileReloader::onFileChanged);
+    connect(&settleTimer, &QTimer::timeout, this, &JsonFileReloader::reloadNow);
+    connect(&scanWatcher, &QFutureWatcher<Diff>::finished, this, &JsonFileReloader::onScanFinished);
+}
+
+void JsonFileReloader::start(const QString& file, const QList<Fournisseur>& loaded)
+{
+    stop();
+    fileName = QFileInfo(file).absoluteFilePath();
+
+    baseline.clear();
+    baseline.reserve(loaded.size());
+    for (const Fournisseur& f : loaded) {
+        baseline.insert(f.getIdFournisseur(), recordHash(f));
+    }
+    lastFileHash = 0;
+    watchFile();
+}
+
+void JsonFileReloader::stop()
+{
+    settleTimer.stop();
+    if (!watcher.files().isEmpty()) {
+        watcher.removePaths(watcher.files());
+    }
+    fileName.clear();
+    rescanPending = false;
+}
+
+void JsonFileReloader::watchFile()
+{
+    // Writers that replace the file (save to temp + rename) drop it from the watch list
+    if (!fileName.isEmpty() && !watcher.files().contains(fileName) && QFile::exists(fileName)) {
+        watcher.addPath(fileName);
+    }
+}
+
+void JsonFileReloader::onFileChanged(const QString& path)
+{
+    Q_UNUSED(path);
+    watchFile();
+    settleTimer.start();
+}
+
+void JsonFileReloader::reloadNow()
+{
+    if (fileName.isEmpty()) return;
+    watchFile();
+
+    // One scan at a time; a change during the scan triggers one more afterwards
+    if (scanWatcher.isRunning()) {
+        rescanPending = true;
+        return;
+    }
+
+    QString file = fileName;
+    QHash<int, size_t> known = baseline;   // implicitly shared, no copy unless modified
+    size_t knownFileHash = lastFileHash;
+    scanWatcher.setFuture(QtConcurrent::run([file, known, knownFileHash]() {
+        return scan(file, known, knownFileHash);
+    }));
+}
+
+void JsonFileReloader::onScanFinished()
+{
+    Diff diff = scanWatcher.result();
+
+    if (!diff.ok) {
+        // Usually a writer caught mid-save; the next change notification retries
+        qDebug() << "⚠️ Rechargement JSON ignoré:" << diff.error;
+        emit reloadFailed(diff.error);
+    } else if (!diff.unchanged) {
+        baseline = diff.hashes;
+        lastFileHash = diff.fileHash;
+        if (!diff.upserts.isEmpty() || !diff.deletedIds.isEmpty()) {
+            emit changesReady(diff.upserts, diff.deletedIds);
+        }
+    }
+
+    if (rescanPending) {
+        rescanPending = false;
+        reloadNow();
+    }
+}
+
+size_t JsonFileReloader::recordHash(const Fournisseur& f)
+{
+    return qHash(QJsonDocument(f.toJson()).toJson(QJsonDocument::Compact));
+}
+
+JsonFileReloader::Diff JsonFileReloader::scan(const QString& fileName, const QHash<int, size_t>& baseline,
+                                              size_t lastFileHash)
+{
+    TRACE_SCOPE("JsonFileReloader::scan");
+    Diff diff;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        diff.error = file.errorString();
+        return diff;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+
+    diff.fileHash = qHash(data);
+    if (diff.fileHash == lastFileHash) {
+        diff.ok = true;
+        diff.unchanged = true;
+        return diff;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+    if (!doc.isArray()) {
+        diff.error = parseError.error != QJsonParseError::NoError ? parseError.errorString()
+                                                                  : QString("tableau JSON attendu");
+        return diff;
+    }
+
+    QJsonArray jsonArray = doc.array();
+    diff.hashes.reserve(jsonArray.size());
+    for (const QJsonValue& value : jsonArray) {
+        if (!value.isObject()) continue;
+
+        Fournisseur f = Fournisseur::fromJson(value.toObject());
+        size_t hash = recordHash(f);
+        diff.hashes.insert(f.getIdFournisseur(), hash);
+
+        auto it = baseline.constFind(f.getIdFournisseur());
+        if (it == baseline.constEnd() || it.value() != hash) {
+            diff.upserts.append(f);
+        }
+    }
+
+    for (auto it = baseline.constBegin(); it != baseline.constEnd(); ++it) {
+        if (!diff.hashes.contains(it.key())) {
+            diff.deletedIds.append(it.key());
+        }
+    }
+
+    diff.ok = true;
+    return diff;
+}
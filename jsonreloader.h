@@ -0,0 +1,70 @@
+#ifndef JSONRELOADER_H
+#define JSONRELOADER_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include "fournisseur.h"
+
+/**
+ * Hot reload of the JSON data file
+ *
+ * Watches the file, parses it on a pool thread when it changes and compares
+ * every record (by id and content hash) with the file as last seen. Only
+ * the differences are delivered, so the GUI work is proportional to what
+ * changed. Our own saves come back as records equal to the in-memory ones,
+ * which the receiver skips.
+ */
+class JsonFileReloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Diff {
+        QList<Fournisseur> upserts;
+        QList<int> deletedIds;
+        QHash<int, size_t> hashes;   // new baseline
+        size_t fileHash = 0;
+        bool ok = false;
+        bool unchanged = false;
+        QString error;
+    };
+
+    explicit JsonFileReloader(QObject *parent = nullptr);
+
+    // 'loaded' must be the content the file had when it was read
+    void start(const QString& fileName, const QList<Fournisseur>& loaded);
+    void stop();
+    bool isActive() const { return !fileName.isEmpty(); }
+
+    static size_t recordHash(const Fournisseur& f);
+    static Diff scan(const QString& fileName, const QHash<int, size_t>& baseline, size_t lastFileHash);
+
+public slots:
+    // Re-read immediately (e.g. after a backup was restored over the file)
+    void reloadNow();
+
+signals:
+    void changesReady(const QList<Fournisseur>& upserts, const QList<int>& deletedIds);
+    void reloadFailed(const QString& error);
+
+private slots:
+    void onFileChanged(const QString& path);
+    void onScanFinished();
+
+private:
+    QString fileName;
+    QFileSystemWatcher watcher;
+    QTimer settleTimer;            // editors write in bursts; wait for the last one
+    QFutureWatcher<Diff> scanWatcher;
+    QHash<int, size_t> baseline;
+    size_t lastFileHash;
+    bool rescanPending;
+
+    void watchFile();
+};
+
+#endif // JSONRELOADER_H
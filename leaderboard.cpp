@@ -0,0 +1,89 @@
+#include "leaderboard.h"
+#include "memorytracker.h"
+
+// ===== SupplierLeaderboard Implementation =====
+SupplierLeaderboard::SupplierLeaderboard()
+    : changes(0)
+{
+}
+
+void SupplierLeaderboard::update(int fournisseurId, quint32 category, double score, const QString& nom)
+{
+    auto it = placement.find(fournisseurId);
+    if (it != placement.end()) {
+        if (it->category == category && it->score == score) {
+            if (it->nom != nom) {
+                it->nom = nom;
+                changes++;
+            }
+            return;
+        }
+        erase(fournisseurId, *it);
+        *it = { category, score, nom };
+    } else {
+        placement.insert(fournisseurId, { category, score, nom });
+    }
+
+    Key key{ score, fournisseurId };
+    global.insert(key);
+    boards[category].insert(key);
+    changes++;
+}
+
+void SupplierLeaderboard::remove(int fournisseurId)
+{
+    auto it = placement.find(fournisseurId);
+    if (it == placement.end()) return;
+    erase(fournisseurId, *it);
+    placement.erase(it);
+    changes++;
+}
+
+void SupplierLeaderboard::erase(int fournisseurId, const Placement& where)
+{
+    Key key{ where.score, fournisseurId };
+    global.erase(key);
+    auto board = boards.find(where.category);
+    if (board == boards.end()) return;
+    board->erase(key);
+    if (board->empty()) boards.erase(board);
+}
+
+void SupplierLeaderboard::clear()
+{
+    global.clear();
+    boards.clear();
+    placement.clear();
+    changes++;
+}
+
+QVector<SupplierLeaderboard::Entry> SupplierLeaderboard::top(int k, quint32 category) const
+{
+    QVector<Entry> entries;
+    const Board *board = &global;
+    if (category != Global) {
+        auto it = boards.constFind(category);
+        if (it == boards.constEnd()) return entries;
+        board = &it.value();
+    }
+
+    entries.reserve(qMin(k, int(board->size())));
+    for (auto it = board->begin(); it != board->end() && entries.size() < k; ++it) {
+        entries.append({ it->id, it->score, placement.value(it->id).nom });
+    }
+    return entries;
+}
+
+int SupplierLeaderboard::count(quint32 category) const
+{
+    if (category == Global) return int(global.size());
+    auto it = boards.constFind(category);
+    return it != boards.constEnd() ? int(it->size()) : 0;
+}
+
+qint64 SupplierLeaderboard::memoryUsage() const
+{
+    return MemoryAccounting::estimateTreeNodes(qint64(global.size()) * 2, qint64(sizeof(Key))) +
+           qint64(placement.capacity()) * qint64(sizeof(Placement) + sizeof(int) + sizeof(void*)) +
+           qint64(boards.capacity()) * qint64(sizeof(Board) + sizeof(quint32) + sizeof(void*));
+}
@@ -0,0 +1,66 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <set>
+
+/**
+ * Best rated suppliers, globally and per category (product type code)
+ *
+ * Each board is an ordered tree keyed by (score desc, id): a rating or a
+ * supplier change moves one entry in O(log n), and the top K is read off
+ * the front of the tree in O(K) whatever the catalog size. Only rated
+ * suppliers are ranked.
+ */
+class SupplierLeaderboard
+{
+public:
+    struct Entry {
+        int fournisseurId;
+        double score;
+        QString nom;
+    };
+
+    static constexpr quint32 Global = 0xFFFFFFFFu;
+
+    SupplierLeaderboard();
+
+    // Inserts the supplier or moves it to its new category / score
+    void update(int fournisseurId, quint32 category, double score, const QString& nom);
+    void remove(int fournisseurId);
+    void clear();
+
+    QVector<Entry> top(int k, quint32 category = Global) const;
+    int count(quint32 category = Global) const;
+    bool contains(int fournisseurId) const { return placement.contains(fournisseurId); }
+    QList<quint32> categories() const { return boards.keys(); }
+    quint64 version() const { return changes; }     // bumped by every change
+    qint64 memoryUsage() const;
+
+private:
+    struct Key {
+        double score;
+        int id;
+        bool operator<(const Key& other) const {
+            return score != other.score ? score > other.score : id < other.id;
+        }
+    };
+    struct Placement {
+        quint32 category;
+        double score;
+        QString nom;
+    };
+    using Board = std::set<Key>;
+
+    Board global;
+    QHash<quint32, Board> boards;
+    QHash<int, Placement> placement;
+    quint64 changes;
+
+    void erase(int fournisseurId, const Placement& where);
+};
+
+#endif // LEADERBOARD_H
@@ -0,0 +1,111 @@
+#include "leaderboardpanel.h"
+#include "leaderboard.h"
+#include "fournisseur.h"
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QLabel>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <algorithm>
+
+// ===== LeaderboardPanel Implementation =====
+LeaderboardPanel::LeaderboardPanel(const SupplierLeaderboard *leaderboard, QWidget *parent)
+    : QDockWidget("🏆 Meilleurs Fournisseurs", parent), leaderboard(leaderboard), shownVersion(~0ULL)
+{
+    setObjectName("leaderboardPanel");
+
+    QWidget *content = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(content);
+
+    QHBoxLayout *controls = new QHBoxLayout();
+    categoryBox = new QComboBox(content);
+    categoryBox->addItem("Tous", SupplierLeaderboard::Global);
+    sizeSpin = new QSpinBox(content);
+    sizeSpin->setRange(1, 100);
+    sizeSpin->setValue(10);
+    controls->addWidget(new QLabel("Type:", content));
+    controls->addWidget(categoryBox, 1);
+    controls->addWidget(new QLabel("Top:", content));
+    controls->addWidget(sizeSpin);
+    layout->addLayout(controls);
+
+    table = new QTableWidget(0, 3, content);
+    table->setHorizontalHeaderLabels({"#", "Fournisseur", "Note"});
+    table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+    table->verticalHeader()->setVisible(false);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    layout->addWidget(table);
+
+    setWidget(content);
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setSingleShot(true);
+    refreshTimer->setInterval(100);
+
+    connect(refreshTimer, &QTimer::timeout, this, &LeaderboardPanel::refresh);
+    connect(this, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) refresh();
+    });
+    connect(categoryBox, &QComboBox::currentIndexChanged, this, [this]() {
+        shownVersion = ~0ULL;
+        refresh();
+    });
+    connect(sizeSpin, &QSpinBox::valueChanged, this, [this]() {
+        shownVersion = ~0ULL;
+        refresh();
+    });
+    connect(table, &QTableWidget::cellDoubleClicked, this, [this](int row) {
+        emit supplierActivated(table->item(row, 1)->data(Qt::UserRole).toInt());
+    });
+}
+
+void LeaderboardPanel::scheduleRefresh()
+{
+    if (!refreshTimer->isActive()) refreshTimer->start();
+}
+
+void LeaderboardPanel::refresh()
+{
+    if (!isVisible() || leaderboard->version() == shownVersion) return;
+    shownVersion = leaderboard->version();
+    updateCategories();
+
+    quint32 category = categoryBox->currentData().toUInt();
+    const QVector<SupplierLeaderboard::Entry> entries = leaderboard->top(sizeSpin->value(), category);
+    table->setRowCount(entries.size());
+    for (int row = 0; row < entries.size(); ++row) {
+        const SupplierLeaderboard::Entry& entry = entries[row];
+        QTableWidgetItem *nom = new QTableWidgetItem(entry.nom);
+        nom->setData(Qt::UserRole, entry.fournisseurId);
+        table->setItem(row, 0, new QTableWidgetItem(QString::number(row + 1)));
+        table->setItem(row, 1, nom);
+        table->setItem(row, 2, new QTableWidgetItem(QString::number(entry.score, 'f', 2)));
+    }
+}
+
+void LeaderboardPanel::updateCategories()
+{
+    // Types come and go with the suppliers; keep the current choice if it still exists
+    QList<quint32> codes = leaderboard->categories();
+    std::sort(codes.begin(), codes.end(), [](quint32 a, quint32 b) {
+        return ProductTypes::label(a) < ProductTypes::label(b);
+    });
+    QList<quint32> shown;
+    for (int i = 1; i < categoryBox->count(); ++i) shown.append(categoryBox->itemData(i).toUInt());
+    if (shown == codes) return;
+
+    quint32 current = categoryBox->currentData().toUInt();
+    QSignalBlocker blocker(categoryBox);
+    categoryBox->clear();
+    categoryBox->addItem("Tous", SupplierLeaderboard::Global);
+    for (quint32 code : codes) {
+        QString label = ProductTypes::label(code);
+        categoryBox->addItem(label.isEmpty() ? "Non spécifié" : label, code);
+    }
+    int index = categoryBox->findData(current);
+    categoryBox->setCurrentIndex(index >= 0 ? index : 0);
+}
@@ -0,0 +1,43 @@
+#ifndef LEADERBOARDPANEL_H
+#define LEADERBOARDPANEL_H
+
+#include <QDockWidget>
+
+class QTableWidget;
+class QComboBox;
+class QSpinBox;
+class QTimer;
+class SupplierLeaderboard;
+
+/**
+ * Live top-K of a SupplierLeaderboard, "Tous" or one product type.
+ * Changes only schedule a refresh; it runs once, and only when visible.
+ */
+class LeaderboardPanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LeaderboardPanel(const SupplierLeaderboard *leaderboard, QWidget *parent = nullptr);
+
+public slots:
+    void scheduleRefresh();
+
+signals:
+    void supplierActivated(int fournisseurId);
+
+private slots:
+    void refresh();
+
+private:
+    const SupplierLeaderboard *leaderboard;
+    QComboBox *categoryBox;
+    QSpinBox *sizeSpin;
+    QTableWidget *table;
+    QTimer *refreshTimer;
+    quint64 shownVersion;
+
+    void updateCategories();
+};
+
+#endif // LEADERBOARDPANEL_H
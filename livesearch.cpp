@@ -0,0 +1,72 @@
+#include "livesearch.h"
+
+IncrementalSearch::IncrementalSearch()
+    : cursor(0), datasetSize(0), fullScan(true), finished(true), refining(false)
+{
+}
+
+void IncrementalSearch::reset(int size)
+{
+    datasetSize = size;
+    currentQuery.clear();
+    completedQuery.clear();
+    completedResults.clear();
+    candidates.clear();
+    matches.clear();
+    cursor = 0;
+    fullScan = true;
+    finished = true;
+    refining = false;
+}
+
+void IncrementalSearch::begin(const QString& query)
+{
+    currentQuery = query;
+    matches.clear();
+    cursor = 0;
+    finished = false;
+
+    // Refine only from a result set that is complete; a cancelled query
+    // left 'matches' half-filled and cannot be trusted.
+    refining = !completedQuery.isEmpty() &&
+               query.contains(completedQuery, Qt::CaseInsensitive);
+
+    if (refining) {
+        candidates = completedResults;
+        fullScan = false;
+    } else {
+        candidates.clear();
+        fullScan = true;
+    }
+}
+
+bool IncrementalSearch::step(const QList<Fournisseur>& fournisseurs, int budget)
+{
+    if (finished) return true;
+
+    int total = fullScan ? qMin(datasetSize, fournisseurs.size()) : candidates.size();
+    int end = qMin(total, cursor + budget);
+
+    for (; cursor < end; ++cursor) {
+        int index = fullScan ? cursor : candidates[cursor];
+        if (index < fournisseurs.size() && matchesQuery(fournisseurs[index], currentQuery)) {
+            matches.append(index);
+        }
+    }
+
+    if (cursor >= total) {
+        finished = true;
+        completedQuery = currentQuery;
+        completedResults = matches;
+        candidates.clear();
+    }
+
+    return finished;
+}
+
+bool IncrementalSearch::matchesQuery(const Fournisseur& f, const QString& query)
+{
+    return QString::number(f.getIdFournisseur()).contains(query) ||
+           f.getNom().contains(query, Qt::CaseInsensitive) ||
+           f.getEmail().contains(query, Qt::CaseInsensitive);
+}
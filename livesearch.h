@@ -0,0 +1,53 @@
+#ifndef LIVESEARCH_H
+#define LIVESEARCH_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include "fournisseur.h"
+
+/**
+ * Incremental search-as-you-type
+ *
+ * A query is evaluated in small steps so the GUI can interleave keystrokes.
+ * When the new query contains the last completed one, only the previous
+ * result set is re-filtered (every match is a substring match, so the new
+ * result is always a subset of the old one).
+ */
+class IncrementalSearch
+{
+private:
+    QString currentQuery;
+    QVector<int> candidates;      // indexes to scan, empty = full scan
+    QVector<int> matches;         // indexes into the supplier list, ascending
+    int cursor;
+    int datasetSize;
+    bool fullScan;
+    bool finished;
+    bool refining;
+
+    // Last query that ran to completion, reused for refinement
+    QString completedQuery;
+    QVector<int> completedResults;
+
+public:
+    IncrementalSearch();
+
+    // Invalidates cached results (call whenever the supplier list changes)
+    void reset(int size);
+
+    // Starts a new query, abandoning any query still in progress
+    void begin(const QString& query);
+
+    // Scans up to 'budget' candidates; returns true when the query is done
+    bool step(const QList<Fournisseur>& fournisseurs, int budget = 20000);
+
+    bool isFinished() const { return finished; }
+    bool isRefinement() const { return refining; }
+    QString getQuery() const { return currentQuery; }
+    const QVector<int>& getResults() const { return matches; }
+
+    static bool matchesQuery(const Fournisseur& f, const QString& query);
+};
+
+#endif // LIVESEARCH_H
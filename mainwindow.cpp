@@ -5,8 +5,6 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
-#include <QPrinter>
-#include <QPainter>
 #include <QFileDialog>
 #include <QInputDialog>
 #include <QMenu>
@@ -17,7 +15,51 @@
 #include <QSlider>
 #include <QTextEdit>
 #include <QListWidget>
+#include <QSet>
+#include <QCompleter>
+#include <QStringListModel>
+#include <QRegularExpression>
+#include <QScrollBar>
+#include <QFileInfo>
+#include <QDateEdit>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QComboBox>
+#include "tracing.h"
+#include "memorytracker.h"
+#include "reportengine.h"
+#include "leaderboardpanel.h"
 #include <algorithm>
+#include <functional>
+
+namespace {
+
+// Historique column: the text stays compressed until the view asks for it
+class ColdTextItem : public QStandardItem
+{
+public:
+    explicit ColdTextItem(const ColdText& cold) : cold(cold), resolved(false) {}
+
+    QVariant data(int role = Qt::UserRole + 1) const override
+    {
+        if (!resolved && (role == Qt::DisplayRole || role == Qt::EditRole)) return cold.toString();
+        return QStandardItem::data(role);
+    }
+
+    void setData(const QVariant& value, int role = Qt::UserRole + 1) override
+    {
+        if (role == Qt::DisplayRole || role == Qt::EditRole) resolved = true;
+        QStandardItem::setData(value, role);
+    }
+
+    QStandardItem *clone() const override { return new ColdTextItem(*this); }
+
+private:
+    ColdText cold;
+    bool resolved;      // set once the text was replaced through setData()
+};
+
+} // namespace
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -26,16 +68,39 @@ MainWindow::MainWindow(QWidget *parent)
     , currentSelectedId(-1)
     , dbManager(nullptr)
     , useDatabase(false)
+    , deltaSync(nullptr)
+    , jsonReloader(new JsonFileReloader(this))
+    , jobScheduler(new JobScheduler(0, this))
+    , jobsPanel(nullptr)
+    , leaderboardPanel(nullptr)
+    , searchDebounceTimer(new QTimer(this))
+    , searchStepTimer(new QTimer(this))
+    , allRowsVisible(true)
+    , filterActive(false)
+    , fuzzyIndexDirty(true)
 {
     ui->setupUi(this);
     setupTableView();
+    jobsPanel = new JobsPanel(jobScheduler, this);
+    addDockWidget(Qt::BottomDockWidgetArea, jobsPanel);
+    jobsPanel->hide();
+    leaderboardPanel = new LeaderboardPanel(&leaderboard, this);
+    addDockWidget(Qt::RightDockWidgetArea, leaderboardPanel);
+    leaderboardPanel->hide();
+    connect(leaderboardPanel, &LeaderboardPanel::supplierActivated, this, &MainWindow::selectFournisseur);
     createAdvancedMenu();
+    connect(jsonReloader, &JsonFileReloader::changesReady, this, &MainWindow::onJsonFileChanged);
     
-    // Try to connect to Oracle first
+    // Try to connect to Oracle first, then the embedded engine if a journal is configured
     if (connectToOracle()) {
         qDebug() << "✅ Using Oracle Database!";
         useDatabase = true;
         loadFromDatabase();
+    } else if (qEnvironmentVariableIsSet("FOURNISSEUR_JOURNAL") &&
+               connectToMemoryEngine(qEnvironmentVariable("FOURNISSEUR_JOURNAL"))) {
+        qDebug() << "✅ Using the in-memory engine!";
+        useDatabase = true;
+        loadFromDatabase();
     } else {
         qDebug() << "ℹ️ Using JSON files (Oracle not available)";
         useDatabase = false;
@@ -62,6 +127,26 @@ MainWindow::MainWindow(QWidget *parent)
     // Connect Advanced Features Button
     connect(ui->btnAdvancedFeatures, &QPushButton::clicked, this, &MainWindow::onAdvancedFeaturesButtonClicked);
     
+    // Live search: debounce keystrokes, then scan in slices between events
+    searchDebounceTimer->setSingleShot(true);
+    searchDebounceTimer->setInterval(150);
+    searchStepTimer->setInterval(0);
+    connect(ui->lineEdit_8, &QLineEdit::textChanged, this, &MainWindow::onSearchTextChanged);
+    connect(searchDebounceTimer, &QTimer::timeout, this, &MainWindow::onSearchDebounced);
+    connect(searchStepTimer, &QTimer::timeout, this, &MainWindow::onSearchStep);
+    
+    // Autocomplete on nom, adresse (city part) and type produits
+    nomCompleter = createCompleter(ui->lineEdit_3);
+    adresseCompleter = createCompleter(ui->lineEdit_4);
+    typeCompleter = createCompleter(ui->lineEdit_6);
+    connect(ui->lineEdit_3, &QLineEdit::textEdited, this, [this](const QString& text) {
+        showCompletions(nomCompleter, nomCompletions.complete(text));
+    });
+    connect(ui->lineEdit_6, &QLineEdit::textEdited, this, [this](const QString& text) {
+        showCompletions(typeCompleter, typeCompletions.complete(text));
+    });
+    connect(ui->lineEdit_4, &QLineEdit::textEdited, this, &MainWindow::onAdresseEdited);
+    
     addActivityLog("SYSTEM", "Application démarrée");
 }
 
@@ -90,18 +175,59 @@ void MainWindow::setupTableView()
 
 void MainWindow::refreshTableView()
 {
+    TRACE_SCOPE("MainWindow::refreshTableView");
     tableModel->removeRows(0, tableModel->rowCount());
+    filterActive = false;   // the full list replaces any advanced filter
     
     for (const Fournisseur& f : listeFournisseurs) {
-        QList<QStandardItem*> row;
-        row.append(new QStandardItem(QString::number(f.getIdFournisseur())));
-        row.append(new QStandardItem(f.getNom()));
-        row.append(new QStandardItem(f.getAdresse()));
-        row.append(new QStandardItem(f.getEmail()));
-        row.append(new QStandardItem(f.getTelephone()));
-        row.append(new QStandardItem(f.getTypeProduits()));
-        row.append(new QStandardItem(f.getHistoriqueLivraisons()));
-        tableModel->appendRow(row);
+        tableModel->appendRow(makeRow(f));
+    }
+    
+    invalidateSearchState();
+}
+
+int MainWindow::applyFilter(const FilterCriteria& criteria)
+{
+    TRACE_SCOPE("MainWindow::applyFilter");
+    tableModel->removeRows(0, tableModel->rowCount());
+    activeFilter = criteria;
+    filterActive = true;
+    
+    int count = 0;
+    QVector<bool> types = criteria.matchingTypes();
+    for (const Fournisseur& f : listeFournisseurs) {
+        int ratingValue = int(ratingHistory.score(f.getIdFournisseur(), RatingHistory::AllTime));
+        if (criteria.matches(f, ratingValue, types)) {
+            tableModel->appendRow(makeRow(f));
+            count++;
+        }
+    }
+    return count;
+}
+
+QList<QStandardItem*> MainWindow::makeRow(const Fournisseur& f) const
+{
+    QList<QStandardItem*> row;
+    row.append(new QStandardItem(QString::number(f.getIdFournisseur())));
+    row.append(new QStandardItem(f.getNom()));
+    row.append(new QStandardItem(f.getAdresse()));
+    row.append(new QStandardItem(f.getEmail()));
+    row.append(new QStandardItem(f.getTelephone()));
+    row.append(new QStandardItem(f.getTypeProduits()));
+    row.append(new ColdTextItem(f.getHistoriqueRef()));
+    return row;
+}
+
+void MainWindow::invalidateSearchState()
+{
+    // Model rows map 1:1 to listeFournisseurs again; cached results are stale
+    searchStepTimer->stop();
+    liveSearch.reset(listeFournisseurs.size());
+    visibleRows.clear();
+    allRowsVisible = true;
+    fuzzyIndexDirty = true;
+    if (!ui->lineEdit_8->text().trimmed().isEmpty()) {
+        searchDebounceTimer->start();
     }
 }
 
@@ -142,6 +268,131 @@ int MainWindow::generateNewId()
     return maxId + 1;
 }
 
+void MainWindow::indexFournisseur(const Fournisseur& f)
+{
+    contactIndex.insert(f);
+    int code = int(f.getTypeCode());
+    if (code >= typeCounts.size()) typeCounts.resize(ProductTypes::count());
+    typeCounts[code]++;
+    nomCompletions.add(f.getNom());
+    typeCompletions.add(f.getTypeProduits());
+    cityCompletions.add(PrefixIndex::cityOf(f.getAdresse()));
+    rankFournisseur(f);
+}
+
+void MainWindow::unindexFournisseur(const Fournisseur& f)
+{
+    contactIndex.remove(f);
+    leaderboard.remove(f.getIdFournisseur());
+    leaderboardPanel->scheduleRefresh();
+    typeCounts[int(f.getTypeCode())]--;
+    nomCompletions.remove(f.getNom());
+    typeCompletions.remove(f.getTypeProduits());
+    cityCompletions.remove(PrefixIndex::cityOf(f.getAdresse()));
+}
+
+void MainWindow::rebuildIndexes()
+{
+    supplierStore.reset(listeFournisseurs);
+    contactIndex.build(listeFournisseurs);
+    typeCounts.fill(0, ProductTypes::count());
+    QStringList noms, types, cities;
+    for (const Fournisseur& f : listeFournisseurs) {
+        typeCounts[int(f.getTypeCode())]++;
+        noms << f.getNom();
+        types << f.getTypeProduits();
+        cities << PrefixIndex::cityOf(f.getAdresse());
+    }
+    nomCompletions.build(noms);
+    typeCompletions.build(types);
+    cityCompletions.build(cities);
+    rebuildLeaderboard();
+}
+
+void MainWindow::rankFournisseur(const Fournisseur& f)
+{
+    if (!ratingHistory.contains(f.getIdFournisseur())) return;
+    leaderboard.update(f.getIdFournisseur(), f.getTypeCode(),
+                       ratingHistory.score(f.getIdFournisseur(), RatingHistory::AllTime), f.getNom());
+    leaderboardPanel->scheduleRefresh();
+}
+
+void MainWindow::rebuildLeaderboard()
+{
+    TRACE_SCOPE("MainWindow::rebuildLeaderboard");
+    leaderboard.clear();
+    for (const Fournisseur& f : listeFournisseurs) {
+        rankFournisseur(f);
+    }
+    leaderboardPanel->scheduleRefresh();
+}
+
+void MainWindow::selectFournisseur(int fournisseurId)
+{
+    for (int row = 0; row < listeFournisseurs.size(); ++row) {
+        if (listeFournisseurs[row].getIdFournisseur() == fournisseurId) {
+            // The filter dialog may have left only some of the rows in the model
+            if (tableModel->rowCount() != listeFournisseurs.size()) refreshTableView();
+            showAllRows();
+            ui->tableView->selectRow(row);
+            ui->tableView->scrollTo(tableModel->index(row, 0));
+            return;
+        }
+    }
+}
+
+QCompleter* MainWindow::createCompleter(QLineEdit *edit)
+{
+    // The model only ever holds the top-k completions of the current prefix
+    QCompleter *completer = new QCompleter(new QStringListModel(this), this);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    edit->setCompleter(completer);
+    return completer;
+}
+
+void MainWindow::showCompletions(QCompleter *completer, const QStringList& items)
+{
+    QStringListModel *model = static_cast<QStringListModel*>(completer->model());
+    model->setStringList(items);
+    if (!items.isEmpty()) {
+        completer->complete();
+    }
+}
+
+void MainWindow::onAdresseEdited(const QString& text)
+{
+    // Complete the city: the part after the postal code, or after the last comma
+    static const QRegularExpression cityPart("^(.*(?:\\b\\d{4,5}\\s+|,\\s*))([^,\\d]+)$");
+    QRegularExpressionMatch match = cityPart.match(text);
+    if (!match.hasMatch()) {
+        showCompletions(adresseCompleter, QStringList());
+        return;
+    }
+    
+    QString head = match.captured(1);
+    QStringList items;
+    for (const QString& city : cityCompletions.complete(match.captured(2))) {
+        items << head + city;
+    }
+    showCompletions(adresseCompleter, items);
+}
+
+bool MainWindow::checkContactConflict(const Fournisseur& f)
+{
+    int conflictingId = -1;
+    ContactIndex::Field field = contactIndex.findConflict(f, &conflictingId);
+    if (field == ContactIndex::None) {
+        return true;
+    }
+    
+    QMessageBox::warning(this, "Doublon",
+        QString("Ce %1 est déjà utilisé par le fournisseur ID %2!")
+        .arg(ContactIndex::fieldName(field))
+        .arg(conflictingId));
+    return false;
+}
+
 bool MainWindow::validateInputs()
 {
     if (ui->lineEdit_3->text().trimmed().isEmpty()) {
@@ -175,7 +426,9 @@ void MainWindow::onAjouterClicked()
         return;
     }
 
-    int id = generateNewId();
+    // The database assigns the id itself; only the JSON file needs one from us
+    bool inDatabase = useDatabase && dbManager;
+    int id = inDatabase ? 0 : generateNewId();
     Fournisseur newFournisseur(
         id,
         ui->lineEdit_3->text(),
@@ -187,25 +440,39 @@ void MainWindow::onAjouterClicked()
         true
     );
 
-    // Save to Oracle if connected, otherwise to JSON
-    if (useDatabase && dbManager) {
-        if (dbManager->insertFournisseur(newFournisseur)) {
-            qDebug() << "✅ Saved to Oracle Database!";
+    if (!checkContactConflict(newFournisseur)) {
+        return;
+    }
+
+    // Save to the database if connected, otherwise to JSON
+    if (inDatabase) {
+        if (dbManager->insertFournisseur(newFournisseur, false, &id)) {
+            qDebug() << "✅ Saved to" << dbManager->getDatabaseType() << "with id" << id;
+            newFournisseur.setIdFournisseur(id);
             listeFournisseurs.append(newFournisseur);
-            addActivityLog("ADD", QString("Nouveau fournisseur ajouté dans Oracle: %1").arg(newFournisseur.getNom()), id);
-            QMessageBox::information(this, "Succès", "Fournisseur ajouté dans Oracle Database! ✅");
+            supplierStore.append(newFournisseur);
+            indexFournisseur(newFournisseur);
+            addActivityLog("ADD", QString("Nouveau fournisseur ajouté dans %1: %2")
+                           .arg(dbManager->getDatabaseType(), newFournisseur.getNom()), id);
+            QMessageBox::information(this, "Succès",
+                QString("Fournisseur ajouté dans %1! ✅").arg(dbManager->getDatabaseType()));
         } else {
-            QMessageBox::warning(this, "Erreur", "Erreur lors de la sauvegarde dans Oracle!");
+            QMessageBox::warning(this, "Erreur",
+                QString("Erreur lors de la sauvegarde dans %1!\n%2")
+                .arg(dbManager->getDatabaseType(), dbManager->getLastError()));
             return;
         }
     } else {
         listeFournisseurs.append(newFournisseur);
+        supplierStore.append(newFournisseur);
+        indexFournisseur(newFournisseur);
         addActivityLog("ADD", QString("Nouveau fournisseur ajouté: %1").arg(newFournisseur.getNom()), id);
         saveToFile();
         BackupManager::autoBackup("fournisseurs.json", 10);
         QMessageBox::information(this, "Succès", "Fournisseur ajouté avec succès!");
     }
     
+    if (workloadRecorder.isRecording()) workloadRecorder.record(WorkloadOp::add(newFournisseur));
     refreshTableView();
     clearInputFields();
 }
@@ -221,24 +488,38 @@ void MainWindow::onModifierClicked()
         return;
     }
 
+    Fournisseur edited(currentSelectedId, ui->lineEdit_3->text(), ui->lineEdit_4->text(),
+                       ui->lineEdit_2->text(), ui->lineEdit_5->text(),
+                       ui->lineEdit_6->text(), ui->lineEdit_7->text());
+    if (!checkContactConflict(edited)) {
+        return;
+    }
+
     for (int i = 0; i < listeFournisseurs.size(); ++i) {
         if (listeFournisseurs[i].getIdFournisseur() == currentSelectedId) {
             QString oldName = listeFournisseurs[i].getNom();
+            unindexFournisseur(listeFournisseurs[i]);
             listeFournisseurs[i].setNom(ui->lineEdit_3->text());
             listeFournisseurs[i].setAdresse(ui->lineEdit_4->text());
             listeFournisseurs[i].setEmail(ui->lineEdit_2->text());
             listeFournisseurs[i].setTelephone(ui->lineEdit_5->text());
             listeFournisseurs[i].setTypeProduits(ui->lineEdit_6->text());
             listeFournisseurs[i].setHistoriqueLivraisons(ui->lineEdit_7->text());
+            supplierStore.replace(i, listeFournisseurs[i]);
+            indexFournisseur(listeFournisseurs[i]);
             
-            // Update in Oracle if connected
+            // Update in the database if connected
             if (useDatabase && dbManager) {
                 if (dbManager->updateFournisseur(listeFournisseurs[i])) {
-                    qDebug() << "✅ Updated in Oracle!";
-                    addActivityLog("MODIFY", QString("Fournisseur modifié dans Oracle: %1").arg(oldName), currentSelectedId);
-                    QMessageBox::information(this, "Succès", "Fournisseur modifié dans Oracle! ✅");
+                    qDebug() << "✅ Updated in" << dbManager->getDatabaseType();
+                    addActivityLog("MODIFY", QString("Fournisseur modifié dans %1: %2")
+                                   .arg(dbManager->getDatabaseType(), oldName), currentSelectedId);
+                    QMessageBox::information(this, "Succès",
+                        QString("Fournisseur modifié dans %1! ✅").arg(dbManager->getDatabaseType()));
                 } else {
-                    QMessageBox::warning(this, "Erreur", "Erreur lors de la mise à jour dans Oracle!");
+                    QMessageBox::warning(this, "Erreur",
+                        QString("Erreur lors de la mise à jour dans %1!\n%2")
+                        .arg(dbManager->getDatabaseType(), dbManager->getLastError()));
                     return;
                 }
             } else {
@@ -246,6 +527,7 @@ void MainWindow::onModifierClicked()
                 saveToFile();
                 QMessageBox::information(this, "Succès", "Fournisseur modifié avec succès!");
             }
+            if (workloadRecorder.isRecording()) workloadRecorder.record(WorkloadOp::modify(listeFournisseurs[i]));
             break;
         }
     }
@@ -274,26 +556,35 @@ void MainWindow::onSupprimerClicked()
             if (reply == QMessageBox::Yes) {
                 QString nom = listeFournisseurs[i].getNom();
                 
-                // Delete from Oracle if connected
+                // Delete from the database if connected
                 if (useDatabase && dbManager) {
                     if (dbManager->deleteFournisseur(id)) {
-                        qDebug() << "✅ Deleted from Oracle!";
+                        qDebug() << "✅ Deleted from" << dbManager->getDatabaseType();
+                        unindexFournisseur(listeFournisseurs[i]);
                         listeFournisseurs.removeAt(i);
+                        supplierStore.removeAt(i);
                         found = true;
-                        addActivityLog("DELETE", QString("Fournisseur supprimé d'Oracle: %1").arg(nom), id);
-                        QMessageBox::information(this, "Succès", "Fournisseur supprimé d'Oracle! ✅");
+                        addActivityLog("DELETE", QString("Fournisseur supprimé de %1: %2")
+                                       .arg(dbManager->getDatabaseType(), nom), id);
+                        QMessageBox::information(this, "Succès",
+                            QString("Fournisseur supprimé de %1! ✅").arg(dbManager->getDatabaseType()));
                     } else {
-                        QMessageBox::warning(this, "Erreur", "Erreur lors de la suppression dans Oracle!");
+                        QMessageBox::warning(this, "Erreur",
+                            QString("Erreur lors de la suppression dans %1!\n%2")
+                            .arg(dbManager->getDatabaseType(), dbManager->getLastError()));
                         return;
                     }
                 } else {
+                    unindexFournisseur(listeFournisseurs[i]);
                     listeFournisseurs.removeAt(i);
+                    supplierStore.removeAt(i);
                     found = true;
                     addActivityLog("DELETE", QString("Fournisseur supprimé: %1").arg(nom), id);
                     saveToFile();
                     QMessageBox::information(this, "Succès", "Fournisseur supprimé avec succès!");
                 }
                 
+                if (workloadRecorder.isRecording()) workloadRecorder.record(WorkloadOp::remove(id));
                 refreshTableView();
                 clearInputFields();
             }
@@ -315,27 +606,159 @@ void MainWindow::onRechercherClicked()
         return;
     }
 
-    // Search by ID or Name
-    bool found = false;
-    for (const Fournisseur& f : listeFournisseurs) {
-        if (QString::number(f.getIdFournisseur()).contains(searchText) ||
-            f.getNom().contains(searchText, Qt::CaseInsensitive) ||
-            f.getEmail().contains(searchText, Qt::CaseInsensitive)) {
-            loadFournisseurToFields(f);
-            found = true;
-            break;
+    if (tableModel->rowCount() != listeFournisseurs.size()) {
+        refreshTableView();
+    }
+
+    // Finish the search synchronously (refines the live results if possible)
+    searchDebounceTimer->stop();
+    searchStepTimer->stop();
+    if (liveSearch.getQuery() != searchText || !liveSearch.isFinished()) {
+        if (workloadRecorder.isRecording()) workloadRecorder.record(WorkloadOp::search(searchText));
+        liveSearch.begin(searchText);
+        liveSearch.step(listeFournisseurs, listeFournisseurs.size());
+        applySearchResults();
+    }
+
+    const QVector<int>& results = liveSearch.getResults();
+    if (!results.isEmpty()) {
+        loadFournisseurToFields(listeFournisseurs[results.first()]);
+        return;
+    }
+
+    // No exact match: fall back to typo-tolerant name search
+    if (searchText.length() >= 3) {
+        if (fuzzyIndexDirty) {
+            fuzzyIndex.build(listeFournisseurs);
+            fuzzyIndexDirty = false;
+        }
+        
+        QVector<FuzzyNameIndex::Match> fuzzy = fuzzyIndex.search(searchText, 10);
+        if (!fuzzy.isEmpty()) {
+            // Homonyms give identical lines: the row picked, not its text, names the supplier
+            QDialog dialog(this);
+            dialog.setWindowTitle("Recherche approximative");
+            
+            QVBoxLayout *layout = new QVBoxLayout(&dialog);
+            layout->addWidget(new QLabel("Aucun résultat exact. Vouliez-vous dire:"));
+            
+            QListWidget *matchList = new QListWidget();
+            for (const FuzzyNameIndex::Match& m : fuzzy) {
+                matchList->addItem(QString("%1 (distance %2)")
+                    .arg(listeFournisseurs[m.index].getNom())
+                    .arg(m.distance));
+            }
+            matchList->setCurrentRow(0);
+            connect(matchList, &QListWidget::itemDoubleClicked, &dialog, &QDialog::accept);
+            layout->addWidget(matchList);
+            
+            QHBoxLayout *btnLayout = new QHBoxLayout();
+            QPushButton *okBtn = new QPushButton("OK");
+            QPushButton *cancelBtn = new QPushButton("Annuler");
+            connect(okBtn, &QPushButton::clicked, &dialog, &QDialog::accept);
+            connect(cancelBtn, &QPushButton::clicked, &dialog, &QDialog::reject);
+            btnLayout->addWidget(okBtn);
+            btnLayout->addWidget(cancelBtn);
+            layout->addLayout(btnLayout);
+            
+            int row = -1;
+            if (dialog.exec() == QDialog::Accepted) row = matchList->currentRow();
+            if (row >= 0 && row < fuzzy.size()) {
+                loadFournisseurToFields(listeFournisseurs[fuzzy[row].index]);
+            }
+            return;
         }
     }
 
-    if (!found) {
-        QMessageBox::information(this, "Recherche", "Aucun fournisseur trouvé!");
+    QMessageBox::information(this, "Recherche", "Aucun fournisseur trouvé!");
+}
+
+void MainWindow::onSearchTextChanged()
+{
+    // A newer keystroke cancels whatever slice-scan is still running
+    searchStepTimer->stop();
+    searchDebounceTimer->start();
+}
+
+void MainWindow::onSearchDebounced()
+{
+    QString searchText = ui->lineEdit_8->text().trimmed();
+    
+    // The advanced filter rebuilds the model with a subset; resync first
+    if (tableModel->rowCount() != listeFournisseurs.size()) {
+        refreshTableView();
+        return;
     }
+    
+    if (searchText.isEmpty()) {
+        liveSearch.reset(listeFournisseurs.size());
+        showAllRows();
+        return;
+    }
+    
+    if (searchText == liveSearch.getQuery() && liveSearch.isFinished()) {
+        return;
+    }
+    
+    if (workloadRecorder.isRecording()) workloadRecorder.record(WorkloadOp::search(searchText));
+    liveSearch.begin(searchText);
+    searchStepTimer->start();
+}
+
+void MainWindow::onSearchStep()
+{
+    if (liveSearch.step(listeFournisseurs)) {
+        searchStepTimer->stop();
+        applySearchResults();
+    }
+}
+
+void MainWindow::applySearchResults()
+{
+    const QVector<int>& results = liveSearch.getResults();
+    ui->tableView->setUpdatesEnabled(false);
+    
+    if (liveSearch.isRefinement() && !allRowsVisible) {
+        // Results are a subset of the visible rows: hide only the dropouts
+        int j = 0;
+        for (int row : visibleRows) {
+            while (j < results.size() && results[j] < row) ++j;
+            if (j >= results.size() || results[j] != row) {
+                ui->tableView->setRowHidden(row, true);
+            }
+        }
+    } else {
+        int j = 0;
+        for (int row = 0; row < tableModel->rowCount(); ++row) {
+            bool match = j < results.size() && results[j] == row;
+            if (match) ++j;
+            ui->tableView->setRowHidden(row, !match);
+        }
+    }
+    
+    ui->tableView->setUpdatesEnabled(true);
+    visibleRows = results;
+    allRowsVisible = false;
+}
+
+void MainWindow::showAllRows()
+{
+    if (allRowsVisible) return;
+    
+    ui->tableView->setUpdatesEnabled(false);
+    for (int row = 0; row < tableModel->rowCount(); ++row) {
+        ui->tableView->setRowHidden(row, false);
+    }
+    ui->tableView->setUpdatesEnabled(true);
+    visibleRows.clear();
+    allRowsVisible = true;
 }
 
 void MainWindow::onTrierClicked()
 {
     QStringList items;
-    items << "Par ID" << "Par Nom" << "Par Type de Produits" << "Par Note (Rating)";
+    items << "Par ID" << "Par Nom" << "Par Type de Produits" << "Par Note (Rating)"
+          << "Par Note récente (30 jours)" << "Par Note récente (90 jours)";
     
     bool ok;
     QString item = QInputDialog::getItem(this, "Trier",
@@ -351,7 +774,12 @@ void MainWindow::onTrierClicked()
             sortByTypeProduits();
         } else if (item == "Par Note (Rating)") {
             sortByRating();
+        } else if (item == "Par Note récente (30 jours)") {
+            sortByRating(RatingHistory::Decayed30);
+        } else if (item == "Par Note récente (90 jours)") {
+            sortByRating(RatingHistory::Decayed90);
         }
+        supplierStore.reset(listeFournisseurs);
         refreshTableView();
         addActivityLog("SORT", QString("Tri appliqué: %1").arg(item));
     }
@@ -359,45 +787,32 @@ void MainWindow::onTrierClicked()
 
 void MainWindow::sortById()
 {
-    std::sort(listeFournisseurs.begin(), listeFournisseurs.end(),
-              [](const Fournisseur& a, const Fournisseur& b) {
-                  return a.getIdFournisseur() < b.getIdFournisseur();
-              });
+    SupplierSorter::sortById(listeFournisseurs);
 }
 
 void MainWindow::sortByNom()
 {
-    std::sort(listeFournisseurs.begin(), listeFournisseurs.end(),
-              [](const Fournisseur& a, const Fournisseur& b) {
-                  return a.getNom() < b.getNom();
-              });
+    SupplierSorter::sortByNom(listeFournisseurs);
 }
 
 void MainWindow::sortByTypeProduits()
 {
-    std::sort(listeFournisseurs.begin(), listeFournisseurs.end(),
-              [](const Fournisseur& a, const Fournisseur& b) {
-                  return a.getTypeProduits() < b.getTypeProduits();
-              });
+    SupplierSorter::sortByTypeProduits(listeFournisseurs);
 }
 
 void MainWindow::onStatClicked()
 {
+    TRACE_SCOPE("MainWindow::onStatClicked");
     int totalFournisseurs = listeFournisseurs.size();
     
-    // Count by product type
-    QMap<QString, int> typeCounts;
-    for (const Fournisseur& f : listeFournisseurs) {
-        QString type = f.getTypeProduits();
-        if (type.isEmpty()) type = "Non spécifié";
-        typeCounts[type]++;
-    }
+    // Maintained by index/unindexFournisseur: no pass over the list
+    QMap<QString, int> typeDistribution = AdvancedStats::labelTypeCounts(typeCounts);
 
     QString stats = QString("=== STATISTIQUES DES FOURNISSEURS ===\n\n");
     stats += QString("Nombre total de fournisseurs: %1\n\n").arg(totalFournisseurs);
     stats += "Répartition par type de produits:\n";
     
-    for (auto it = typeCounts.begin(); it != typeCounts.end(); ++it) {
+    for (auto it = typeDistribution.begin(); it != typeDistribution.end(); ++it) {
         stats += QString("  - %1: %2 fournisseurs\n").arg(it.key()).arg(it.value());
     }
 
@@ -406,6 +821,7 @@ void MainWindow::onStatClicked()
 
 void MainWindow::onExportPdfClicked()
 {
+    TRACE_SCOPE("MainWindow::onExportPdfClicked");
     QString fileName = QFileDialog::getSaveFileName(this, "Exporter en PDF",
                                                      "", "PDF Files (*.pdf)");
     
@@ -413,64 +829,24 @@ void MainWindow::onExportPdfClicked()
         return;
     }
 
-    QPrinter printer(QPrinter::HighResolution);
-    printer.setOutputFormat(QPrinter::PdfFormat);
-    printer.setOutputFileName(fileName);
-    printer.setPageOrientation(QPageLayout::Landscape);
-
-    QPainter painter;
-    if (!painter.begin(&printer)) {
-        QMessageBox::warning(this, "Erreur", "Impossible de créer le PDF!");
-        return;
-    }
-
-    // Draw title
-    QFont titleFont = painter.font();
-    titleFont.setPointSize(16);
-    titleFont.setBold(true);
-    painter.setFont(titleFont);
-    painter.drawText(100, 100, "Liste des Fournisseurs");
-
-    // Draw table
-    QFont normalFont = painter.font();
-    normalFont.setPointSize(10);
-    painter.setFont(normalFont);
-
-    int y = 200;
-    int lineHeight = 50;
-    
-    // Header
-    painter.drawText(100, y, "ID");
-    painter.drawText(300, y, "Nom");
-    painter.drawText(600, y, "Email");
-    painter.drawText(1100, y, "Téléphone");
-    painter.drawText(1600, y, "Type Produits");
-    
-    y += lineHeight;
-    painter.drawLine(100, y, 2000, y);
-    y += 20;
-
-    // Data
-    for (const Fournisseur& f : listeFournisseurs) {
-        painter.drawText(100, y, QString::number(f.getIdFournisseur()));
-        painter.drawText(300, y, f.getNom());
-        painter.drawText(600, y, f.getEmail());
-        painter.drawText(1100, y, f.getTelephone());
-        painter.drawText(1600, y, f.getTypeProduits());
-        y += lineHeight;
-        
-        if (y > 2800) {
-            printer.newPage();
-            y = 200;
+    // Rendered by a job from a snapshot: edits made meanwhile are not mixed in
+    SupplierSnapshotPtr snapshot = supplierStore.snapshot();
+    startJob(QString("Export PDF: %1").arg(QFileInfo(fileName).fileName()), JobScheduler::Interactive,
+             [fileName, snapshot](JobContext& job) {
+        SupplierReport report(snapshot);
+        return report.render(fileName, job);
+    }, [this](bool ok, const QString& message) {
+        if (ok) {
+            QMessageBox::information(this, "Succès", "PDF exporté avec succès!");
+        } else if (message != "Annulé") {
+            QMessageBox::warning(this, "Erreur", "Impossible de créer le PDF!");
         }
-    }
-
-    painter.end();
-    QMessageBox::information(this, "Succès", "PDF exporté avec succès!");
+    });
 }
 
 void MainWindow::onRefreshClicked()
 {
+    if (workloadRecorder.isRecording()) workloadRecorder.record(WorkloadOp::load());
     refreshTableView();
     clearInputFields();
     QMessageBox::information(this, "Actualisation", "Liste actualisée!");
@@ -494,46 +870,34 @@ void MainWindow::onTableSelectionChanged()
 
 void MainWindow::saveToFile()
 {
-    QJsonArray jsonArray;
-    for (const Fournisseur& f : listeFournisseurs) {
-        jsonArray.append(f.toJson());
-    }
-
-    QJsonDocument doc(jsonArray);
-    QFile file("fournisseurs.json");
-    
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(doc.toJson());
-        file.close();
-    }
+    TRACE_SCOPE("MainWindow::saveToFile");
+    JsonStorage::saveToFile("fournisseurs.json", listeFournisseurs);
 }
 
 void MainWindow::loadFromFile()
 {
-    QFile file("fournisseurs.json");
-    
-    if (!file.exists()) {
+    TRACE_SCOPE("MainWindow::loadFromFile");
+    if (!QFile::exists("fournisseurs.json")) {
         return;
     }
 
-    if (file.open(QIODevice::ReadOnly)) {
-        QByteArray data = file.readAll();
-        file.close();
-
-        QJsonDocument doc = QJsonDocument::fromJson(data);
-        if (doc.isArray()) {
-            QJsonArray jsonArray = doc.array();
-            listeFournisseurs.clear();
-            
-            for (const QJsonValue& value : jsonArray) {
-                if (value.isObject()) {
-                    listeFournisseurs.append(Fournisseur::fromJson(value.toObject()));
-                }
-            }
-        }
+    bool success;
+    QList<Fournisseur> loaded = JsonStorage::loadFromFile("fournisseurs.json", success);
+    if (success) {
+        listeFournisseurs = loaded;
+        rebuildIndexes();
+        // From here on, external edits to the file are applied as diffs
+        jsonReloader->start("fournisseurs.json", listeFournisseurs);
     }
 }
 
+int MainWindow::startJob(const QString& title, JobScheduler::Priority priority,
+                         JobScheduler::Work work, JobScheduler::Done onDone)
+{
+    jobsPanel->show();
+    return jobScheduler->submit(title, priority, std::move(work), std::move(onDone));
+}
+
 // ===== ADVANCED FEATURES IMPLEMENTATION =====
 
 void MainWindow::createAdvancedMenu()
@@ -542,33 +906,61 @@ void MainWindow::createAdvancedMenu()
     
     QAction *exportCSVAction = new QAction("📁 Exporter en CSV", this);
     QAction *importCSVAction = new QAction("📥 Importer CSV", this);
+    QAction *multiExportAction = new QAction("🗂️ Export Multi-format (CSV + JSON + PDF)", this);
     QAction *rateAction = new QAction("⭐ Noter Fournisseur", this);
+    QAction *deliveryAction = new QAction("🚚 Enregistrer une Livraison", this);
+    QAction *leadTimeAction = new QAction("📉 Tableau des Délais (p50/p90/p99)", this);
     QAction *activityLogAction = new QAction("📝 Historique d'Activités", this);
     QAction *backupAction = new QAction("💾 Créer Sauvegarde", this);
     QAction *restoreAction = new QAction("♻️ Restaurer Sauvegarde", this);
     QAction *filterAction = new QAction("🔍 Filtre Avancé", this);
     QAction *statsAction = new QAction("📈 Statistiques Avancées", this);
+    QAction *duplicatesAction = new QAction("🧬 Détecter les Doublons", this);
+    QAction *traceAction = new QAction("⏱️ Exporter la Trace (Chrome)", this);
+    QAction *dbDiagnosticsAction = new QAction("🩺 Diagnostics Base de Données", this);
+    QAction *memoryAction = new QAction("📦 Mémoire par Sous-système", this);
+    QAction *workloadAction = new QAction("🎬 Enregistrer la Charge", this);
+    workloadAction->setCheckable(true);
     
     connect(exportCSVAction, &QAction::triggered, this, &MainWindow::onExportCSVClicked);
     connect(importCSVAction, &QAction::triggered, this, &MainWindow::onImportCSVClicked);
+    connect(multiExportAction, &QAction::triggered, this, &MainWindow::onMultiExportClicked);
     connect(rateAction, &QAction::triggered, this, &MainWindow::onRateSupplierClicked);
+    connect(deliveryAction, &QAction::triggered, this, &MainWindow::onRecordDeliveryClicked);
+    connect(leadTimeAction, &QAction::triggered, this, &MainWindow::onLeadTimeDashboardClicked);
     connect(activityLogAction, &QAction::triggered, this, &MainWindow::onViewActivityLogClicked);
     connect(backupAction, &QAction::triggered, this, &MainWindow::onBackupClicked);
     connect(restoreAction, &QAction::triggered, this, &MainWindow::onRestoreBackupClicked);
     connect(filterAction, &QAction::triggered, this, &MainWindow::onAdvancedFilterClicked);
     connect(statsAction, &QAction::triggered, this, &MainWindow::onAdvancedStatsClicked);
+    connect(duplicatesAction, &QAction::triggered, this, &MainWindow::onDetectDuplicatesClicked);
+    connect(traceAction, &QAction::triggered, this, &MainWindow::onExportTraceClicked);
+    connect(dbDiagnosticsAction, &QAction::triggered, this, &MainWindow::onDatabaseDiagnosticsClicked);
+    connect(memoryAction, &QAction::triggered, this, &MainWindow::onMemoryReportClicked);
+    connect(workloadAction, &QAction::toggled, this, &MainWindow::onRecordWorkloadToggled);
     
     advancedMenu->addAction(exportCSVAction);
     advancedMenu->addAction(importCSVAction);
+    advancedMenu->addAction(multiExportAction);
     advancedMenu->addSeparator();
     advancedMenu->addAction(rateAction);
+    advancedMenu->addAction(deliveryAction);
     advancedMenu->addAction(filterAction);
+    advancedMenu->addAction(duplicatesAction);
     advancedMenu->addSeparator();
     advancedMenu->addAction(activityLogAction);
     advancedMenu->addAction(statsAction);
+    advancedMenu->addAction(leadTimeAction);
+    advancedMenu->addAction(leaderboardPanel->toggleViewAction());
     advancedMenu->addSeparator();
     advancedMenu->addAction(backupAction);
     advancedMenu->addAction(restoreAction);
+    advancedMenu->addSeparator();
+    advancedMenu->addAction(traceAction);
+    advancedMenu->addAction(dbDiagnosticsAction);
+    advancedMenu->addAction(memoryAction);
+    advancedMenu->addAction(workloadAction);
+    advancedMenu->addAction(jobsPanel->toggleViewAction());
 }
 
 void MainWindow::addActivityLog(const QString& action, const QString& description, int fId)
@@ -588,16 +980,19 @@ SupplierRating* MainWindow::getRatingForSupplier(int fournisseurId)
     return nullptr;
 }
 
-void MainWindow::sortByRating()
+void MainWindow::applyDeliveryMetrics(SupplierRating& rating) const
+{
+    // Derived from the recorded deliveries, never typed by hand
+    if (!deliveries.contains(rating.getFournisseurId())) return;
+    DeliveryMetrics m = deliveries.metrics(rating.getFournisseurId());
+    rating.setTotalOrders(m.orders);
+    rating.setOnTimeDeliveries(m.onTime);
+    rating.setAverageDeliveryTime(m.averageDeliveryTime());
+}
+
+void MainWindow::sortByRating(RatingHistory::Window window)
 {
-    std::sort(listeFournisseurs.begin(), listeFournisseurs.end(),
-              [this](const Fournisseur& a, const Fournisseur& b) {
-                  SupplierRating* ratingA = getRatingForSupplier(a.getIdFournisseur());
-                  SupplierRating* ratingB = getRatingForSupplier(b.getIdFournisseur());
-                  double scoreA = ratingA ? ratingA->getOverallRating() : 0.0;
-                  double scoreB = ratingB ? ratingB->getOverallRating() : 0.0;
-                  return scoreA > scoreB;
-              });
+    SupplierSorter::sortByRating(listeFournisseurs, ratingHistory, window);
 }
 
 void MainWindow::saveAdvancedData()
@@ -648,6 +1043,30 @@ void MainWindow::loadAdvancedData()
         }
     }
     
+    // Rating history; the first time, seeded with the latest rating of each supplier
+    if (QFile::exists("rating_history.json")) {
+        if (!ratingHistory.loadFromFile("rating_history.json")) {
+            qDebug() << "⚠️ Historique des notes non chargé:" << ratingHistory.getLastError();
+        }
+    } else {
+        ratingHistory.clear();
+        for (const SupplierRating& rating : supplierRatings) {
+            ratingHistory.append(RatingEvent::fromRating(rating));
+        }
+    }
+    rebuildLeaderboard();
+    
+    // Load delivery events, then refresh the metrics they drive
+    if (QFile::exists("livraisons.dat") && !deliveries.loadFromFile("livraisons.dat")) {
+        qDebug() << "⚠️ Livraisons non chargées:" << deliveries.getLastError();
+    } else if (deliveries.replayedRecords() > 1000) {
+        // Fold the changes appended since the snapshot into a new one
+        deliveries.saveToFile("livraisons.dat");
+    }
+    for (SupplierRating& rating : supplierRatings) {
+        applyDeliveryMetrics(rating);
+    }
+    
     // Load activity log
     QFile logFile("activity_log.json");
     if (logFile.exists() && logFile.open(QIODevice::ReadOnly)) {
@@ -672,14 +1091,87 @@ void MainWindow::onExportCSVClicked()
                                                      "", "CSV Files (*.csv)");
     if (fileName.isEmpty()) return;
     
-    if (CSVManager::exportToCSV(fileName, listeFournisseurs)) {
-        addActivityLog("EXPORT_CSV", QString("Données exportées vers: %1").arg(fileName));
-        QMessageBox::information(this, "Succès", 
-            QString("Les données ont été exportées avec succès!\n%1 fournisseurs exportés.")
-            .arg(listeFournisseurs.size()));
-    } else {
-        QMessageBox::warning(this, "Erreur", "Échec de l'export CSV!");
-    }
+    // Written by a job from a snapshot, so the count reported is the count written
+    SupplierSnapshotPtr snapshot = supplierStore.snapshot();
+    startJob(QString("Export CSV: %1").arg(QFileInfo(fileName).fileName()), JobScheduler::Interactive,
+             [fileName, snapshot](JobContext& job) {
+        TRACE_SCOPE("CSVManager::exportToCSV");
+        CSVWriter writer;
+        if (!writer.open(fileName)) {
+            job.fail("fichier non inscriptible");
+            return false;
+        }
+        qint64 written = 0;
+        const qint64 total = snapshot->size();
+        snapshot->forEach([&](const Fournisseur& f) {
+            if (job.isCancelled()) return;
+            writer.write(f);
+            if ((++written & 4095) == 0) job.setProgress(written, total);
+        });
+        bool ok = writer.close();
+        if (job.isCancelled()) {
+            QFile::remove(fileName);    // no half-written exports left behind
+            return false;
+        }
+        job.setProgress(total, total);
+        return ok;
+    }, [this, fileName, snapshot](bool ok, const QString& message) {
+        if (ok) {
+            addActivityLog("EXPORT_CSV", QString("Données exportées vers: %1").arg(fileName));
+            QMessageBox::information(this, "Succès", 
+                QString("Les données ont été exportées avec succès!\n%1 fournisseurs exportés.")
+                .arg(snapshot->size()));
+        } else if (message != "Annulé") {
+            QMessageBox::warning(this, "Erreur", "Échec de l'export CSV!");
+        }
+    });
+}
+
+void MainWindow::onMultiExportClicked()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "Export multi-format (nom de base)",
+                                                     "fournisseurs", "Tous les formats (*)");
+    if (fileName.isEmpty()) return;
+    
+    QFileInfo info(fileName);
+    QString base = info.absolutePath() + "/" + info.completeBaseName();
+    QStringList outputs = { base + ".csv", base + ".json", base + ".pdf" };
+    
+    // One scan of one snapshot feeds the three writers, each on its own thread
+    SupplierSnapshotPtr snapshot = supplierStore.snapshot();
+    auto reports = std::make_shared<QList<ExportPipeline::SinkReport>>();
+    startJob(QString("Export multi-format: %1").arg(info.completeBaseName()), JobScheduler::Batch,
+             [snapshot, outputs, reports](JobContext& job) {
+        ExportPipeline pipeline;
+        pipeline.addSink(std::make_unique<CsvExportSink>(outputs[0]));
+        pipeline.addSink(std::make_unique<JsonExportSink>(outputs[1]));
+        pipeline.addSink(std::make_unique<PdfExportSink>(outputs[2]));
+        bool ok = pipeline.run([snapshot](const ExportPipeline::Visitor& visit) {
+            bool more = true;
+            snapshot->forEach([&](const Fournisseur& f) {
+                if (more) more = visit(f);
+            });
+            return true;
+        }, &job, snapshot->size());
+        *reports = pipeline.reports();
+        if (!ok && !pipeline.getLastError().isEmpty()) job.fail(pipeline.getLastError());
+        return ok;
+    }, [this, reports](bool ok, const QString& message) {
+        if (message == "Annulé") return;
+        QString text;
+        for (const ExportPipeline::SinkReport& report : *reports) {
+            text += QString("%1 %2: %3 lignes en %4 s%5\n")
+                .arg(report.ok ? "✅" : "❌").arg(report.name).arg(report.rows)
+                .arg(report.seconds, 0, 'f', 2)
+                .arg(report.ok ? QString() : " (" + report.error + ")");
+        }
+        if (ok) {
+            addActivityLog("EXPORT_MULTI", "Export CSV + JSON + PDF");
+            QMessageBox::information(this, "Succès", text);
+        } else {
+            QMessageBox::warning(this, "Erreur", text.isEmpty() ? message : text);
+        }
+    });
 }
 
 void MainWindow::onImportCSVClicked()
@@ -688,10 +1180,41 @@ void MainWindow::onImportCSVClicked()
                                                      "", "CSV Files (*.csv)");
     if (fileName.isEmpty()) return;
     
-    bool success;
-    QList<Fournisseur> importedData = CSVManager::importFromCSV(fileName, success);
-    
-    if (success && !importedData.isEmpty()) {
+    // Parsing runs as a job; duplicate checks and the merge need the GUI data
+    auto parsed = std::make_shared<QList<Fournisseur>>();
+    startJob(QString("Import CSV: %1").arg(QFileInfo(fileName).fileName()), JobScheduler::Interactive,
+             [fileName, parsed](JobContext& job) {
+        TRACE_SCOPE("CSVManager::importFromCSV");
+        CSVReader reader;
+        if (!reader.open(fileName)) {
+            job.fail("fichier illisible");
+            return false;
+        }
+        Fournisseur f;
+        ColdTextStore::Builder cold;
+        while (!job.isCancelled() && reader.next(f)) {
+            f.setHistoriqueLivraisons(cold.add(f.getHistoriqueLivraisons()));
+            parsed->append(f);
+            if ((parsed->size() & 4095) == 0) {
+                job.setProgress(qint64(reader.progress() * 1000), 1000);
+            }
+        }
+        cold.finish();
+        reader.close();
+        job.setStatus(QString("%1 lignes lues").arg(parsed->size()));
+        return true;
+    }, [this, parsed](bool ok, const QString& message) {
+        if (ok) {
+            importParsedRows(*parsed);
+        } else if (message != "Annulé") {
+            QMessageBox::warning(this, "Erreur", "Échec de l'import CSV!");
+        }
+    });
+}
+
+void MainWindow::importParsedRows(const QList<Fournisseur>& importedData)
+{
+    if (!importedData.isEmpty()) {
         auto reply = QMessageBox::question(this, "Confirmation",
             QString("Voulez-vous importer %1 fournisseurs?\n"
                    "Cela ajoutera les nouveaux fournisseurs à la liste existante.")
@@ -699,34 +1222,260 @@ void MainWindow::onImportCSVClicked()
             QMessageBox::Yes | QMessageBox::No);
         
         if (reply == QMessageBox::Yes) {
+            // Exact ID check through a hash set instead of a nested scan
+            QSet<int> existingIds;
+            existingIds.reserve(listeFournisseurs.size() + importedData.size());
+            for (const Fournisseur& existing : listeFournisseurs) {
+                existingIds.insert(existing.getIdFournisseur());
+            }
+            
+            // Near-duplicates: same supplier under a different spelling/format
+            DuplicateDetector detector;
+            QVector<DuplicateDetector::DuplicatePair> nearDuplicates =
+                detector.findDuplicatesAgainst(listeFournisseurs, importedData);
+            
+            QSet<int> skippedRows;
+            if (!nearDuplicates.isEmpty()) {
+                QSet<int> suspectRows;
+                for (const DuplicateDetector::DuplicatePair& pair : nearDuplicates) {
+                    suspectRows.insert(pair.second);
+                }
+                
+                QMessageBox box(this);
+                box.setWindowTitle("Doublons probables");
+                box.setIcon(QMessageBox::Question);
+                box.setText(QString("%1 lignes ressemblent à des fournisseurs existants.\n"
+                                    "Voulez-vous ignorer ces lignes?").arg(suspectRows.size()));
+                box.setDetailedText(DuplicateDetector::formatReport(nearDuplicates,
+                                                                    listeFournisseurs,
+                                                                    importedData));
+                box.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+                if (box.exec() == QMessageBox::Yes) {
+                    skippedRows = suspectRows;
+                }
+            }
+            
             int addedCount = 0;
-            for (const Fournisseur& f : importedData) {
-                // Check if ID already exists
-                bool exists = false;
-                for (const Fournisseur& existing : listeFournisseurs) {
-                    if (existing.getIdFournisseur() == f.getIdFournisseur()) {
-                        exists = true;
-                        break;
-                    }
+            int contactConflicts = 0;
+            QList<Fournisseur> addedRows;
+            supplierStore.beginBatch();
+            for (int i = 0; i < importedData.size(); ++i) {
+                const Fournisseur& f = importedData[i];
+                if (skippedRows.contains(i) || existingIds.contains(f.getIdFournisseur())) {
+                    continue;
                 }
                 
-                if (!exists) {
-                    listeFournisseurs.append(f);
-                    addedCount++;
+                // Email / phone already used: O(1) via Bloom filter + hash index
+                if (contactIndex.findConflict(f) != ContactIndex::None) {
+                    contactConflicts++;
+                    continue;
                 }
+                
+                listeFournisseurs.append(f);
+                supplierStore.append(f);
+                existingIds.insert(f.getIdFournisseur());
+                indexFournisseur(f);
+                addedCount++;
+                if (workloadRecorder.isRecording()) addedRows.append(f);
             }
+            supplierStore.endBatch();
+            if (workloadRecorder.isRecording()) workloadRecorder.record(WorkloadOp::importBatch(addedRows));
             
             addActivityLog("IMPORT_CSV", QString("%1 fournisseurs importés depuis CSV").arg(addedCount));
             refreshTableView();
             saveToFile();
-            QMessageBox::information(this, "Succès", 
-                QString("%1 fournisseurs importés avec succès!").arg(addedCount));
+            QString message = QString("%1 fournisseurs importés avec succès!").arg(addedCount);
+            if (contactConflicts > 0) {
+                message += QString("\n%1 lignes ignorées (email ou téléphone déjà utilisé).")
+                    .arg(contactConflicts);
+            }
+            QMessageBox::information(this, "Succès", message);
         }
     } else {
         QMessageBox::warning(this, "Erreur", "Échec de l'import CSV!");
     }
 }
 
+void MainWindow::onDetectDuplicatesClicked()
+{
+    DuplicateDetector detector;
+    QVector<DuplicateDetector::DuplicatePair> pairs = detector.findDuplicates(listeFournisseurs);
+    
+    if (pairs.isEmpty()) {
+        QMessageBox::information(this, "Doublons", "Aucun doublon probable détecté.");
+        return;
+    }
+    
+    QDialog dialog(this);
+    dialog.setWindowTitle("🧬 Doublons Probables");
+    dialog.setMinimumSize(700, 500);
+    
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    QTextEdit *report = new QTextEdit();
+    report->setReadOnly(true);
+    report->setPlainText(DuplicateDetector::formatReport(pairs, listeFournisseurs, listeFournisseurs));
+    layout->addWidget(report);
+    
+    QPushButton *closeBtn = new QPushButton("Fermer");
+    connect(closeBtn, &QPushButton::clicked, &dialog, &QDialog::accept);
+    layout->addWidget(closeBtn);
+    
+    addActivityLog("DUPLICATES", QString("Détection de doublons: %1 paires").arg(pairs.size()));
+    dialog.exec();
+}
+
+void MainWindow::onExportTraceClicked()
+{
+    if (!Tracer::isCompiledIn()) {
+        QMessageBox::information(this, "Trace",
+            "Le traçage n'est pas compilé.\nReconstruisez avec: qmake CONFIG+=tracing");
+        return;
+    }
+    
+    QString fileName = QFileDialog::getSaveFileName(this, "Exporter la trace",
+                                                    "trace.json", "Trace JSON (*.json)");
+    if (fileName.isEmpty()) return;
+    
+    if (Tracer::dumpChromeTrace(fileName)) {
+        QString message = QString("Trace exportée: %1\n\nOuvrir avec chrome://tracing ou ui.perfetto.dev")
+            .arg(fileName);
+        if (Tracer::droppedEvents() > 0) {
+            message += QString("\n(%1 événements perdus: tampon plein)").arg(Tracer::droppedEvents());
+        }
+        QMessageBox::information(this, "Trace", message);
+    } else {
+        QMessageBox::warning(this, "Erreur", "Impossible d'écrire la trace!");
+    }
+}
+
+void MainWindow::onDatabaseDiagnosticsClicked()
+{
+    if (!dbManager || !dbManager->isConnected()) {
+        QMessageBox::information(this, "Diagnostics",
+            "Mode fichiers JSON: aucune requête SQL à analyser.");
+        return;
+    }
+    
+    QDialog dialog(this);
+    dialog.setWindowTitle("🩺 Diagnostics Base de Données");
+    dialog.setMinimumSize(800, 450);
+    
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    QTextEdit *view = new QTextEdit();
+    view->setReadOnly(true);
+    view->setFont(QFont("Courier New", 9));
+    view->setPlainText(dbManager->getMetrics().summary());
+    layout->addWidget(view);
+    
+    QPushButton *refreshBtn = new QPushButton("🔄 Actualiser");
+    QPushButton *exportBtn = new QPushButton("💾 Exporter JSON");
+    QPushButton *resetBtn = new QPushButton("Réinitialiser");
+    QPushButton *closeBtn = new QPushButton("Fermer");
+    QHBoxLayout *btnLayout = new QHBoxLayout();
+    btnLayout->addWidget(refreshBtn);
+    btnLayout->addWidget(exportBtn);
+    btnLayout->addWidget(resetBtn);
+    btnLayout->addWidget(closeBtn);
+    layout->addLayout(btnLayout);
+    
+    connect(refreshBtn, &QPushButton::clicked, [this, view]() {
+        view->setPlainText(dbManager->getMetrics().summary());
+    });
+    connect(exportBtn, &QPushButton::clicked, [this, &dialog]() {
+        QString fileName = QFileDialog::getSaveFileName(&dialog, "Exporter les métriques",
+                                                        "query_metrics.json", "JSON (*.json)");
+        if (!fileName.isEmpty() && !dbManager->dumpMetrics(fileName)) {
+            QMessageBox::warning(&dialog, "Erreur", "Impossible d'écrire le fichier!");
+        }
+    });
+    connect(resetBtn, &QPushButton::clicked, [this, view]() {
+        dbManager->getMetrics().reset();
+        view->setPlainText(dbManager->getMetrics().summary());
+    });
+    connect(closeBtn, &QPushButton::clicked, &dialog, &QDialog::accept);
+    
+    dialog.exec();
+}
+
+void MainWindow::updateMemoryEstimates()
+{
+    MemoryAccounting::setEstimate(MemoryAccounting::Suppliers, MemoryAccounting::estimate(listeFournisseurs));
+    MemoryAccounting::setEstimate(MemoryAccounting::Activities, MemoryAccounting::estimate(activityLog));
+    MemoryAccounting::setEstimate(MemoryAccounting::Ratings,
+        MemoryAccounting::estimate(supplierRatings) + ratingHistory.memoryUsage() + deliveries.memoryUsage());
+    // Cell texts are implicitly shared with listeFournisseurs: count the items only
+    MemoryAccounting::setEstimate(MemoryAccounting::TableModel,
+        MemoryAccounting::estimateTableModel(tableModel->rowCount(), tableModel->columnCount(), 0));
+    MemoryAccounting::setEstimate(MemoryAccounting::Indexes,
+        nomCompletions.memoryUsage() + typeCompletions.memoryUsage() + cityCompletions.memoryUsage() +
+        leaderboard.memoryUsage());
+}
+
+void MainWindow::onMemoryReportClicked()
+{
+    if (!MemoryAccounting::hooksCompiledIn()) {
+        updateMemoryEstimates();
+    }
+    
+    QDialog dialog(this);
+    dialog.setWindowTitle("📦 Mémoire par Sous-système");
+    dialog.setMinimumSize(600, 400);
+    
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    QTextEdit *view = new QTextEdit();
+    view->setReadOnly(true);
+    view->setFont(QFont("Courier New", 9));
+    view->setPlainText(MemoryAccounting::report());
+    layout->addWidget(view);
+    
+    QPushButton *resetBtn = new QPushButton("Réinitialiser les pics");
+    QPushButton *closeBtn = new QPushButton("Fermer");
+    QHBoxLayout *btnLayout = new QHBoxLayout();
+    btnLayout->addWidget(resetBtn);
+    btnLayout->addWidget(closeBtn);
+    layout->addLayout(btnLayout);
+    
+    connect(resetBtn, &QPushButton::clicked, [view]() {
+        MemoryAccounting::resetPeaks();
+        view->setPlainText(MemoryAccounting::report());
+    });
+    connect(closeBtn, &QPushButton::clicked, &dialog, &QDialog::accept);
+    
+    dialog.exec();
+}
+
+void MainWindow::onRecordWorkloadToggled(bool checked)
+{
+    QAction *action = qobject_cast<QAction*>(sender());
+    
+    if (!checked) {
+        if (!workloadRecorder.isRecording()) return;
+        qint64 count = workloadRecorder.operationCount();
+        QString fileName = workloadRecorder.fileName();
+        workloadRecorder.stop();
+        addActivityLog("WORKLOAD", QString("Capture arrêtée: %1 opérations").arg(count));
+        QMessageBox::information(this, "Capture de charge",
+            QString("%1 opérations enregistrées dans:\n%2\n\n"
+                    "Rejouer avec: fournisseur-cli replay %2 --speed 1 --clients 4")
+            .arg(count).arg(fileName));
+        return;
+    }
+    
+    QString fileName = QFileDialog::getSaveFileName(this, "Enregistrer la charge",
+                                                    "workload.jsonl", "Capture JSONL (*.jsonl)");
+    if (fileName.isEmpty() || !workloadRecorder.start(fileName, listeFournisseurs)) {
+        if (!fileName.isEmpty()) {
+            QMessageBox::warning(this, "Erreur", "Impossible de créer le fichier de capture!");
+        }
+        if (action) {
+            QSignalBlocker blocker(action);
+            action->setChecked(false);
+        }
+        return;
+    }
+    addActivityLog("WORKLOAD", QString("Capture démarrée: %1").arg(fileName));
+}
+
 void MainWindow::onRateSupplierClicked()
 {
     if (currentSelectedId == -1) {
@@ -798,6 +1547,15 @@ void MainWindow::onRateSupplierClicked()
     layout->addWidget(commLabel);
     layout->addWidget(commSlider);
     
+    // Delivery figures come from the recorded events
+    DeliveryMetrics delivery = deliveries.metrics(currentSelectedId);
+    layout->addWidget(new QLabel(delivery.orders > 0
+        ? QString("<br>🚚 %1 commandes, %2 livrées, %3% à l'heure, délai moyen %4 jours")
+              .arg(delivery.orders).arg(delivery.delivered)
+              .arg(delivery.onTimePercentage(), 0, 'f', 0)
+              .arg(delivery.averageDeliveryTime(), 0, 'f', 1)
+        : QString("<br>🚚 Aucune livraison enregistrée")));
+    
     // Comments
     layout->addWidget(new QLabel("<br>Commentaires:"));
     QTextEdit *commentsEdit = new QTextEdit();
@@ -819,12 +1577,13 @@ void MainWindow::onRateSupplierClicked()
         SupplierRating* existing = getRatingForSupplier(currentSelectedId);
         
         if (existing) {
-            // Update existing rating
+            // Update existing rating; the previous one stays in the history
             existing->setQualityScore(qualitySlider->value());
             existing->setDeliveryScore(deliverySlider->value());
             existing->setPriceScore(priceSlider->value());
             existing->setCommunicationScore(commSlider->value());
             existing->setComments(commentsEdit->toPlainText());
+            existing->setRatedDate(QDateTime::currentDateTime());
         } else {
             // Create new rating
             SupplierRating newRating(
@@ -835,19 +1594,235 @@ void MainWindow::onRateSupplierClicked()
                 commSlider->value(),
                 commentsEdit->toPlainText()
             );
+            applyDeliveryMetrics(newRating);
             supplierRatings.append(newRating);
+            existing = &supplierRatings.last();
+        }
+        ratingHistory.append(RatingEvent::fromRating(*existing));
+        // The list may have been reloaded while the dialog was open: look the supplier up again
+        for (const Fournisseur& f : listeFournisseurs) {
+            if (f.getIdFournisseur() == currentSelectedId) {
+                rankFournisseur(f);
+                break;
+            }
+        }
+        if (!ratingHistory.saveToFile("rating_history.json")) {
+            QMessageBox::warning(this, "Erreur", "Historique des notes non sauvegardé: " + ratingHistory.getLastError());
         }
         
         saveAdvancedData();
         addActivityLog("RATE", QString("Fournisseur noté: %1").arg(supplierName), currentSelectedId);
         
-        double rating = (qualitySlider->value() + deliverySlider->value() + 
-                        priceSlider->value() + commSlider->value()) / 4.0;
+        const RatingScores& scores = ratingHistory.scores(currentSelectedId);
         QMessageBox::information(this, "Succès", 
-            QString("Note enregistrée!\nNote moyenne: %.1f/5 ⭐").arg(rating));
+            QString("Note enregistrée: %1/5 ⭐\n\n"
+                    "Moyenne sur %2 notes: %3/5\n"
+                    "30 derniers jours: %4/5 - 90 derniers jours: %5/5")
+            .arg(existing->getOverallRating(), 0, 'f', 1)
+            .arg(scores.count)
+            .arg(scores.allTime, 0, 'f', 2)
+            .arg(scores.decayed30, 0, 'f', 2)
+            .arg(scores.decayed90, 0, 'f', 2));
     }
 }
 
+void MainWindow::onRecordDeliveryClicked()
+{
+    if (currentSelectedId == -1) {
+        QMessageBox::warning(this, "Erreur", 
+            "Veuillez sélectionner un fournisseur!");
+        return;
+    }
+    
+    int index = -1;
+    for (int i = 0; i < listeFournisseurs.size(); ++i) {
+        if (listeFournisseurs[i].getIdFournisseur() == currentSelectedId) {
+            index = i;
+            break;
+        }
+    }
+    if (index == -1) return;
+    
+    QDialog dialog(this);
+    dialog.setWindowTitle("🚚 Enregistrer une Livraison");
+    dialog.setMinimumWidth(350);
+    
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    layout->addWidget(new QLabel(QString("<b>Fournisseur: %1</b>").arg(listeFournisseurs[index].getNom())));
+    
+    // A pending order can be marked delivered instead of recording a new one
+    QComboBox *orderCombo = new QComboBox();
+    orderCombo->addItem("➕ Nouvelle commande", -1);
+    QVector<DeliveryEvent> history = deliveries.events(currentSelectedId);
+    for (int i = 0; i < history.size(); ++i) {
+        if (history[i].actualDate.isValid()) continue;
+        orderCombo->addItem(QString("⏳ Commande du %1 (promise le %2) - %3 unités")
+                                .arg(history[i].orderDate.toString("dd/MM/yyyy"),
+                                     history[i].promisedDate.toString("dd/MM/yyyy"))
+                                .arg(history[i].quantity), i);
+    }
+    
+    QDate today = QDate::currentDate();
+    QDateEdit *orderEdit = new QDateEdit(today);
+    QDateEdit *promisedEdit = new QDateEdit(today.addDays(7));
+    QDateEdit *actualEdit = new QDateEdit(today);
+    for (QDateEdit *edit : { orderEdit, promisedEdit, actualEdit }) edit->setCalendarPopup(true);
+    QCheckBox *deliveredCheck = new QCheckBox("Livrée");
+    deliveredCheck->setChecked(true);
+    connect(deliveredCheck, &QCheckBox::toggled, actualEdit, &QWidget::setEnabled);
+    QSpinBox *quantitySpin = new QSpinBox();
+    quantitySpin->setRange(1, 1000000);
+    
+    connect(orderCombo, &QComboBox::currentIndexChanged, &dialog, [=]() {
+        bool pending = orderCombo->currentData().toInt() >= 0;
+        for (QWidget *edit : { static_cast<QWidget*>(orderEdit), static_cast<QWidget*>(promisedEdit),
+                               static_cast<QWidget*>(quantitySpin), static_cast<QWidget*>(deliveredCheck) }) {
+            edit->setEnabled(!pending);
+        }
+        if (pending) deliveredCheck->setChecked(true);
+    });
+    
+    layout->addWidget(new QLabel("Commande:"));
+    layout->addWidget(orderCombo);
+    layout->addWidget(new QLabel("Date de commande:"));
+    layout->addWidget(orderEdit);
+    layout->addWidget(new QLabel("Date promise:"));
+    layout->addWidget(promisedEdit);
+    layout->addWidget(deliveredCheck);
+    layout->addWidget(actualEdit);
+    layout->addWidget(new QLabel("Quantité:"));
+    layout->addWidget(quantitySpin);
+    
+    QPushButton *saveBtn = new QPushButton("💾 Enregistrer");
+    QPushButton *cancelBtn = new QPushButton("❌ Annuler");
+    QHBoxLayout *btnLayout = new QHBoxLayout();
+    btnLayout->addWidget(saveBtn);
+    btnLayout->addWidget(cancelBtn);
+    layout->addLayout(btnLayout);
+    
+    connect(saveBtn, &QPushButton::clicked, &dialog, &QDialog::accept);
+    connect(cancelBtn, &QPushButton::clicked, &dialog, &QDialog::reject);
+    
+    if (dialog.exec() != QDialog::Accepted) return;
+    
+    // Only the change is appended to livraisons.dat
+    int pendingIndex = orderCombo->currentData().toInt();
+    bool saved = false;
+    if (pendingIndex >= 0) {
+        if (!deliveries.markDelivered(currentSelectedId, pendingIndex, actualEdit->date())) {
+            QMessageBox::warning(this, "Erreur", "Livraison refusée: " + deliveries.getLastError());
+            return;
+        }
+        saved = deliveries.appendDeliveredToFile("livraisons.dat", currentSelectedId, pendingIndex,
+                                                 actualEdit->date());
+    } else {
+        DeliveryEvent event;
+        event.fournisseurId = currentSelectedId;
+        event.orderDate = orderEdit->date();
+        event.promisedDate = promisedEdit->date();
+        if (deliveredCheck->isChecked()) event.actualDate = actualEdit->date();
+        event.quantity = quantitySpin->value();
+        
+        if (!deliveries.append(event)) {
+            QMessageBox::warning(this, "Erreur", "Livraison refusée: " + deliveries.getLastError());
+            return;
+        }
+        saved = deliveries.appendToFile("livraisons.dat", event);
+    }
+    if (!saved) {
+        QMessageBox::warning(this, "Erreur", "Livraisons non sauvegardées: " + deliveries.getLastError());
+    }
+    
+    // Ratings and the Historique column follow the events
+    if (SupplierRating *rating = getRatingForSupplier(currentSelectedId)) {
+        applyDeliveryMetrics(*rating);
+        saveAdvancedData();
+    }
+    listeFournisseurs[index].setHistoriqueLivraisons(deliveries.summary(currentSelectedId));
+    supplierStore.replace(index, listeFournisseurs[index]);
+    if (useDatabase && dbManager) {
+        if (!dbManager->updateFournisseur(listeFournisseurs[index])) {
+            QMessageBox::warning(this, "Erreur",
+                QString("Erreur lors de la mise à jour dans %1!").arg(dbManager->getDatabaseType()));
+        }
+    } else {
+        saveToFile();
+    }
+    
+    addActivityLog("DELIVERY", QString("Livraison enregistrée: %1").arg(listeFournisseurs[index].getNom()),
+                   currentSelectedId);
+    refreshTableView();
+}
+
+void MainWindow::onLeadTimeDashboardClicked()
+{
+    TRACE_SCOPE("MainWindow::onLeadTimeDashboardClicked");
+    if (deliveries.eventCount() == 0) {
+        QMessageBox::information(this, "Délais de livraison", "Aucune livraison enregistrée.");
+        return;
+    }
+    
+    // Per-supplier sketches merged by product type, ratings sketched the same way
+    QHash<int, quint32> typeOf;
+    QMap<QString, quint32> types;
+    AdvancedStats::Accumulator accumulator(ratingHistory, QList<ActivityLog>());
+    typeOf.reserve(listeFournisseurs.size());
+    for (const Fournisseur& f : listeFournisseurs) {
+        typeOf.insert(f.getIdFournisseur(), f.getTypeCode());
+        accumulator.add(f);
+    }
+    QHash<quint32, TDigest> leadTimes = deliveries.leadTimesByGroup(typeOf);
+    AdvancedStats::Stats stats = accumulator.result();
+    for (auto it = leadTimes.constBegin(); it != leadTimes.constEnd(); ++it) {
+        if (it.key() == DeliveryEventStore::AllGroups) continue;
+        QString type = ProductTypes::label(it.key());
+        types.insert(type.isEmpty() ? "Non spécifié" : type, it.key());
+    }
+    
+    auto row = [](const QString& type, const TDigest& lead, const TDigest *rating) {
+        return QString("%1 %2 %3 %4 %5 %6\n")
+            .arg(type.left(24), -24)
+            .arg(qint64(lead.count()), 11)
+            .arg(lead.quantile(0.5), 7, 'f', 1)
+            .arg(lead.quantile(0.9), 7, 'f', 1)
+            .arg(lead.quantile(0.99), 7, 'f', 1)
+            .arg(rating && !rating->isEmpty() ? QString::number(rating->quantile(0.5), 'f', 1) : QString("-"), 9);
+    };
+    
+    QString text = QString("%1 %2 %3 %4 %5 %6\n")
+        .arg(QString("Type"), -24).arg(QString("Livraisons"), 11)
+        .arg(QString("p50 (j)"), 7).arg(QString("p90 (j)"), 7).arg(QString("p99 (j)"), 7)
+        .arg(QString("Note p50"), 9);
+    text += QString(70, QChar('-')) + "\n";
+    for (auto it = types.constBegin(); it != types.constEnd(); ++it) {
+        auto rating = stats.ratingsByProductType.constFind(it.key());
+        text += row(it.key(), leadTimes.value(it.value()),
+                    rating != stats.ratingsByProductType.constEnd() ? &*rating : nullptr);
+    }
+    text += QString(70, QChar('-')) + "\n";
+    TDigest allRatings;
+    for (const TDigest& rating : stats.ratingsByProductType) allRatings.merge(rating);
+    text += row("Tous", leadTimes.value(DeliveryEventStore::AllGroups), &allRatings);
+    text += QString("\n%1 événements, délais = date réelle - date de commande\n").arg(deliveries.eventCount());
+    
+    QDialog dialog(this);
+    dialog.setWindowTitle("📉 Tableau des Délais");
+    dialog.setMinimumSize(650, 400);
+    
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    QTextEdit *view = new QTextEdit();
+    view->setReadOnly(true);
+    view->setFont(QFont("Courier New", 9));
+    view->setPlainText(text);
+    layout->addWidget(view);
+    
+    QPushButton *closeBtn = new QPushButton("Fermer");
+    connect(closeBtn, &QPushButton::clicked, &dialog, &QDialog::accept);
+    layout->addWidget(closeBtn);
+    
+    dialog.exec();
+}
+
 void MainWindow::onViewActivityLogClicked()
 {
     QDialog dialog(this);
@@ -879,14 +1854,18 @@ void MainWindow::onViewActivityLogClicked()
 
 void MainWindow::onBackupClicked()
 {
-    QString backupPath;
-    if (BackupManager::createBackup("fournisseurs.json", backupPath)) {
-        addActivityLog("BACKUP", QString("Sauvegarde créée: %1").arg(backupPath));
-        QMessageBox::information(this, "Succès", 
-            QString("Sauvegarde créée avec succès!\n\nFichier: %1").arg(backupPath));
-    } else {
-        QMessageBox::warning(this, "Erreur", "Échec de la création de la sauvegarde!");
-    }
+    auto backupPath = std::make_shared<QString>();
+    startJob("Sauvegarde", JobScheduler::Batch, [backupPath](JobContext&) {
+        return BackupManager::createBackup("fournisseurs.json", *backupPath);
+    }, [this, backupPath](bool ok, const QString&) {
+        if (ok) {
+            addActivityLog("BACKUP", QString("Sauvegarde créée: %1").arg(*backupPath));
+            QMessageBox::information(this, "Succès", 
+                QString("Sauvegarde créée avec succès!\n\nFichier: %1").arg(*backupPath));
+        } else {
+            QMessageBox::warning(this, "Erreur", "Échec de la création de la sauvegarde!");
+        }
+    });
 }
 
 void MainWindow::onRestoreBackupClicked()
@@ -910,14 +1889,23 @@ void MainWindow::onRestoreBackupClicked()
             QMessageBox::Yes | QMessageBox::No);
         
         if (reply == QMessageBox::Yes) {
-            if (BackupManager::restoreBackup("backups/" + selected, "fournisseurs.json")) {
-                loadFromFile();
-                refreshTableView();
+            // File copy as a job; reloading the list happens back on the GUI thread
+            startJob(QString("Restauration: %1").arg(selected), JobScheduler::Batch, [selected](JobContext&) {
+                return BackupManager::restoreBackup("backups/" + selected, "fournisseurs.json");
+            }, [this, selected](bool ok, const QString&) {
+                if (!ok) {
+                    QMessageBox::warning(this, "Erreur", "Échec de la restauration!");
+                    return;
+                }
+                if (jsonReloader->isActive()) {
+                    jsonReloader->reloadNow();   // only the differing rows are touched
+                } else {
+                    loadFromFile();
+                    refreshTableView();
+                }
                 addActivityLog("RESTORE", QString("Sauvegarde restaurée: %1").arg(selected));
                 QMessageBox::information(this, "Succès", "Sauvegarde restaurée avec succès!");
-            } else {
-                QMessageBox::warning(this, "Erreur", "Échec de la restauration!");
-            }
+            });
         }
     }
 }
@@ -967,29 +1955,10 @@ void MainWindow::onAdvancedFilterClicked()
         criteria.typeProduits = typeFilter->text();
         criteria.adresse = adresseFilter->text();
         
-        tableModel->removeRows(0, tableModel->rowCount());
-        int count = 0;
-        
-        for (const Fournisseur& f : listeFournisseurs) {
-            SupplierRating* rating = getRatingForSupplier(f.getIdFournisseur());
-            int ratingValue = rating ? (int)rating->getOverallRating() : 0;
-            
-            if (criteria.matches(f.getNom(), f.getEmail(), f.getTypeProduits(), 
-                               f.getAdresse(), ratingValue, f.getIsActive())) {
-                QList<QStandardItem*> row;
-                row.append(new QStandardItem(QString::number(f.getIdFournisseur())));
-                row.append(new QStandardItem(f.getNom()));
-                row.append(new QStandardItem(f.getAdresse()));
-                row.append(new QStandardItem(f.getEmail()));
-                row.append(new QStandardItem(f.getTelephone()));
-                row.append(new QStandardItem(f.getTypeProduits()));
-                row.append(new QStandardItem(f.getHistoriqueLivraisons()));
-                tableModel->appendRow(row);
-                count++;
-            }
-        }
+        int count = applyFilter(criteria);
         
         addActivityLog("FILTER", QString("Filtre appliqué, %1 résultats").arg(count));
+        if (workloadRecorder.isRecording()) workloadRecorder.record(WorkloadOp::filter(criteria));
         QMessageBox::information(&dialog, "Résultats", QString("%1 fournisseurs trouvés").arg(count));
     });
     
@@ -1004,10 +1973,31 @@ void MainWindow::onAdvancedFilterClicked()
 
 void MainWindow::onAdvancedStatsClicked()
 {
-    AdvancedStats::Stats stats = AdvancedStats::calculateStats(
-        listeFournisseurs, supplierRatings, activityLog
-    );
-    
+    TRACE_SCOPE("MainWindow::onAdvancedStatsClicked");
+    SupplierSnapshotPtr snapshot = supplierStore.snapshot();
+    RatingHistory history = ratingHistory;      // implicitly shared copy for the job
+    QList<ActivityLog> activities = activityLog;
+    
+    auto stats = std::make_shared<AdvancedStats::Stats>();
+    startJob("Statistiques avancées", JobScheduler::Interactive,
+             [snapshot, history, activities, stats](JobContext& job) {
+        TRACE_SCOPE("AdvancedStats::calculateStats");
+        AdvancedStats::Accumulator accumulator(history, activities);
+        qint64 seen = 0;
+        snapshot->forEach([&](const Fournisseur& f) {
+            if (job.isCancelled()) return;
+            accumulator.add(f);
+            if ((++seen & 16383) == 0) job.setProgress(seen, snapshot->size());
+        });
+        *stats = accumulator.result();
+        return !job.isCancelled();
+    }, [this, stats](bool ok, const QString&) {
+        if (ok) showAdvancedStats(*stats);
+    });
+}
+
+void MainWindow::showAdvancedStats(const AdvancedStats::Stats& stats)
+{
     QString statsText = QString(
         "╔═══════════════════════════════════════╗\n"
         "║   STATISTIQUES AVANCÉES               ║\n"
@@ -1047,6 +2037,12 @@ void MainWindow::onAdvancedStatsClicked()
                 .arg(it.key())
                 .arg(it.value());
         }
+        statsText += QString("  • Médiane: %1/5 - 90e centile: %2/5\n")
+            .arg(stats.ratingMedian, 0, 'f', 2)
+            .arg(stats.ratingP90, 0, 'f', 2);
+        statsText += QString("  • Moyenne récente: %1/5 (30 jours) - %2/5 (90 jours)\n")
+            .arg(stats.averageRating30, 0, 'f', 2)
+            .arg(stats.averageRating90, 0, 'f', 2);
     }
     
     QMessageBox msgBox(this);
@@ -1300,21 +2296,160 @@ bool MainWindow::connectToOracle()
     return false;
 }
 
+bool MainWindow::connectToMemoryEngine(const QString& journal)
+{
+    dbManager = new DatabaseManager(DatabaseManager::InMemory);
+    if (!dbManager->connectToDatabase(journal)) {
+        qDebug() << "❌ In-memory engine not opened:" << dbManager->getLastError();
+        delete dbManager;
+        dbManager = nullptr;
+        return false;
+    }
+    
+    // New journal: start from the JSON data, ids kept
+    if (dbManager->getTotalCount() == 0 && QFile::exists("fournisseurs.json")) {
+        bool success;
+        QList<Fournisseur> loaded = JsonStorage::loadFromFile("fournisseurs.json", success);
+        if (success && !dbManager->insertBatch(loaded, true)) {
+            qDebug() << "⚠️ fournisseurs.json not imported:" << dbManager->getLastError();
+        }
+    }
+    return true;
+}
+
 void MainWindow::loadFromDatabase()
 {
+    TRACE_SCOPE("MainWindow::loadFromDatabase");
     if (!dbManager || !dbManager->isConnected()) {
         return;
     }
     
+    // Database clock before the read: later changes arrive through the delta poller
     bool success;
+    QDateTime loadedAt = dbManager->currentServerTime(success);
     listeFournisseurs = dbManager->getAllFournisseurs(success);
     
     if (success) {
-        qDebug() << "✅ Loaded" << listeFournisseurs.size() << "suppliers from Oracle";
-        addActivityLog("LOAD_DB", QString("Loaded %1 suppliers from Oracle").arg(listeFournisseurs.size()));
+        rebuildIndexes();
+        dbManager->purgeTombstones(loadedAt.addDays(-30));
+        if (loadedAt.isValid()) {
+            if (!deltaSync) {
+                deltaSync = new DeltaSyncPoller(dbManager->getConnectionName(),
+                                                dbManager->getType(), this);
+                connect(deltaSync, &DeltaSyncPoller::changesReady,
+                        this, &MainWindow::onDatabaseChanges);
+            }
+            deltaSync->start(loadedAt.addMSecs(-DeltaSyncPoller::OverlapMs));
+        }
+        qDebug() << "✅ Loaded" << listeFournisseurs.size() << "suppliers from" << dbManager->getDatabaseType();
+        addActivityLog("LOAD_DB", QString("Loaded %1 suppliers from %2")
+                       .arg(listeFournisseurs.size()).arg(dbManager->getDatabaseType()));
     } else {
-        qDebug() << "❌ Error loading from Oracle:" << dbManager->getLastError();
+        qDebug() << "❌ Error loading from" << dbManager->getDatabaseType() << ":" << dbManager->getLastError();
+    }
+}
+
+void MainWindow::onDatabaseChanges(const DatabaseManager::ChangeSet& changes)
+{
+    applyExternalChanges(changes.upserts, changes.deletedIds, "Delta sync");
+}
+
+void MainWindow::onJsonFileChanged(const QList<Fournisseur>& upserts, const QList<int>& deletedIds)
+{
+    applyExternalChanges(upserts, deletedIds, "Rechargement JSON");
+}
+
+void MainWindow::applyExternalChanges(const QList<Fournisseur>& upserts, const QList<int>& deletedIds,
+                                      const QString& source)
+{
+    TRACE_SCOPE("MainWindow::applyExternalChanges");
+    
+    // The advanced filter shows a subset: rows no longer map 1:1, rebuild after applying
+    bool modelInSync = tableModel->rowCount() == listeFournisseurs.size();
+    
+    QHash<int, int> rowOfId;
+    rowOfId.reserve(listeFournisseurs.size());
+    for (int i = 0; i < listeFournisseurs.size(); ++i) {
+        rowOfId.insert(listeFournisseurs[i].getIdFournisseur(), i);
+    }
+    
+    int updated = 0;
+    int inserted = 0;
+    supplierStore.beginBatch();
+    for (const Fournisseur& f : upserts) {
+        auto it = rowOfId.constFind(f.getIdFournisseur());
+        if (it == rowOfId.constEnd()) {
+            listeFournisseurs.append(f);
+            supplierStore.append(f);
+            indexFournisseur(f);
+            if (modelInSync) tableModel->appendRow(makeRow(f));
+            inserted++;
+            continue;
+        }
+        
+        // Our own writes (and the poll overlap) come back unchanged
+        int row = it.value();
+        if (listeFournisseurs[row] == f) continue;
+        
+        unindexFournisseur(listeFournisseurs[row]);
+        listeFournisseurs[row] = f;
+        supplierStore.replace(row, f);
+        indexFournisseur(f);
+        if (modelInSync) {
+            // Edit the items in place: dataChanged only, selection and scroll stay put
+            QList<QStandardItem*> items = makeRow(f);
+            for (int column = 0; column < items.size(); ++column) {
+                tableModel->item(row, column)->setText(items[column]->text());
+            }
+            qDeleteAll(items);
+        }
+        updated++;
+    }
+    
+    // Highest rows first so the remaining row numbers stay valid
+    QList<int> removedRows;
+    for (int id : deletedIds) {
+        auto it = rowOfId.constFind(id);
+        if (it != rowOfId.constEnd()) removedRows.append(it.value());
+    }
+    std::sort(removedRows.begin(), removedRows.end(), std::greater<int>());
+    for (int row : removedRows) {
+        if (listeFournisseurs[row].getIdFournisseur() == currentSelectedId) {
+            clearInputFields();
+        }
+        unindexFournisseur(listeFournisseurs[row]);
+        listeFournisseurs.removeAt(row);
+        supplierStore.removeAt(row);
+        if (modelInSync) tableModel->removeRow(row);
+    }
+    supplierStore.endBatch();
+    
+    if (updated + inserted + removedRows.size() == 0) return;
+    
+    if (modelInSync) {
+        invalidateSearchState();
+    } else {
+        // Full rebuild under the same filter: put the selection and scroll position back afterwards
+        int selectedId = currentSelectedId;
+        int scroll = ui->tableView->verticalScrollBar()->value();
+        if (filterActive) {
+            applyFilter(activeFilter);
+        } else {
+            refreshTableView();
+        }
+        if (selectedId != -1) {
+            // Filtered rows are not list rows: find the selection by its id column
+            for (int row = 0; row < tableModel->rowCount(); ++row) {
+                if (tableModel->item(row, 0)->text().toInt() == selectedId) {
+                    ui->tableView->selectRow(row);
+                    break;
+                }
+            }
+        }
+        ui->tableView->verticalScrollBar()->setValue(scroll);
     }
+    qDebug() << "🔄" << source << ":" << inserted << "added," << updated << "updated,"
+             << removedRows.size() << "deleted";
 }
 
 void MainWindow::saveToDatabase()
@@ -1325,5 +2460,5 @@ void MainWindow::saveToDatabase()
     
     // Database is updated in real-time with each operation
     // This method can be used for batch operations if needed
-    qDebug() << "💾 Data synced to Oracle";
+    qDebug() << "💾 Data synced to" << dbManager->getDatabaseType();
 }
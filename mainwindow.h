@@ -4,9 +4,27 @@
 #include <QMainWindow>
 #include <QList>
 #include <QStandardItemModel>
+#include <QTimer>
 #include "fournisseur.h"
 #include "advancedfeatures.h"
 #include "databasemanager.h"
+#include "livesearch.h"
+#include "fuzzysearch.h"
+#include "duplicatedetector.h"
+#include "contactindex.h"
+#include "prefixindex.h"
+#include "workload.h"
+#include "deltasync.h"
+#include "jsonreloader.h"
+#include "supplierstore.h"
+#include "jobscheduler.h"
+#include "jobspanel.h"
+#include "deliverystore.h"
+#include "leaderboard.h"
+
+class QCompleter;
+class QLineEdit;
+class LeaderboardPanel;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -36,33 +54,101 @@ private slots:
     // Advanced Feature Slots
     void onExportCSVClicked();
     void onImportCSVClicked();
+    void onMultiExportClicked();
     void onRateSupplierClicked();
+    void onRecordDeliveryClicked();
+    void onLeadTimeDashboardClicked();
     void onViewActivityLogClicked();
     void onBackupClicked();
     void onRestoreBackupClicked();
     void onAdvancedFilterClicked();
     void onAdvancedStatsClicked();
     void onAdvancedFeaturesButtonClicked();
+    void onDetectDuplicatesClicked();
+    void onExportTraceClicked();
+    void onDatabaseDiagnosticsClicked();
+    void onMemoryReportClicked();
+    void onRecordWorkloadToggled(bool checked);
+    void onDatabaseChanges(const DatabaseManager::ChangeSet& changes);
+    void onJsonFileChanged(const QList<Fournisseur>& upserts, const QList<int>& deletedIds);
+    
+    // Live search
+    void onSearchTextChanged();
+    void onSearchDebounced();
+    void onSearchStep();
+    void onAdresseEdited(const QString& text);
 
 private:
     Ui::MainWindow *ui;
     QList<Fournisseur> listeFournisseurs;
+    SupplierStore supplierStore;   // published copy of listeFournisseurs for background readers
     QStandardItemModel *tableModel;
     int currentSelectedId;
     
     // Advanced Features Data
-    QList<SupplierRating> supplierRatings;
+    QList<SupplierRating> supplierRatings;     // latest rating of each supplier
+    RatingHistory ratingHistory;                // every rating, scores precomputed
+    SupplierLeaderboard leaderboard;            // rated suppliers by all-time score, per type
+    DeliveryEventStore deliveries;      // source of the ratings' delivery metrics
     QList<ActivityLog> activityLog;
     
     // Database Manager for Oracle/SQLite
     DatabaseManager *dbManager;
     bool useDatabase;
+    DeltaSyncPoller *deltaSync;   // incremental refresh after the initial full load
+    JsonFileReloader *jsonReloader;   // same for external edits of fournisseurs.json
+    JobScheduler *jobScheduler;       // exports, imports, backups and reports
+    JobsPanel *jobsPanel;
+    LeaderboardPanel *leaderboardPanel;
+    
+    // Live search state
+    IncrementalSearch liveSearch;
+    QTimer *searchDebounceTimer;
+    QTimer *searchStepTimer;
+    QVector<int> visibleRows;     // rows shown by the last search, ascending
+    bool allRowsVisible;
+    
+    // Advanced filter shown in the table, re-applied when external changes rebuild it
+    FilterCriteria activeFilter;
+    bool filterActive;
+    
+    // Fuzzy name index, rebuilt lazily after the list changes
+    FuzzyNameIndex fuzzyIndex;
+    bool fuzzyIndexDirty;
+    
+    // Unique email / phone keys
+    ContactIndex contactIndex;
+    
+    // Suppliers per product type code, kept up to date with the list (statistics)
+    QVector<int> typeCounts;
+    
+    // Autocomplete indexes and their completers
+    PrefixIndex nomCompletions;
+    PrefixIndex typeCompletions;
+    PrefixIndex cityCompletions;
+    QCompleter *nomCompleter;
+    QCompleter *adresseCompleter;
+    QCompleter *typeCompleter;
+    
+    // Workload capture (operations + payloads, for fournisseur-cli replay)
+    WorkloadRecorder workloadRecorder;
 
     // Helper methods
     void setupTableView();
     void refreshTableView();
+    int applyFilter(const FilterCriteria& criteria);
     void clearInputFields();
     void loadFournisseurToFields(const Fournisseur& f);
+    void applySearchResults();
+    void invalidateSearchState();
+    void showAdvancedStats(const AdvancedStats::Stats& stats);
+    int startJob(const QString& title, JobScheduler::Priority priority,
+                 JobScheduler::Work work, JobScheduler::Done onDone);
+    void importParsedRows(const QList<Fournisseur>& importedData);
+    void applyExternalChanges(const QList<Fournisseur>& upserts, const QList<int>& deletedIds,
+                              const QString& source);
+    QList<QStandardItem*> makeRow(const Fournisseur& f) const;
+    void showAllRows();
     int generateNewId();
     
     // Data persistence
@@ -73,20 +159,34 @@ private:
     
     // Validation
     bool validateInputs();
+    bool checkContactConflict(const Fournisseur& f);
+    
+    // Secondary indexes (contacts, autocomplete), kept in sync with the list
+    void indexFournisseur(const Fournisseur& f);
+    void unindexFournisseur(const Fournisseur& f);
+    void rebuildIndexes();
+    QCompleter* createCompleter(QLineEdit *edit);
+    void showCompletions(QCompleter *completer, const QStringList& items);
     
     // Sorting
     void sortByNom();
     void sortById();
     void sortByTypeProduits();
-    void sortByRating();
+    void sortByRating(RatingHistory::Window window = RatingHistory::AllTime);
     
     // Advanced features
     void addActivityLog(const QString& action, const QString& description, int fId = -1);
     SupplierRating* getRatingForSupplier(int fournisseurId);
+    void applyDeliveryMetrics(SupplierRating& rating) const;
+    void rankFournisseur(const Fournisseur& f);
+    void rebuildLeaderboard();
+    void selectFournisseur(int fournisseurId);
     void createAdvancedMenu();
+    void updateMemoryEstimates();
     
     // Database connection
     bool connectToOracle();
+    bool connectToMemoryEngine(const QString& journal);
     void loadFromDatabase();
     void saveToDatabase();
 };
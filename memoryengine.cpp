@@ -0,0 +1,600 @@
+#include "memoryengine.h"
+#include "coldtext.h"
+#include "memorytracker.h"
+#include "tracing.h"
+#include <QDataStream>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QTimeZone>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+const quint32 JournalMagic = 0x464A524E;  // "FJRN"
+const quint16 JournalVersion = 1;
+const qint64 JournalSlack = 1000;          // records tolerated above 2x the live data
+const qint64 ArenaSlack = 1 << 20;         // replaced text bytes before the arena is rewritten
+const int BatchChunk = 4096;               // records per journal write in a batch
+
+QMutex enginesMutex;
+QHash<QString, std::weak_ptr<MemoryEngine>> engines;    // by absolute journal path
+
+QByteArray journalHeader()
+{
+    QByteArray header;
+    QDataStream out(&header, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << JournalMagic << JournalVersion;
+    return header;
+}
+
+char foldAscii(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+}
+
+// LIKE '%needle%' as SQLite evaluates it: only ASCII letters are case-insensitive
+bool containsFolded(QByteArrayView text, const QByteArray& needle)
+{
+    const qsizetype last = text.size() - needle.size();
+    for (qsizetype i = 0; i <= last; ++i) {
+        qsizetype j = 0;
+        while (j < needle.size() && foldAscii(text[i + j]) == needle[j]) ++j;
+        if (j == needle.size()) return true;
+    }
+    return false;
+}
+
+QByteArray folded(const QString& text)
+{
+    QByteArray bytes = text.toUtf8();
+    for (char& c : bytes) c = foldAscii(c);
+    return bytes;
+}
+
+// Only the keys ContactIndex looks at: no address or history to decode
+Fournisseur contactOf(const CompactSupplierTable& table, int row)
+{
+    return Fournisseur(table.idAt(row), QString(), QString(),
+                       table.text(row, CompactSupplierTable::Email),
+                       table.text(row, CompactSupplierTable::Telephone), QString(), QString());
+}
+}
+
+const QString MemoryEngine::Volatile = ":memory:";
+
+// ===== MemoryEngine Implementation =====
+MemoryEngine::MemoryEngine(const QString& journalPath)
+    : path(journalPath), records(0), nextId(1), lastStamp(0)
+{
+}
+
+MemoryEngine::~MemoryEngine()
+{
+    if (journal.isOpen()) journal.close();
+}
+
+std::shared_ptr<MemoryEngine> MemoryEngine::open(const QString& journalPath, QString& error)
+{
+    if (journalPath == Volatile) {
+        return std::shared_ptr<MemoryEngine>(new MemoryEngine(journalPath));
+    }
+
+    QString key = QFileInfo(journalPath).absoluteFilePath();
+    QMutexLocker locker(&enginesMutex);
+    std::shared_ptr<MemoryEngine> engine = engines.value(key).lock();
+    if (engine) return engine;
+
+    engine.reset(new MemoryEngine(key));
+    if (!engine->openJournal(error)) return nullptr;
+    engines.insert(key, engine);
+    return engine;
+}
+
+bool MemoryEngine::openJournal(QString& error)
+{
+    TRACE_SCOPE("MemoryEngine::openJournal");
+    // Another process appending or compacting the same file would lose records
+    lockFile.reset(new QLockFile(path + ".lock"));
+    lockFile->setStaleLockTime(0);
+    if (!lockFile->tryLock(0)) {
+        error = "journal déjà ouvert par un autre processus: " + path;
+        return false;
+    }
+
+    journal.setFileName(path);
+    if (!journal.open(QIODevice::ReadWrite)) {
+        error = "ouverture du journal impossible: " + path;
+        return false;
+    }
+    if (journal.size() == 0) {
+        QByteArray header = journalHeader();
+        if (journal.write(header) != header.size() || !journal.flush()) {
+            error = "écriture du journal impossible: " + journal.errorString();
+            return false;
+        }
+        return true;
+    }
+    return replay(error);
+}
+
+bool MemoryEngine::replay(QString& error)
+{
+    QDataStream in(&journal);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != JournalMagic || version != JournalVersion) {
+        error = "format de journal inconnu: " + path;
+        return false;
+    }
+
+    qint64 complete = journal.pos();
+    while (!in.atEnd()) {
+        quint8 op = 0;
+        qint64 ms = 0;
+        qint32 id = 0;
+        in >> op >> ms >> id;
+        if (op == Upsert) {
+            QString nom, adresse, email, telephone, type, historique;
+            bool active = true;
+            in >> nom >> adresse >> email >> telephone >> type >> historique >> active;
+            if (in.status() != QDataStream::Ok) break;
+            applyUpsert(Fournisseur(id, nom, adresse, email, telephone, type, historique, active), ms);
+        } else if (op == Delete && in.status() == QDataStream::Ok) {
+            applyDelete(id, ms);
+        } else {
+            break;
+        }
+        records++;
+        complete = journal.pos();
+    }
+
+    // A crash during a write leaves a partial last record: cut it off, keep the rest
+    if (complete < journal.size()) {
+        qWarning() << "⚠️ Journal tronqué:" << journal.size() - complete << "octets ignorés dans" << path;
+        if (!journal.resize(complete)) {
+            error = "réparation du journal impossible: " + journal.errorString();
+            return false;
+        }
+    }
+    journal.seek(journal.size());
+    return true;
+}
+
+void MemoryEngine::encodeUpsert(QDataStream& out, const Fournisseur& f, qint64 ms)
+{
+    out << quint8(Upsert) << ms << qint32(f.getIdFournisseur())
+        << f.getNom() << f.getAdresse() << f.getEmail() << f.getTelephone()
+        << f.getTypeProduits() << f.getHistoriqueLivraisons() << f.getIsActive();
+}
+
+void MemoryEngine::encodeDelete(QDataStream& out, int id, qint64 ms)
+{
+    out << quint8(Delete) << ms << qint32(id);
+}
+
+bool MemoryEngine::append(const QByteArray& batch, int count, QString& error)
+{
+    if (!journal.isOpen()) return true;
+    // flush() hands the record to the OS: a crash of the process loses nothing
+    const qint64 before = journal.size();
+    if (journal.write(batch) != batch.size() || !journal.flush()) {
+        error = "écriture du journal impossible: " + journal.errorString();
+        // A torn record would stop the replay; cut it back off like insertBatch does
+        journal.resize(before);
+        journal.seek(before);
+        return false;
+    }
+    records += count;
+    return true;
+}
+
+void MemoryEngine::maintain()
+{
+    // Snapshot once replaying would read more than twice the live data
+    if (journal.isOpen() && records > 2 * qint64(table.size() + tombstones.size()) + JournalSlack) {
+        QString error;
+        if (!compactJournal(error)) qWarning() << "⚠️" << error;    // the long journal is still valid
+    }
+    if (table.garbageBytes() > ArenaSlack && table.garbageBytes() * 2 > table.memoryUsage()) {
+        table.compact();
+    }
+}
+
+bool MemoryEngine::compactJournal(QString& error)
+{
+    TRACE_SCOPE("MemoryEngine::compactJournal");
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = "compactage du journal impossible: " + path;
+        return false;
+    }
+
+    // Rows with their modification time, then the tombstones delta sync still needs
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << JournalMagic << JournalVersion;
+    for (const auto& [id, row] : rowOfId) encodeUpsert(out, table.at(row), modified[row]);
+    for (const auto& tombstone : tombstones) encodeDelete(out, tombstone.first, tombstone.second);
+
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        error = "compactage du journal impossible: " + path;
+        return false;
+    }
+
+    journal.close();
+    if (!journal.open(QIODevice::ReadWrite) || !journal.seek(journal.size())) {
+        error = "réouverture du journal impossible: " + journal.errorString();
+        return false;
+    }
+    records = rowOfId.size() + tombstones.size();
+    return true;
+}
+
+qint64 MemoryEngine::stamp()
+{
+    lastStamp = qMax(lastStamp, QDateTime::currentMSecsSinceEpoch());
+    return lastStamp;
+}
+
+QString MemoryEngine::conflict(const Fournisseur& f) const
+{
+    int conflictingId = -1;
+    ContactIndex::Field field = contacts.findConflict(f, &conflictingId);
+    if (field == ContactIndex::None) return QString();
+    return QString("Ce %1 est déjà utilisé par le fournisseur ID %2")
+        .arg(ContactIndex::fieldName(field)).arg(conflictingId);
+}
+
+void MemoryEngine::countType(quint32 code, int delta)
+{
+    if (int(code) >= typeCounts.size()) typeCounts.resize(code + 1);
+    typeCounts[code] += delta;
+}
+
+void MemoryEngine::applyUpsert(const Fournisseur& f, qint64 ms)
+{
+    int id = f.getIdFournisseur();
+    auto it = rowOfId.find(id);
+    if (it != rowOfId.end()) {
+        int row = it->second;
+        contacts.remove(contactOf(table, row));
+        countType(table.typeCodeAt(row), -1);
+        table.replace(row, f);
+        modified[row] = ms;
+    } else {
+        rowOfId.emplace(id, table.append(f));
+        modified.append(ms);
+    }
+    contacts.insert(f);
+    countType(f.getTypeCode(), 1);
+    nextId = qMax(nextId, id + 1);
+    lastStamp = qMax(lastStamp, ms);
+}
+
+bool MemoryEngine::removeRow(int id)
+{
+    auto it = rowOfId.find(id);
+    if (it == rowOfId.end()) return false;
+
+    int row = it->second;
+    int last = table.size() - 1;
+    contacts.remove(contactOf(table, row));
+    countType(table.typeCodeAt(row), -1);
+
+    // The last row fills the hole: nothing shifts, one map entry moves
+    if (row != last) {
+        table.replace(row, table.at(last));
+        modified[row] = modified[last];
+        rowOfId[table.idAt(row)] = row;
+    }
+    table.removeAt(last);
+    modified.removeLast();
+    rowOfId.erase(it);
+    return true;
+}
+
+bool MemoryEngine::applyDelete(int id, qint64 ms)
+{
+    lastStamp = qMax(lastStamp, ms);
+    if (!removeRow(id)) return false;
+    tombstones.append({ id, ms });
+    return true;
+}
+
+bool MemoryEngine::insert(const Fournisseur& f, bool preserveId, QString& error, int* newId)
+{
+    TRACE_SCOPE("MemoryEngine::insert");
+    QWriteLocker locker(&lock);
+
+    Fournisseur row = f;
+    if (!preserveId) {
+        row.setIdFournisseur(nextId);
+    } else if (rowOfId.count(row.getIdFournisseur())) {
+        error = QString("L'identifiant %1 existe déjà").arg(row.getIdFournisseur());
+        return false;
+    }
+    error = conflict(row);
+    if (!error.isEmpty()) return false;
+
+    qint64 ms = stamp();
+    QByteArray record;
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    encodeUpsert(out, row, ms);
+    if (!append(record, 1, error)) return false;
+
+    applyUpsert(row, ms);
+    maintain();
+    if (newId) *newId = row.getIdFournisseur();
+    return true;
+}
+
+bool MemoryEngine::insertBatch(const QList<Fournisseur>& fournisseurs, bool preserveIds, QString& error)
+{
+    TRACE_SCOPE("MemoryEngine::insertBatch");
+    QWriteLocker locker(&lock);
+    error.clear();
+
+    // Applied first so rows of the batch are checked against each other too
+    const int firstId = nextId;
+    const qint64 ms = stamp();
+    QList<Fournisseur> applied;
+    applied.reserve(fournisseurs.size());
+    for (const Fournisseur& source : fournisseurs) {
+        Fournisseur f = source;
+        if (!preserveIds) {
+            f.setIdFournisseur(nextId);
+        } else if (rowOfId.count(f.getIdFournisseur())) {
+            error = QString("L'identifiant %1 existe déjà").arg(f.getIdFournisseur());
+            break;
+        }
+        error = conflict(f);
+        if (!error.isEmpty()) break;
+        applyUpsert(f, ms);
+        applied.append(f);
+    }
+
+    // Journaled in chunks; a failed write is cut back off the file
+    const qint64 start = journal.isOpen() ? journal.size() : 0;
+    for (int i = 0; error.isEmpty() && i < applied.size(); i += BatchChunk) {
+        QByteArray chunk;
+        QDataStream out(&chunk, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        int end = qMin(i + BatchChunk, int(applied.size()));
+        for (int n = i; n < end; ++n) encodeUpsert(out, applied[n], ms);
+        if (!append(chunk, end - i, error) && journal.isOpen()) {
+            journal.resize(start);
+            journal.seek(start);
+            records -= i;
+        }
+    }
+
+    // Nothing of a failed batch remains, like the rolled back transaction
+    if (!error.isEmpty()) {
+        for (const Fournisseur& f : applied) removeRow(f.getIdFournisseur());
+        nextId = firstId;
+        return false;
+    }
+    maintain();
+    return true;
+}
+
+int MemoryEngine::update(const Fournisseur& f, QString& error)
+{
+    TRACE_SCOPE("MemoryEngine::update");
+    QWriteLocker locker(&lock);
+    if (!rowOfId.count(f.getIdFournisseur())) return 0;
+
+    error = conflict(f);
+    if (!error.isEmpty()) return -1;
+
+    qint64 ms = stamp();
+    QByteArray record;
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    encodeUpsert(out, f, ms);
+    if (!append(record, 1, error)) return -1;
+
+    applyUpsert(f, ms);
+    maintain();
+    return 1;
+}
+
+int MemoryEngine::remove(int id, QString& error)
+{
+    TRACE_SCOPE("MemoryEngine::remove");
+    QWriteLocker locker(&lock);
+    if (!rowOfId.count(id)) return 0;
+
+    qint64 ms = stamp();
+    QByteArray record;
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    encodeDelete(out, id, ms);
+    if (!append(record, 1, error)) return -1;
+
+    applyDelete(id, ms);
+    maintain();
+    return 1;
+}
+
+bool MemoryEngine::clear(QString& error)
+{
+    QWriteLocker locker(&lock);
+    if (journal.isOpen()) {
+        QByteArray header = journalHeader();
+        if (!journal.resize(0) || !journal.seek(0) ||
+            journal.write(header) != header.size() || !journal.flush()) {
+            error = "remise à zéro du journal impossible: " + journal.errorString();
+            return false;
+        }
+    }
+
+    // Like DROP TABLE: ids start over, the delete history goes too
+    table.clear();
+    modified.clear();
+    rowOfId.clear();
+    contacts.clear();
+    typeCounts.clear();
+    tombstones.clear();
+    records = 0;
+    nextId = 1;
+    return true;
+}
+
+bool MemoryEngine::get(int id, Fournisseur& f) const
+{
+    QReadLocker locker(&lock);
+    auto it = rowOfId.find(id);
+    if (it == rowOfId.end()) return false;
+    f = table.at(it->second);
+    return true;
+}
+
+QList<Fournisseur> MemoryEngine::all() const
+{
+    TRACE_SCOPE("MemoryEngine::all");
+    QReadLocker locker(&lock);
+    QList<Fournisseur> list;
+    list.reserve(table.size());
+
+    // Same cold history handling as rows streamed from SQL
+    ColdTextStore::Builder cold;
+    for (const auto& [id, row] : rowOfId) {
+        Fournisseur f = table.at(row);
+        f.setHistoriqueLivraisons(cold.add(f.getHistoriqueLivraisons()));
+        list.append(f);
+    }
+    cold.finish();
+    return list;
+}
+
+QList<Fournisseur> MemoryEngine::search(const QString& text) const
+{
+    TRACE_SCOPE("MemoryEngine::search");
+    QReadLocker locker(&lock);
+    const QByteArray needle = folded(text);
+
+    // A type label matches or not once, whatever the number of rows using it
+    QVector<bool> typeMatches(ProductTypes::count());
+    for (int code = 1; code < typeMatches.size(); ++code) {
+        typeMatches[code] = containsFolded(folded(ProductTypes::label(code)), needle);
+    }
+
+    QList<Fournisseur> list;
+    for (const auto& [id, row] : rowOfId) {
+        quint32 code = table.typeCodeAt(row);
+        if (containsFolded(table.utf8(row, CompactSupplierTable::Nom), needle) ||
+            containsFolded(table.utf8(row, CompactSupplierTable::Email), needle) ||
+            (int(code) < typeMatches.size() && typeMatches[code])) {
+            list.append(table.at(row));
+        }
+    }
+    return list;
+}
+
+qint64 MemoryEngine::forEach(const std::function<bool(const Fournisseur&)>& visitor) const
+{
+    QReadLocker locker(&lock);
+    qint64 visited = 0;
+    for (const auto& [id, row] : rowOfId) {
+        ++visited;
+        if (!visitor(table.at(row))) break;
+    }
+    return visited;
+}
+
+int MemoryEngine::count() const
+{
+    QReadLocker locker(&lock);
+    return table.size();
+}
+
+QMap<QString, int> MemoryEngine::typeDistribution() const
+{
+    QReadLocker locker(&lock);
+    QMap<QString, int> distribution;
+    for (int code = 0; code < typeCounts.size(); ++code) {
+        if (typeCounts[code] > 0) distribution[ProductTypes::label(code)] += typeCounts[code];
+    }
+    return distribution;
+}
+
+QDateTime MemoryEngine::currentTime() const
+{
+    QReadLocker locker(&lock);
+    return QDateTime::fromMSecsSinceEpoch(qMax(lastStamp, QDateTime::currentMSecsSinceEpoch()),
+                                          QTimeZone::UTC);
+}
+
+void MemoryEngine::changesSince(const QDateTime& since, QList<Fournisseur>& upserts,
+                                QList<int>& deletedIds, QDateTime& serverTime) const
+{
+    TRACE_SCOPE("MemoryEngine::changesSince");
+    QReadLocker locker(&lock);
+    serverTime = QDateTime::fromMSecsSinceEpoch(qMax(lastStamp, QDateTime::currentMSecsSinceEpoch()),
+                                                QTimeZone::UTC);
+    const qint64 from = since.toMSecsSinceEpoch();
+
+    QHash<int, qint64> deleted;
+    for (const auto& tombstone : tombstones) {
+        if (tombstone.second < from) continue;
+        qint64& latest = deleted[tombstone.first];
+        latest = qMax(latest, tombstone.second);
+    }
+
+    // One pass over the timestamp column; only the changed rows are sorted by id
+    QVector<int> changed;
+    for (int row = 0; row < modified.size(); ++row) {
+        if (modified[row] >= from) changed.append(row);
+    }
+    std::sort(changed.begin(), changed.end(), [this](int a, int b) {
+        return table.idAt(a) < table.idAt(b);
+    });
+
+    for (int row : changed) {
+        // Id deleted and re-inserted in the window: the latest event wins
+        auto tomb = deleted.find(table.idAt(row));
+        if (tomb != deleted.end()) {
+            if (tomb.value() > modified[row]) continue;
+            deleted.erase(tomb);
+        }
+        upserts.append(table.at(row));
+    }
+    deletedIds = deleted.keys();
+}
+
+int MemoryEngine::purgeTombstones(const QDateTime& olderThan)
+{
+    // Not journaled: replay brings purged tombstones back until the next snapshot,
+    // which only makes a client receive a delete it already applied
+    QWriteLocker locker(&lock);
+    const qint64 before = olderThan.toMSecsSinceEpoch();
+    auto end = std::remove_if(tombstones.begin(), tombstones.end(),
+                              [before](const QPair<int, qint64>& t) { return t.second < before; });
+    int purged = int(tombstones.end() - end);
+    tombstones.erase(end, tombstones.end());
+    return purged;
+}
+
+qint64 MemoryEngine::journalRecords() const
+{
+    QReadLocker locker(&lock);
+    return records;
+}
+
+qint64 MemoryEngine::memoryUsage() const
+{
+    QReadLocker locker(&lock);
+    return table.memoryUsage() +
+           MemoryAccounting::estimateTreeNodes(qint64(rowOfId.size()), qint64(sizeof(std::pair<const int, int>))) +
+           modified.capacity() * qint64(sizeof(qint64)) +
+           tombstones.capacity() * qint64(sizeof(QPair<int, qint64>)) +
+           typeCounts.capacity() * qint64(sizeof(int));
+}
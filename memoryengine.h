@@ -0,0 +1,110 @@
+#ifndef MEMORYENGINE_H
+#define MEMORYENGINE_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QPair>
+#include <QDateTime>
+#include <QFile>
+#include <QReadWriteLock>
+#include <functional>
+#include <map>
+#include <memory>
+#include "fournisseur.h"
+#include "compactstorage.h"
+#include "contactindex.h"
+
+class QDataStream;
+class QLockFile;
+
+/**
+ * Embedded supplier storage behind DatabaseManager::InMemory
+ *
+ * Rows live in a CompactSupplierTable, found by id through an ordered map;
+ * the ContactIndex enforces the email / phone uniqueness of the SQL unique
+ * indexes and per-type counters answer the distribution in O(types).
+ * Every change is appended to a binary journal before the call returns:
+ * opening replays it, and it is rewritten as a snapshot once it holds more
+ * than twice as many records as there are rows. Managers opened on the
+ * same journal share one engine; a read-write lock serializes writers.
+ */
+class MemoryEngine
+{
+public:
+    // No journal: nothing survives the process
+    static const QString Volatile;      // ":memory:"
+
+    // Shared per journal file (a volatile engine is always new); null on error
+    static std::shared_ptr<MemoryEngine> open(const QString& journalPath, QString& error);
+
+    ~MemoryEngine();
+
+    // Writes: journaled before they return. Update / remove return the rows changed, -1 on error.
+    bool insert(const Fournisseur& f, bool preserveId, QString& error, int* newId = nullptr);
+    bool insertBatch(const QList<Fournisseur>& fournisseurs, bool preserveIds, QString& error);
+    int update(const Fournisseur& f, QString& error);
+    int remove(int id, QString& error);
+    bool clear(QString& error);
+
+    // Reads, in id order like the SQL queries
+    bool get(int id, Fournisseur& f) const;
+    QList<Fournisseur> all() const;
+    QList<Fournisseur> search(const QString& text) const;
+    // The read lock is held while visiting: the visitor must not write to the engine
+    qint64 forEach(const std::function<bool(const Fournisseur&)>& visitor) const;
+
+    int count() const;
+    QMap<QString, int> typeDistribution() const;
+
+    // Delta sync, same >= semantics as DATE_MODIFICATION / DATE_SUPPRESSION
+    QDateTime currentTime() const;
+    void changesSince(const QDateTime& since, QList<Fournisseur>& upserts,
+                      QList<int>& deletedIds, QDateTime& serverTime) const;
+    int purgeTombstones(const QDateTime& olderThan);
+
+    QString journalPath() const { return path; }
+    qint64 journalRecords() const;
+    qint64 memoryUsage() const;
+
+private:
+    enum Op : quint8 { Upsert = 1, Delete = 2 };
+
+    QString path;
+    QFile journal;
+    std::unique_ptr<QLockFile> lockFile;    // one process per journal
+    qint64 records;                         // in the journal, for compaction
+
+    CompactSupplierTable table;
+    QVector<qint64> modified;               // per row, ms since epoch (UTC)
+    std::map<int, int> rowOfId;
+    ContactIndex contacts;
+    QVector<int> typeCounts;                // by ProductTypes code
+    QVector<QPair<int, qint64>> tombstones; // id, deletion ms
+    int nextId;                             // never reused, like AUTOINCREMENT
+    qint64 lastStamp;                       // timestamps never go backwards
+    mutable QReadWriteLock lock;
+
+    explicit MemoryEngine(const QString& journalPath);
+    MemoryEngine(const MemoryEngine&) = delete;
+    MemoryEngine& operator=(const MemoryEngine&) = delete;
+
+    bool openJournal(QString& error);
+    bool replay(QString& error);
+    bool append(const QByteArray& batch, int count, QString& error);
+    bool compactJournal(QString& error);
+    void maintain();                        // journal snapshot, arena rewrite
+    static void encodeUpsert(QDataStream& out, const Fournisseur& f, qint64 ms);
+    static void encodeDelete(QDataStream& out, int id, qint64 ms);
+
+    qint64 stamp();
+    QString conflict(const Fournisseur& f) const;
+    void applyUpsert(const Fournisseur& f, qint64 ms);
+    bool applyDelete(int id, qint64 ms);    // removeRow() plus a tombstone
+    bool removeRow(int id);
+    void countType(quint32 code, int delta);
+};
+
+#endif // MEMORYENGINE_H
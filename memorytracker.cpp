@@ -0,0 +1,418 @@
+#include "memorytracker.h"
+#include "fournisseur.h"
+#include "advancedfeatures.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QJsonArray>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local MemoryScope* activeScope = nullptr;
+thread_local quint32 currentThread = 0;
+std::atomic<quint64> nextScopeId{1};
+std::atomic<quint32> nextThreadId{1};
+
+QMutex& operationsMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QMap<QString, MemoryAccounting::OperationStats>& operationTable()
+{
+    static QMap<QString, MemoryAccounting::OperationStats> table;
+    return table;
+}
+
+void raisePeak(std::atomic<qint64>& peak, qint64 value)
+{
+    qint64 seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+qint64 payload(const QString& s)
+{
+    // QArrayData header + UTF-16 buffer (shared strings are counted per use)
+    return s.isNull() ? 0 : 16 + (s.capacity() + 1) * 2;
+}
+
+QString formatBytes(qint64 bytes)
+{
+    if (bytes >= (qint64(1) << 20)) return QString("%1 Mo").arg(bytes / 1048576.0, 0, 'f', 1);
+    if (bytes >= 1024) return QString("%1 Ko").arg(bytes / 1024.0, 0, 'f', 1);
+    return QString("%1 o").arg(bytes);
+}
+
+} // namespace
+
+std::atomic<qint64> MemoryAccounting::currentBytes[MemoryAccounting::TagCount];
+std::atomic<qint64> MemoryAccounting::peakBytes[MemoryAccounting::TagCount];
+std::atomic<qint64> MemoryAccounting::totalBytes{0};
+std::atomic<qint64> MemoryAccounting::totalPeakBytes{0};
+
+// ===== MemoryAccounting Implementation =====
+QString MemoryAccounting::tagName(Tag tag)
+{
+    switch (tag) {
+        case Suppliers: return "listeFournisseurs";
+        case Activities: return "activityLog";
+        case Ratings: return "supplierRatings";
+        case TableModel: return "tableModel";
+        case JsonDom: return "JSON DOM";
+        case Indexes: return "index";
+        default: return "non étiqueté";
+    }
+}
+
+bool MemoryAccounting::hooksCompiledIn()
+{
+#ifdef FOURNISSEUR_MEMTRACK
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MemoryAccounting::allocated(Tag tag, qint64 bytes)
+{
+    qint64 now = currentBytes[tag].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    raisePeak(peakBytes[tag], now);
+    qint64 total = totalBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    raisePeak(totalPeakBytes, total);
+}
+
+void MemoryAccounting::released(Tag tag, qint64 bytes)
+{
+    currentBytes[tag].fetch_sub(bytes, std::memory_order_relaxed);
+    totalBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void MemoryAccounting::setEstimate(Tag tag, qint64 bytes)
+{
+    qint64 previous = currentBytes[tag].exchange(bytes, std::memory_order_relaxed);
+    raisePeak(peakBytes[tag], bytes);
+    qint64 total = totalBytes.fetch_add(bytes - previous, std::memory_order_relaxed) + bytes - previous;
+    raisePeak(totalPeakBytes, total);
+}
+
+qint64 MemoryAccounting::current(Tag tag)
+{
+    return currentBytes[tag].load(std::memory_order_relaxed);
+}
+
+qint64 MemoryAccounting::peak(Tag tag)
+{
+    return peakBytes[tag].load(std::memory_order_relaxed);
+}
+
+qint64 MemoryAccounting::totalCurrent()
+{
+    return totalBytes.load(std::memory_order_relaxed);
+}
+
+qint64 MemoryAccounting::totalPeak()
+{
+    return totalPeakBytes.load(std::memory_order_relaxed);
+}
+
+void MemoryAccounting::resetPeaks()
+{
+    for (int tag = 0; tag < TagCount; ++tag) {
+        peakBytes[tag].store(currentBytes[tag].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    totalPeakBytes.store(totalBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void MemoryAccounting::recordOperation(const QString& name, qint64 peakBytes, qint64 datasetBytes)
+{
+    QMutexLocker locker(&operationsMutex());
+    OperationStats& stats = operationTable()[name];
+    stats.lastPeakBytes = peakBytes;
+    stats.maxPeakBytes = qMax(stats.maxPeakBytes, peakBytes);
+    stats.lastDatasetBytes = datasetBytes;
+    stats.runs++;
+}
+
+QMap<QString, MemoryAccounting::OperationStats> MemoryAccounting::operations()
+{
+    QMutexLocker locker(&operationsMutex());
+    return operationTable();
+}
+
+qint64 MemoryAccounting::estimate(const QString& s)
+{
+    return qint64(sizeof(QString)) + payload(s);
+}
+
+qint64 MemoryAccounting::estimate(const Fournisseur& f)
+{
+    return qint64(sizeof(Fournisseur)) +
+           payload(f.getNom()) + payload(f.getAdresse()) + payload(f.getEmail()) +
+           payload(f.getTelephone()) +          // typeProduits: a shared ProductTypes code
+           f.getHistoriqueRef().loadedBytes();
+}
+
+qint64 MemoryAccounting::estimate(const QList<Fournisseur>& fournisseurs)
+{
+    qint64 bytes = qint64(fournisseurs.capacity()) * qint64(sizeof(Fournisseur));
+    QSet<const ColdTextStore*> coldStores;
+    for (const Fournisseur& f : fournisseurs) {
+        bytes += estimate(f) - qint64(sizeof(Fournisseur));
+        if (f.getHistoriqueRef().isStored()) coldStores.insert(f.getHistoriqueRef().storage());
+    }
+    // Compressed delivery history, counted once per shared store
+    for (const ColdTextStore *store : coldStores) bytes += store->compressedBytes();
+    return bytes;
+}
+
+qint64 MemoryAccounting::estimate(const QList<SupplierRating>& ratings)
+{
+    qint64 bytes = qint64(ratings.capacity()) * qint64(sizeof(SupplierRating));
+    for (const SupplierRating& rating : ratings) {
+        bytes += payload(rating.getComments());
+    }
+    return bytes;
+}
+
+qint64 MemoryAccounting::estimate(const QList<ActivityLog>& activities)
+{
+    qint64 bytes = qint64(activities.capacity()) * qint64(sizeof(ActivityLog));
+    for (const ActivityLog& log : activities) {
+        bytes += payload(log.getAction()) + payload(log.getDescription()) + payload(log.getUserName());
+    }
+    return bytes;
+}
+
+qint64 MemoryAccounting::estimateTableModel(int rows, int columns, qint64 textBytes)
+{
+    // QStandardItem + its private data and role vector, roughly 112 bytes
+    return qint64(rows) * columns * 112 + textBytes;
+}
+
+qint64 MemoryAccounting::estimateTreeNodes(qint64 nodes, qint64 valueBytes)
+{
+    // Red-black tree node: three pointers and a colour (padded to a pointer) besides the value
+    return nodes * (valueBytes + qint64(4 * sizeof(void*)));
+}
+
+QString MemoryAccounting::report()
+{
+    QString text = QString("%1 %2 %3\n")
+        .arg(QString("Sous-système"), -20).arg(QString("Actuel"), 12).arg(QString("Pic"), 12);
+    text += QString(46, '-') + "\n";
+    for (int tag = Suppliers; tag < TagCount; ++tag) {
+        text += QString("%1 %2 %3\n")
+            .arg(tagName(Tag(tag)), -20)
+            .arg(formatBytes(current(Tag(tag))), 12)
+            .arg(formatBytes(peak(Tag(tag))), 12);
+    }
+    if (hooksCompiledIn()) {
+        text += QString("%1 %2 %3\n")
+            .arg(tagName(Untagged), -20)
+            .arg(formatBytes(current(Untagged)), 12)
+            .arg(formatBytes(peak(Untagged)), 12);
+    }
+    text += QString("%1 %2 %3\n\n")
+        .arg(QString("TOTAL"), -20)
+        .arg(formatBytes(totalCurrent()), 12)
+        .arg(formatBytes(totalPeak()), 12);
+
+    QMap<QString, OperationStats> ops = operations();
+    if (!ops.isEmpty()) {
+        text += QString("%1 %2 %3 %4\n")
+            .arg(QString("Opération"), -20).arg(QString("Pic"), 12)
+            .arg(QString("Données"), 12).arg(QString("Ratio"), 8);
+        text += QString(55, '-') + "\n";
+        for (auto it = ops.constBegin(); it != ops.constEnd(); ++it) {
+            const OperationStats& s = it.value();
+            double ratio = s.lastDatasetBytes > 0 ? double(s.lastPeakBytes) / s.lastDatasetBytes : 0.0;
+            text += QString("%1 %2 %3 %4\n")
+                .arg(it.key(), -20)
+                .arg(formatBytes(s.lastPeakBytes), 12)
+                .arg(formatBytes(s.lastDatasetBytes), 12)
+                .arg(QString("x%1").arg(ratio, 0, 'f', 2), 8);
+        }
+    }
+
+    if (!hooksCompiledIn()) {
+        text += "\n(Estimations — allocations operator new mesurées avec: qmake CONFIG+=memtrack)\n";
+    } else {
+        text += "\n(operator new seulement: texte des QString et tampons QList non comptés)\n";
+    }
+    return text;
+}
+
+QJsonObject MemoryAccounting::toJson()
+{
+    QJsonObject tags;
+    for (int tag = 0; tag < TagCount; ++tag) {
+        QJsonObject entry;
+        entry["currentBytes"] = double(current(Tag(tag)));
+        entry["peakBytes"] = double(peak(Tag(tag)));
+        tags[tagName(Tag(tag))] = entry;
+    }
+
+    QJsonArray ops;
+    QMap<QString, OperationStats> table = operations();
+    for (auto it = table.constBegin(); it != table.constEnd(); ++it) {
+        QJsonObject entry;
+        entry["operation"] = it.key();
+        entry["lastPeakBytes"] = double(it.value().lastPeakBytes);
+        entry["maxPeakBytes"] = double(it.value().maxPeakBytes);
+        entry["datasetBytes"] = double(it.value().lastDatasetBytes);
+        entry["runs"] = it.value().runs;
+        ops.append(entry);
+    }
+
+    QJsonObject json;
+    json["operatorNewHooks"] = hooksCompiledIn();   // a lower bound: malloc'd Qt array data is missed
+    json["totalCurrentBytes"] = double(totalCurrent());
+    json["totalPeakBytes"] = double(totalPeak());
+    json["tags"] = tags;
+    json["operations"] = ops;
+    return json;
+}
+
+// ===== MemoryScope Implementation =====
+MemoryScope::MemoryScope(const char* name, MemoryAccounting::Tag tag, qint64 datasetBytes)
+    : name(name), tag(tag), id(nextScopeId.fetch_add(1, std::memory_order_relaxed)),
+      datasetBytes(datasetBytes), live(0), peak(0), parent(activeScope)
+{
+    activeScope = this;
+}
+
+MemoryScope::~MemoryScope()
+{
+    // Detach first: recording allocates, and that belongs to the parent
+    activeScope = parent;
+    if (MemoryAccounting::hooksCompiledIn()) {
+        MemoryAccounting::recordOperation(QString::fromUtf8(name), peak, datasetBytes);
+    }
+}
+
+MemoryScope* MemoryScope::active()
+{
+    return activeScope;
+}
+
+MemoryAccounting::Tag MemoryScope::activeTag()
+{
+    return activeScope ? activeScope->tag : MemoryAccounting::Untagged;
+}
+
+quint64 MemoryScope::activeId()
+{
+    return activeScope ? activeScope->id : 0;
+}
+
+quint32 MemoryScope::threadId()
+{
+    if (currentThread == 0) currentThread = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return currentThread;
+}
+
+void MemoryScope::releaseOwned(quint64 ownerId, qint64 bytes)
+{
+    // Scopes nest on a thread, so a live scope created no later than the
+    // owner was active when the block was allocated, and so were its parents
+    for (MemoryScope* scope = activeScope; scope; scope = scope->parent) {
+        if (scope->id <= ownerId) {
+            scope->onRelease(bytes);
+            return;
+        }
+    }
+}
+
+void MemoryScope::onAllocate(qint64 bytes)
+{
+    for (MemoryScope* scope = this; scope; scope = scope->parent) {
+        scope->live += bytes;
+        if (scope->live > scope->peak) scope->peak = scope->live;
+    }
+}
+
+void MemoryScope::onRelease(qint64 bytes)
+{
+    for (MemoryScope* scope = this; scope; scope = scope->parent) {
+        scope->live -= bytes;
+    }
+}
+
+// ===== Allocation hooks (diagnostic builds only) =====
+#ifdef FOURNISSEUR_MEMTRACK
+
+namespace {
+
+struct alignas(16) AllocationHeader
+{
+    quint64 size;
+    quint64 scope;      // innermost MemoryScope when allocated, 0 if none
+    quint32 tag;
+    quint32 thread;     // MemoryScope::threadId() of the allocating thread
+};
+
+void* trackedAllocate(std::size_t size)
+{
+    void* raw = std::malloc(size + sizeof(AllocationHeader));
+    if (!raw) return nullptr;
+
+    AllocationHeader* header = static_cast<AllocationHeader*>(raw);
+    header->size = size;
+    header->scope = MemoryScope::activeId();
+    header->tag = MemoryScope::activeTag();
+    header->thread = MemoryScope::threadId();
+    MemoryAccounting::allocated(MemoryAccounting::Tag(header->tag), qint64(size));
+    if (MemoryScope* scope = MemoryScope::active()) scope->onAllocate(qint64(size));
+    return header + 1;
+}
+
+void trackedFree(void* p) noexcept
+{
+    if (!p) return;
+    AllocationHeader* header = static_cast<AllocationHeader*>(p) - 1;
+    MemoryAccounting::released(MemoryAccounting::Tag(header->tag), qint64(header->size));
+    // Only the scopes that counted the block are credited, not whichever is active now
+    if (header->scope != 0 && header->thread == MemoryScope::threadId()) {
+        MemoryScope::releaseOwned(header->scope, qint64(header->size));
+    }
+    std::free(header);
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    void* p = trackedAllocate(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    void* p = trackedAllocate(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return trackedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return trackedAllocate(size);
+}
+
+void operator delete(void* p) noexcept { trackedFree(p); }
+void operator delete[](void* p) noexcept { trackedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { trackedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { trackedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { trackedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { trackedFree(p); }
+
+#endif // FOURNISSEUR_MEMTRACK
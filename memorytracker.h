@@ -0,0 +1,124 @@
+#ifndef MEMORYTRACKER_H
+#define MEMORYTRACKER_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QJsonObject>
+#include <atomic>
+
+class Fournisseur;
+class SupplierRating;
+class ActivityLog;
+
+/**
+ * Per-subsystem memory accounting
+ *
+ * Tagged byte counters with high-water marks. Subsystems either report an
+ * estimate (setEstimate) or, in diagnostic builds (CONFIG+=memtrack,
+ * FOURNISSEUR_MEMTRACK), are fed by the global operator new/delete hooks:
+ * allocations are charged to the tag of the innermost MemoryScope on the
+ * allocating thread.
+ *
+ * The hooks only see operator new: QObjects, model items, std containers
+ * and QHash / QMap nodes. Qt's array data (the text of QString and
+ * QByteArray, QList / QVector buffers, hence most of the supplier list and
+ * of the JSON DOM) comes from malloc / realloc and is not counted, so the
+ * numbers are a lower bound, not exact peaks.
+ */
+class MemoryAccounting
+{
+public:
+    enum Tag {
+        Untagged,
+        Suppliers,      // listeFournisseurs
+        Activities,     // activityLog
+        Ratings,        // supplierRatings
+        TableModel,     // tableModel items
+        JsonDom,        // QJsonDocument / QJsonArray during load and save
+        Indexes,        // search, contact and completion indexes
+        TagCount
+    };
+
+    struct OperationStats {
+        qint64 lastPeakBytes = 0;
+        qint64 maxPeakBytes = 0;
+        qint64 lastDatasetBytes = 0;
+        int runs = 0;
+    };
+
+    static QString tagName(Tag tag);
+    static bool hooksCompiledIn();
+
+    static void allocated(Tag tag, qint64 bytes);
+    static void released(Tag tag, qint64 bytes);
+    static void setEstimate(Tag tag, qint64 bytes);
+
+    static qint64 current(Tag tag);
+    static qint64 peak(Tag tag);
+    static qint64 totalCurrent();
+    static qint64 totalPeak();
+
+    static void recordOperation(const QString& name, qint64 peakBytes, qint64 datasetBytes);
+    static QMap<QString, OperationStats> operations();
+
+    // Approximate footprints (object + heap payload of every QString)
+    static qint64 estimate(const QString& s);
+    static qint64 estimate(const Fournisseur& f);
+    static qint64 estimate(const QList<Fournisseur>& fournisseurs);
+    static qint64 estimate(const QList<SupplierRating>& ratings);
+    static qint64 estimate(const QList<ActivityLog>& activities);
+    static qint64 estimateTableModel(int rows, int columns, qint64 textBytes);
+    // std::map / std::set / QMap nodes holding valueBytes each, payload not included
+    static qint64 estimateTreeNodes(qint64 nodes, qint64 valueBytes);
+
+    static QString report();
+    static QJsonObject toJson();
+    static void resetPeaks();
+
+private:
+    static std::atomic<qint64> currentBytes[TagCount];
+    static std::atomic<qint64> peakBytes[TagCount];
+    static std::atomic<qint64> totalBytes;
+    static std::atomic<qint64> totalPeakBytes;
+};
+
+/**
+ * Measures one operation: allocations made on this thread while the scope
+ * is alive are charged to 'tag', and the net high-water mark above the
+ * starting point is recorded under 'name' (operator new bytes only, see above).
+ */
+class MemoryScope
+{
+public:
+    MemoryScope(const char* name, MemoryAccounting::Tag tag, qint64 datasetBytes = 0);
+    ~MemoryScope();
+
+    qint64 peakBytes() const { return peak; }
+
+    // Called by the allocation hooks. Ids grow with creation order and are
+    // never reused; thread ids tell which thread's scopes counted a block.
+    static MemoryScope* active();
+    static MemoryAccounting::Tag activeTag();
+    static quint64 activeId();
+    static quint32 threadId();
+    // Credits a free to the scopes that counted the block: its owner and
+    // the owner's parents, as far as they are still alive on this thread
+    static void releaseOwned(quint64 ownerId, qint64 bytes);
+    void onAllocate(qint64 bytes);
+    void onRelease(qint64 bytes);
+
+private:
+    const char* name;
+    MemoryAccounting::Tag tag;
+    quint64 id;
+    qint64 datasetBytes;
+    qint64 live;
+    qint64 peak;
+    MemoryScope* parent;
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+};
+
+#endif // MEMORYTRACKER_H
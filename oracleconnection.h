@@ -1,19 +1,22 @@
 #ifndef ORACLECONNECTION_H
 #define ORACLECONNECTION_H
 
-#include <QSqlDatabase>
 #include <QString>
-#include <QSqlQuery>
-#include <QSqlError>
 #include <QList>
+#include <QMap>
 #include "fournisseur.h"
+#include "databasemanager.h"
 
+/**
+ * Oracle-only facade over DatabaseManager
+ *
+ * Same schema as DatabaseManager(Oracle): product types live in
+ * PRODUCT_TYPES and FOURNISSEURS keeps their ID_TYPE_PRODUIT code.
+ */
 class OracleConnection
 {
 private:
-    QSqlDatabase db;
-    bool connected;
-    QString lastError;
+    DatabaseManager manager;
 
 public:
     OracleConnection();
@@ -26,15 +29,15 @@ public:
                         const QString& username = "system",
                         const QString& password = "YourPassword123");
     
-    bool isConnected() const { return connected; }
+    bool isConnected() const { return manager.isConnected(); }
     void disconnect();
-    QString getLastError() const { return lastError; }
+    QString getLastError() const { return manager.getLastError(); }
     
     // Database Operations
     bool createTables();
     bool dropTables();
     
-    // CRUD Operations for Fournisseur
+    // CRUD Operations for Fournisseur (inserts keep the supplier's id)
     bool insertFournisseur(const Fournisseur& f);
     bool updateFournisseur(const Fournisseur& f);
     bool deleteFournisseur(int id);
@@ -59,4 +62,3 @@ public:
 };
 
 #endif // ORACLECONNECTION_H
-
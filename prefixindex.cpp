@@ -0,0 +1,375 @@
+#include "prefixindex.h"
+#include "memorytracker.h"
+#include <QHash>
+#include <QRegularExpression>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+void writeVarint(QByteArray& out, quint32 value)
+{
+    while (value >= 0x80) {
+        out.append(char(value | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+quint32 readVarint(const char*& p)
+{
+    quint32 value = 0;
+    int shift = 0;
+    while (quint8(*p) & 0x80) {
+        value |= quint32(quint8(*p++) & 0x7F) << shift;
+        shift += 7;
+    }
+    return value | (quint32(quint8(*p++)) << shift);
+}
+
+int compareBytes(QByteArrayView a, QByteArrayView b)
+{
+    qsizetype n = qMin(a.size(), b.size());
+    int c = n > 0 ? std::memcmp(a.data(), b.data(), size_t(n)) : 0;
+    if (c != 0) return c;
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+// Orders a stored display against a folded key; ASCII text is folded on the fly
+int compareFolded(QByteArrayView display, const QByteArray& key)
+{
+    for (char c : display) {
+        if (quint8(c) >= 0x80) {
+            return compareBytes(PrefixIndex::foldKey(QString::fromUtf8(display)), key);
+        }
+    }
+    qsizetype n = qMin(display.size(), key.size());
+    for (qsizetype i = 0; i < n; ++i) {
+        quint8 a = quint8(display[i]);
+        if (a >= 'A' && a <= 'Z') a += 'a' - 'A';
+        quint8 b = quint8(key[i]);
+        if (a != b) return a < b ? -1 : 1;
+    }
+    return display.size() < key.size() ? -1 : (display.size() > key.size() ? 1 : 0);
+}
+
+} // namespace
+
+PrefixIndex::PrefixIndex()
+    : liveTerms(0)
+{
+}
+
+void PrefixIndex::clear()
+{
+    text.clear();
+    blockOffset.clear();
+    frequency.clear();
+    blockMax.clear();
+    pending.clear();
+    liveTerms = 0;
+}
+
+QByteArray PrefixIndex::foldKey(const QString& value)
+{
+    QString decomposed = value.simplified().toLower().normalized(QString::NormalizationForm_D);
+    QString folded;
+    folded.reserve(decomposed.size());
+    for (const QChar& c : decomposed) {
+        if (c.category() != QChar::Mark_NonSpacing) folded += c;
+    }
+    return folded.toUtf8();
+}
+
+QString PrefixIndex::cityOf(const QString& adresse)
+{
+    // "123 Avenue de Paris 75001 Paris" -> "Paris"; otherwise last ", " part
+    static const QRegularExpression postalCode("\\b\\d{4,5}\\s+([^,\\d][^,]*)$");
+    QRegularExpressionMatch match = postalCode.match(adresse.trimmed());
+    if (match.hasMatch()) {
+        return match.captured(1).trimmed();
+    }
+    int comma = adresse.lastIndexOf(',');
+    return comma >= 0 ? adresse.mid(comma + 1).trimmed() : QString();
+}
+
+void PrefixIndex::build(const QStringList& values)
+{
+    QHash<QByteArray, Entry> counted;
+    for (const QString& value : values) {
+        QByteArray key = foldKey(value);
+        if (key.isEmpty()) continue;
+        auto it = counted.find(key);
+        if (it == counted.end()) {
+            it = counted.insert(key, Entry{key, value.simplified().toUtf8(), 0});
+        }
+        ++it->frequency;
+    }
+
+    std::vector<Entry> entries;
+    entries.reserve(size_t(counted.size()));
+    for (const Entry& entry : std::as_const(counted)) {
+        entries.push_back(entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return compareBytes(a.key, b.key) < 0;
+    });
+
+    clear();
+    assign(entries);
+}
+
+void PrefixIndex::assign(std::vector<Entry>& entries)
+{
+    // 'entries' is in key order and holds live terms only
+    text.clear();
+    blockOffset.clear();
+    frequency.clear();
+    blockMax.clear();
+    frequency.reserve(entries.size());
+    blockOffset.reserve(entries.size() / BlockTerms + 1);
+    blockMax.reserve(entries.size() / BlockTerms + 1);
+
+    QByteArray previous;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const QByteArray& display = entries[i].display;
+        int shared = 0;
+        if (i % BlockTerms == 0) {
+            // Every block starts with a complete term so it can be decoded alone
+            blockOffset.push_back(quint32(text.size()));
+            blockMax.push_back(0);
+        } else {
+            int limit = int(qMin(previous.size(), display.size()));
+            while (shared < limit && previous[shared] == display[shared]) ++shared;
+        }
+        writeVarint(text, quint32(shared));
+        writeVarint(text, quint32(display.size() - shared));
+        text.append(display.constData() + shared, display.size() - shared);
+        previous = display;
+
+        frequency.push_back(entries[i].frequency);
+        blockMax.back() = qMax(blockMax.back(), entries[i].frequency);
+    }
+
+    text.squeeze();
+    blockOffset.shrink_to_fit();
+    frequency.shrink_to_fit();
+    blockMax.shrink_to_fit();
+    liveTerms = int(entries.size()); // pending is empty here
+}
+
+void PrefixIndex::merge()
+{
+    // QMap iterates in byte order, the order of compareBytes
+    std::vector<Entry> added;
+    added.reserve(size_t(pending.size()));
+    for (const Entry& entry : std::as_const(pending)) {
+        added.push_back(entry);
+    }
+    pending.clear();
+
+    // Both sides are sorted and never share a key (add() finds sorted terms first)
+    std::vector<Entry> entries;
+    entries.reserve(size_t(liveTerms));
+    size_t next = 0;
+    QByteArray block[BlockTerms];
+    for (int b = 0; b < int(blockOffset.size()); ++b) {
+        int count = 0;
+        decodeBlock(b, block, count);
+        for (int j = 0; j < count; ++j) {
+            while (next < added.size() && compareFolded(block[j], added[next].key) > 0) {
+                entries.push_back(added[next++]);
+            }
+            quint32 freq = frequency[size_t(b * BlockTerms + j)];
+            if (freq > 0) entries.push_back(Entry{QByteArray(), block[j], freq});
+        }
+    }
+    while (next < added.size()) {
+        entries.push_back(added[next++]);
+    }
+
+    assign(entries);
+}
+
+QByteArrayView PrefixIndex::blockHead(int block) const
+{
+    const char* p = text.constData() + blockOffset[size_t(block)];
+    readVarint(p); // always 0 shared bytes
+    quint32 length = readVarint(p);
+    return QByteArrayView(p, qsizetype(length));
+}
+
+void PrefixIndex::decodeBlock(int block, QByteArray* out, int& count) const
+{
+    const char* p = text.constData() + blockOffset[size_t(block)];
+    const char* end = text.constData() +
+        (size_t(block + 1) < blockOffset.size() ? blockOffset[size_t(block + 1)] : quint32(text.size()));
+    count = 0;
+    while (p < end) {
+        quint32 shared = readVarint(p);
+        quint32 length = readVarint(p);
+        QByteArray term = count > 0 ? out[count - 1].left(qsizetype(shared)) : QByteArray();
+        term.append(p, qsizetype(length));
+        p += length;
+        out[count++] = term;
+    }
+}
+
+QByteArray PrefixIndex::displayAt(int index) const
+{
+    QByteArray block[BlockTerms];
+    int count = 0;
+    decodeBlock(index / BlockTerms, block, count);
+    return block[index % BlockTerms];
+}
+
+int PrefixIndex::lowerBound(const QByteArray& key) const
+{
+    // First block whose head is not below the key...
+    int lo = 0;
+    int hi = int(blockOffset.size());
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (compareFolded(blockHead(mid), key) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0) return 0;
+
+    // ...so the bound lies after the head of the previous block
+    QByteArray block[BlockTerms];
+    int count = 0;
+    decodeBlock(lo - 1, block, count);
+    int first = (lo - 1) * BlockTerms;
+    for (int i = 1; i < count; ++i) {
+        if (compareFolded(block[i], key) >= 0) return first + i;
+    }
+    return first + count;
+}
+
+int PrefixIndex::find(const QByteArray& key) const
+{
+    int index = lowerBound(key);
+    if (index < sortedCount() && compareFolded(displayAt(index), key) == 0) return index;
+    return -1;
+}
+
+void PrefixIndex::updateBlockMax(int block)
+{
+    size_t first = size_t(block) * BlockTerms;
+    size_t last = qMin(first + BlockTerms, frequency.size());
+    blockMax[size_t(block)] = *std::max_element(frequency.begin() + first, frequency.begin() + last);
+}
+
+void PrefixIndex::add(const QString& value)
+{
+    QByteArray key = foldKey(value);
+    if (key.isEmpty()) return;
+
+    int index = find(key);
+    if (index >= 0) {
+        if (frequency[size_t(index)]++ == 0) ++liveTerms;
+        quint32& max = blockMax[size_t(index / BlockTerms)];
+        max = qMax(max, frequency[size_t(index)]);
+        return;
+    }
+
+    auto it = pending.find(key);
+    if (it == pending.end()) {
+        it = pending.insert(key, Entry{key, value.simplified().toUtf8(), 0});
+    }
+    if (it->frequency++ == 0) ++liveTerms;
+
+    // A merge rewrites the whole pool: only once pending is a fair share of it
+    if (pending.size() > qMax(256, sortedCount() / 8)) {
+        merge();
+    }
+}
+
+void PrefixIndex::remove(const QString& value)
+{
+    QByteArray key = foldKey(value);
+    if (key.isEmpty()) return;
+
+    int index = find(key);
+    if (index >= 0) {
+        // The term stays in the pool until the next merge, at frequency 0
+        if (frequency[size_t(index)] == 0) return;
+        if (--frequency[size_t(index)] == 0) --liveTerms;
+        updateBlockMax(index / BlockTerms);
+        return;
+    }
+
+    auto it = pending.find(key);
+    if (it == pending.end()) return;
+    if (--it->frequency == 0) {
+        --liveTerms;
+        pending.erase(it);
+    }
+}
+
+QStringList PrefixIndex::complete(const QString& prefix, int k) const
+{
+    QStringList results;
+    if (k <= 0) return results;
+
+    // Keys starting with the prefix sort between it and prefix + 0xFF (never in UTF-8)
+    QByteArray key = foldKey(prefix);
+    int begin = 0;
+    int end = sortedCount();
+    if (!key.isEmpty()) {
+        begin = lowerBound(key);
+        end = lowerBound(key + char(0xFF));
+    }
+
+    struct Candidate {
+        quint32 frequency;
+        int index;              // sorted term, or -1
+        const Entry* entry;     // pending term
+    };
+    std::vector<Candidate> best;
+    best.reserve(size_t(k) + 1);
+
+    auto offer = [&](const Candidate& c) {
+        if (c.frequency == 0) return;
+        if (int(best.size()) == k && best.back().frequency >= c.frequency) return;
+        auto at = std::upper_bound(best.begin(), best.end(), c, [](const Candidate& a, const Candidate& b) {
+            return a.frequency > b.frequency;
+        });
+        best.insert(at, c);
+        if (int(best.size()) > k) best.pop_back();
+    };
+
+    for (int i = begin; i < end;) {
+        int block = i / BlockTerms;
+        int blockEnd = qMin(end, (block + 1) * BlockTerms);
+        if (int(best.size()) == k && blockMax[size_t(block)] <= best.back().frequency) {
+            i = blockEnd; // nothing in this block can enter the list
+            continue;
+        }
+        for (; i < blockEnd; ++i) {
+            offer(Candidate{frequency[size_t(i)], i, nullptr});
+        }
+    }
+    // Same range in the pending map: O(prefix + matches), not a scan of every pending term
+    for (auto it = pending.lowerBound(key); it != pending.cend() && it.key().startsWith(key); ++it) {
+        offer(Candidate{it->frequency, -1, &*it});
+    }
+
+    for (const Candidate& c : best) {
+        results << QString::fromUtf8(c.entry ? c.entry->display : displayAt(c.index));
+    }
+    return results;
+}
+
+qint64 PrefixIndex::memoryUsage() const
+{
+    qint64 bytes = text.capacity() +
+        qint64(blockOffset.capacity() + frequency.capacity() + blockMax.capacity()) * qint64(sizeof(quint32));
+    // Map nodes hold a key and an entry; the key shares the entry's bytes
+    bytes += MemoryAccounting::estimateTreeNodes(pending.size(), qint64(sizeof(QByteArray) + sizeof(Entry)));
+    for (const Entry& entry : pending) {
+        bytes += entry.key.capacity() + entry.display.capacity();
+    }
+    return bytes;
+}
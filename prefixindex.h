@@ -0,0 +1,71 @@
+#ifndef PREFIXINDEX_H
+#define PREFIXINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QMap>
+#include <vector>
+
+/**
+ * Prefix autocomplete index
+ *
+ * Distinct values are kept sorted by folded key (lower-case, no accents) as
+ * one front-coded UTF-8 pool: blocks of 16 terms, each term storing only
+ * the bytes it does not share with the previous one. Only the display
+ * spelling is stored; keys are folded again while searching. A prefix is
+ * a contiguous range found by binary search, and its most frequent terms
+ * come from a flat frequency column, skipping blocks whose maximum cannot
+ * make the top k. Values added after build() wait in a small sorted map
+ * until they are merged into the pool; a prefix reads only its own range
+ * of it too.
+ */
+class PrefixIndex
+{
+public:
+    static const int MaxCompletions = 8;
+
+    PrefixIndex();
+
+    void build(const QStringList& values);   // replaces the content, one add() per value
+    void add(const QString& value);          // frequency + 1
+    void remove(const QString& value);       // frequency - 1
+    void clear();
+
+    QStringList complete(const QString& prefix, int k = MaxCompletions) const;
+
+    int termCount() const { return liveTerms; }
+    qint64 memoryUsage() const;
+
+    static QByteArray foldKey(const QString& value);
+    static QString cityOf(const QString& adresse);
+
+private:
+    static const int BlockTerms = 16;
+
+    struct Entry {
+        QByteArray key;
+        QByteArray display;
+        quint32 frequency;
+    };
+
+    QByteArray text;                    // per term: shared length, suffix length, suffix
+    std::vector<quint32> blockOffset;   // first byte of each block in 'text'
+    std::vector<quint32> frequency;     // per sorted term
+    std::vector<quint32> blockMax;      // highest frequency of each block
+    QMap<QByteArray, Entry> pending;    // added since the last merge, sorted by key
+    int liveTerms;
+
+    int sortedCount() const { return int(frequency.size()); }
+    QByteArrayView blockHead(int block) const;
+    void decodeBlock(int block, QByteArray* out, int& count) const;
+    QByteArray displayAt(int index) const;
+    int lowerBound(const QByteArray& key) const;
+    int find(const QByteArray& key) const;
+    void updateBlockMax(int block);
+    void assign(std::vector<Entry>& entries);
+    void merge();
+};
+
+#endif // PREFIXINDEX_H
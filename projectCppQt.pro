@@ -1,9 +1,15 @@
-QT       += core gui printsupport sql
+QT       += core gui printsupport sql concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
+# Hot-path tracing spans: qmake CONFIG+=tracing (compiled out otherwise)
+tracing: DEFINES += FOURNISSEUR_TRACING
+
+# Per-subsystem memory peaks from operator new/delete hooks (Qt array data is malloc'd and not seen): qmake CONFIG+=memtrack
+memtrack: DEFINES += FOURNISSEUR_MEMTRACK
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
@@ -12,16 +18,64 @@ SOURCES += \
     main.cpp \
     mainwindow.cpp \
     fournisseur.cpp \
+    coldtext.cpp \
+    tdigest.cpp \
+    ratinghistory.cpp \
     advancedfeatures.cpp \
     databasemanager.cpp \
-    oracleconnection.cpp
+    memoryengine.cpp \
+    oracleconnection.cpp \
+    livesearch.cpp \
+    fuzzysearch.cpp \
+    duplicatedetector.cpp \
+    contactindex.cpp \
+    prefixindex.cpp \
+    tracing.cpp \
+    querymetrics.cpp \
+    memorytracker.cpp \
+    workload.cpp \
+    deltasync.cpp \
+    jsonreloader.cpp \
+    supplierstore.cpp \
+    jobscheduler.cpp \
+    jobspanel.cpp \
+    reportengine.cpp \
+    exportpipeline.cpp \
+    compactstorage.cpp \
+    deliverystore.cpp \
+    leaderboard.cpp \
+    leaderboardpanel.cpp
 
 HEADERS += \
     mainwindow.h \
     fournisseur.h \
+    coldtext.h \
+    tdigest.h \
+    ratinghistory.h \
     advancedfeatures.h \
     databasemanager.h \
-    oracleconnection.h
+    memoryengine.h \
+    oracleconnection.h \
+    livesearch.h \
+    fuzzysearch.h \
+    duplicatedetector.h \
+    contactindex.h \
+    prefixindex.h \
+    tracing.h \
+    querymetrics.h \
+    memorytracker.h \
+    workload.h \
+    deltasync.h \
+    jsonreloader.h \
+    supplierstore.h \
+    jobscheduler.h \
+    jobspanel.h \
+    reportengine.h \
+    exportpipeline.h \
+    compactstorage.h \
+    deliverystore.h \
+    leaderboard.h \
+    leaderboardpanel.h
 
 FORMS += \
     mainwindow.ui
@@ -0,0 +1,227 @@
+#include "querymetrics.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QtMath>
+#include <cstring>
+
+// ===== LatencyHistogram Implementation =====
+LatencyHistogram::LatencyHistogram()
+    : total(0), sum(0), minValue(0), maxValue(0)
+{
+    std::memset(counts, 0, sizeof(counts));
+}
+
+int LatencyHistogram::bucketOf(quint64 value)
+{
+    if (value < quint64(SubBuckets)) return int(value);
+    int exponent = 63 - qCountLeadingZeroBits(value);
+    int sub = int((value >> (exponent - SubBucketBits)) & (SubBuckets - 1));
+    return (exponent - SubBucketBits + 1) * SubBuckets + sub;
+}
+
+quint64 LatencyHistogram::valueOf(int bucket)
+{
+    // Midpoint of the bucket's value range
+    if (bucket < SubBuckets) return quint64(bucket);
+    int exponent = bucket / SubBuckets + SubBucketBits - 1;
+    int sub = bucket % SubBuckets;
+    int shift = exponent - SubBucketBits;
+    quint64 lower = quint64(SubBuckets + sub) << shift;
+    return lower + ((quint64(1) << shift) >> 1);
+}
+
+void LatencyHistogram::record(quint64 valueNs)
+{
+    counts[bucketOf(valueNs)]++;
+    if (total == 0 || valueNs < minValue) minValue = valueNs;
+    if (valueNs > maxValue) maxValue = valueNs;
+    total++;
+    sum += valueNs;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    if (other.total == 0) return;
+    for (int i = 0; i < BucketCount; ++i) counts[i] += other.counts[i];
+    if (total == 0 || other.minValue < minValue) minValue = other.minValue;
+    if (other.maxValue > maxValue) maxValue = other.maxValue;
+    total += other.total;
+    sum += other.sum;
+}
+
+quint64 LatencyHistogram::percentile(double p) const
+{
+    if (total == 0) return 0;
+    quint64 target = quint64(qCeil(p / 100.0 * total));
+    if (target == 0) target = 1;
+
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= target) return qBound(minValue, valueOf(i), maxValue);
+    }
+    return maxValue;
+}
+
+// ===== QueryMetrics Implementation =====
+QueryMetrics::QueryMetrics()
+    : slowThresholdMs(100.0), slowLogPath("logs/slow_queries.log"),
+      slowLogMaxBytes(1 << 20), slowLogKeep(5)
+{
+}
+
+void QueryMetrics::setSlowLogFile(const QString& path, qint64 maxBytes, int keepFiles)
+{
+    QMutexLocker locker(&mutex);
+    slowLogPath = path;
+    slowLogMaxBytes = maxBytes;
+    slowLogKeep = keepFiles;
+}
+
+QString QueryMetrics::getSlowLogFile() const
+{
+    QMutexLocker locker(&mutex);
+    return slowLogPath;
+}
+
+void QueryMetrics::record(const QString& label, quint64 elapsedNs, qint64 rows, bool ok)
+{
+    QMutexLocker locker(&mutex);
+    StatementStats& stats = statements[label];
+    stats.latency.record(elapsedNs);
+    stats.executions++;
+    if (rows > 0) stats.rows += quint64(rows);
+    if (!ok) stats.errors++;
+    if (isSlow(elapsedNs)) stats.slowCount++;
+}
+
+void QueryMetrics::rotateSlowLog()
+{
+    // slow_queries.log -> .1 -> .2 ... ; the oldest file is dropped
+    QFileInfo info(slowLogPath);
+    if (!info.exists() || info.size() < slowLogMaxBytes) return;
+
+    QFile::remove(QString("%1.%2").arg(slowLogPath).arg(slowLogKeep));
+    for (int i = slowLogKeep - 1; i >= 1; --i) {
+        QFile::rename(QString("%1.%2").arg(slowLogPath).arg(i),
+                      QString("%1.%2").arg(slowLogPath).arg(i + 1));
+    }
+    QFile::rename(slowLogPath, slowLogPath + ".1");
+}
+
+void QueryMetrics::logSlowQuery(const QString& label, double elapsedMs, const QString& sql,
+                                const QVariantList& params, const QStringList& plan)
+{
+    QMutexLocker locker(&mutex);
+    QDir().mkpath(QFileInfo(slowLogPath).absolutePath());
+    rotateSlowLog();
+
+    QFile file(slowLogPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        return;
+    }
+
+    QStringList values;
+    for (const QVariant& value : params) {
+        values << (value.isNull() ? QString("NULL") : value.toString().left(80));
+    }
+
+    QTextStream out(&file);
+    out << "[" << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz") << "] "
+        << QString::number(elapsedMs, 'f', 2) << " ms  " << label << "\n";
+    out << "  SQL: " << sql.simplified() << "\n";
+    out << "  Params: [" << values.join(", ") << "]\n";
+    out << "  Plan:\n";
+    for (const QString& line : plan) {
+        out << "    " << line << "\n";
+    }
+    out << "\n";
+    file.close();
+}
+
+QMap<QString, QueryMetrics::StatementStats> QueryMetrics::snapshot() const
+{
+    QMutexLocker locker(&mutex);
+    return statements;
+}
+
+void QueryMetrics::reset()
+{
+    QMutexLocker locker(&mutex);
+    statements.clear();
+}
+
+QString QueryMetrics::summary() const
+{
+    QMap<QString, StatementStats> stats = snapshot();
+
+    QString text = QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+        .arg(QString("Requête"), -28).arg(QString("Exec"), 8)
+        .arg(QString("p50 ms"), 9).arg(QString("p90 ms"), 9)
+        .arg(QString("p99 ms"), 9).arg(QString("max ms"), 9)
+        .arg(QString("Lignes"), 10).arg(QString("Err/Lent"), 9);
+    text += QString(94, '-') + "\n";
+
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        const StatementStats& s = it.value();
+        text += QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+            .arg(it.key(), -28)
+            .arg(s.executions, 8)
+            .arg(s.latency.percentile(50) / 1e6, 9, 'f', 3)
+            .arg(s.latency.percentile(90) / 1e6, 9, 'f', 3)
+            .arg(s.latency.percentile(99) / 1e6, 9, 'f', 3)
+            .arg(s.latency.max() / 1e6, 9, 'f', 3)
+            .arg(s.rows, 10)
+            .arg(QString("%1/%2").arg(s.errors).arg(s.slowCount), 9);
+    }
+
+    text += QString("\nSeuil requêtes lentes: %1 ms — journal: %2\n")
+        .arg(getSlowThresholdMs()).arg(getSlowLogFile());
+    return text;
+}
+
+QJsonObject QueryMetrics::toJson() const
+{
+    QMap<QString, StatementStats> stats = snapshot();
+
+    QJsonArray array;
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        const StatementStats& s = it.value();
+        QJsonObject entry;
+        entry["statement"] = it.key();
+        entry["executions"] = double(s.executions);
+        entry["rows"] = double(s.rows);
+        entry["errors"] = double(s.errors);
+        entry["slow"] = double(s.slowCount);
+        entry["meanNs"] = s.latency.mean();
+        entry["minNs"] = double(s.latency.min());
+        entry["p50Ns"] = double(s.latency.percentile(50));
+        entry["p90Ns"] = double(s.latency.percentile(90));
+        entry["p99Ns"] = double(s.latency.percentile(99));
+        entry["maxNs"] = double(s.latency.max());
+        array.append(entry);
+    }
+
+    QJsonObject json;
+    json["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    json["slowThresholdMs"] = getSlowThresholdMs();
+    json["statements"] = array;
+    return json;
+}
+
+bool QueryMetrics::dumpToFile(const QString& fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson());
+    file.close();
+    return true;
+}
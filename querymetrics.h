@@ -0,0 +1,90 @@
+#ifndef QUERYMETRICS_H
+#define QUERYMETRICS_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QMap>
+#include <QMutex>
+#include <QJsonObject>
+#include <atomic>
+
+// Log-linear latency histogram (HDR-style, ~6% relative precision)
+class LatencyHistogram
+{
+public:
+    static const int SubBucketBits = 4;
+    static const int SubBuckets = 1 << SubBucketBits;
+    static const int BucketCount = (64 - SubBucketBits + 1) * SubBuckets;
+
+    LatencyHistogram();
+
+    void record(quint64 valueNs);
+    void merge(const LatencyHistogram& other);
+
+    quint64 count() const { return total; }
+    quint64 min() const { return total ? minValue : 0; }
+    quint64 max() const { return maxValue; }
+    double mean() const { return total ? double(sum) / total : 0.0; }
+    quint64 percentile(double p) const;
+
+private:
+    quint64 counts[BucketCount];
+    quint64 total;
+    quint64 sum;
+    quint64 minValue;
+    quint64 maxValue;
+
+    static int bucketOf(quint64 value);
+    static quint64 valueOf(int bucket);
+};
+
+/**
+ * Per-statement query metrics and slow-query log
+ * Latency histogram, row and error counters per statement label; any
+ * statement above the threshold is appended (with its bound parameters and
+ * execution plan) to a size-rotated log file.
+ */
+class QueryMetrics
+{
+public:
+    struct StatementStats {
+        LatencyHistogram latency;
+        quint64 executions = 0;
+        quint64 rows = 0;
+        quint64 errors = 0;
+        quint64 slowCount = 0;
+    };
+
+    QueryMetrics();
+
+    void record(const QString& label, quint64 elapsedNs, qint64 rows, bool ok);
+    void logSlowQuery(const QString& label, double elapsedMs, const QString& sql,
+                      const QVariantList& params, const QStringList& plan);
+
+    // The threshold is read on every statement, from any thread: atomic, not locked
+    bool isSlow(quint64 elapsedNs) const { return elapsedNs >= quint64(getSlowThresholdMs() * 1e6); }
+    void setSlowThresholdMs(double ms) { slowThresholdMs.store(ms, std::memory_order_relaxed); }
+    double getSlowThresholdMs() const { return slowThresholdMs.load(std::memory_order_relaxed); }
+    void setSlowLogFile(const QString& path, qint64 maxBytes = 1 << 20, int keepFiles = 5);
+    QString getSlowLogFile() const;
+
+    QMap<QString, StatementStats> snapshot() const;
+    void reset();
+
+    QString summary() const;
+    QJsonObject toJson() const;
+    bool dumpToFile(const QString& fileName) const;
+
+private:
+    mutable QMutex mutex;
+    QMap<QString, StatementStats> statements;
+    std::atomic<double> slowThresholdMs;
+    QString slowLogPath;
+    qint64 slowLogMaxBytes;
+    int slowLogKeep;
+
+    void rotateSlowLog();
+};
+
+#endif // QUERYMETRICS_H
@@ -0,0 +1,221 @@
+#include "ratinghistory.h"
+#include "advancedfeatures.h"
+#include "tracing.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double WindowDays[2] = { 30.0, 90.0 };
+const double SecondsPerDay = 86400.0;
+
+bool validScore(int score)
+{
+    return score >= 1 && score <= 5;
+}
+}
+
+// ===== RatingEvent Implementation =====
+RatingEvent RatingEvent::fromRating(const SupplierRating& rating)
+{
+    RatingEvent event;
+    event.fournisseurId = rating.getFournisseurId();
+    event.ratedDate = rating.getRatedDate();
+    event.qualityScore = rating.getQualityScore();
+    event.deliveryScore = rating.getDeliveryScore();
+    event.priceScore = rating.getPriceScore();
+    event.communicationScore = rating.getCommunicationScore();
+    event.comments = rating.getComments();
+    return event;
+}
+
+QJsonObject RatingEvent::toJson() const
+{
+    QJsonObject json;
+    json["fournisseurId"] = fournisseurId;
+    json["ratedDate"] = ratedDate.toString(Qt::ISODate);
+    json["qualityScore"] = qualityScore;
+    json["deliveryScore"] = deliveryScore;
+    json["priceScore"] = priceScore;
+    json["communicationScore"] = communicationScore;
+    if (!comments.isEmpty()) json["comments"] = comments;
+    return json;
+}
+
+RatingEvent RatingEvent::fromJson(const QJsonObject& json)
+{
+    RatingEvent event;
+    event.fournisseurId = json["fournisseurId"].toInt();
+    event.ratedDate = QDateTime::fromString(json["ratedDate"].toString(), Qt::ISODate);
+    event.qualityScore = json["qualityScore"].toInt();
+    event.deliveryScore = json["deliveryScore"].toInt();
+    event.priceScore = json["priceScore"].toInt();
+    event.communicationScore = json["communicationScore"].toInt();
+    event.comments = json["comments"].toString();
+    return event;
+}
+
+// ===== RatingHistory Implementation =====
+RatingHistory::RatingHistory()
+    : totalEvents(0)
+{
+}
+
+bool RatingHistory::append(const RatingEvent& event)
+{
+    if (!event.ratedDate.isValid()) {
+        lastError = "date de notation invalide";
+        return false;
+    }
+    if (!validScore(event.qualityScore) || !validScore(event.deliveryScore) ||
+        !validScore(event.priceScore) || !validScore(event.communicationScore)) {
+        lastError = QString("note hors de 1-5 pour le fournisseur %1").arg(event.fournisseurId);
+        return false;
+    }
+
+    Series& s = series[event.fournisseurId];
+    double overall = event.overall();
+    qint64 when = event.ratedDate.toSecsSinceEpoch();
+
+    // A newer rating moves the anchor: older weights shrink by the elapsed time.
+    // An older one simply enters with its weight relative to the anchor.
+    for (int w = 0; w < 2; ++w) {
+        if (s.events.isEmpty() || when >= s.anchor) {
+            double decay = s.events.isEmpty()
+                ? 0.0 : std::exp(-(when - s.anchor) / (WindowDays[w] * SecondsPerDay));
+            s.decayedSum[w] = s.decayedSum[w] * decay + overall;
+            s.decayedWeight[w] = s.decayedWeight[w] * decay + 1.0;
+        } else {
+            double weight = std::exp(-(s.anchor - when) / (WindowDays[w] * SecondsPerDay));
+            s.decayedSum[w] += weight * overall;
+            s.decayedWeight[w] += weight;
+        }
+    }
+    if (s.events.isEmpty() || when >= s.anchor) {
+        s.anchor = when;
+        s.scores.lastRated = event.ratedDate;
+        s.events.append(event);
+    } else {
+        auto position = std::upper_bound(s.events.begin(), s.events.end(), event,
+            [](const RatingEvent& a, const RatingEvent& b) { return a.ratedDate < b.ratedDate; });
+        s.events.insert(position, event);
+    }
+    s.sum += overall;
+
+    s.scores.count = s.events.size();
+    s.scores.allTime = s.sum / s.scores.count;
+    s.scores.decayed30 = s.decayedSum[0] / s.decayedWeight[0];
+    s.scores.decayed90 = s.decayedSum[1] / s.decayedWeight[1];
+    totalEvents++;
+    return true;
+}
+
+int RatingHistory::appendAll(const QList<RatingEvent>& events)
+{
+    TRACE_SCOPE("RatingHistory::appendAll");
+    int stored = 0;
+    for (const RatingEvent& event : events) {
+        if (append(event)) stored++;
+    }
+    return stored;
+}
+
+const RatingScores& RatingHistory::scores(int fournisseurId) const
+{
+    static const RatingScores none;
+    auto it = series.constFind(fournisseurId);
+    return it != series.constEnd() ? it->scores : none;
+}
+
+double RatingHistory::score(int fournisseurId, Window window) const
+{
+    const RatingScores& s = scores(fournisseurId);
+    switch (window) {
+        case Decayed30: return s.decayed30;
+        case Decayed90: return s.decayed90;
+        default: return s.allTime;
+    }
+}
+
+QVector<RatingEvent> RatingHistory::events(int fournisseurId) const
+{
+    return series.value(fournisseurId).events;
+}
+
+qint64 RatingHistory::memoryUsage() const
+{
+    qint64 bytes = qint64(series.capacity()) * qint64(sizeof(Series) + sizeof(int) + sizeof(void*));
+    for (const Series& s : series) {
+        bytes += s.events.capacity() * qint64(sizeof(RatingEvent));
+        for (const RatingEvent& event : s.events) {
+            bytes += event.comments.capacity() * qint64(sizeof(QChar));
+        }
+    }
+    return bytes;
+}
+
+void RatingHistory::clear()
+{
+    series.clear();
+    totalEvents = 0;
+}
+
+QString RatingHistory::windowName(Window window)
+{
+    switch (window) {
+        case Decayed30: return "30 jours";
+        case Decayed90: return "90 jours";
+        default: return "globale";
+    }
+}
+
+bool RatingHistory::saveToFile(const QString& fileName) const
+{
+    TRACE_SCOPE("RatingHistory::saveToFile");
+    QJsonArray array;
+    for (const Series& s : series) {
+        for (const RatingEvent& event : s.events) array.append(event.toJson());
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        lastError = "écriture impossible: " + fileName;
+        return false;
+    }
+    if (file.write(QJsonDocument(array).toJson(QJsonDocument::Compact)) < 0) {
+        lastError = "erreur d'écriture: " + fileName;
+        return false;
+    }
+    return true;
+}
+
+bool RatingHistory::loadFromFile(const QString& fileName)
+{
+    TRACE_SCOPE("RatingHistory::loadFromFile");
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        lastError = "lecture impossible: " + fileName;
+        return false;
+    }
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isArray()) {
+        lastError = "format de fichier inconnu: " + fileName;
+        return false;
+    }
+
+    // Oldest first, so nearly every append moves the anchor forward
+    QList<RatingEvent> events;
+    events.reserve(doc.array().size());
+    for (const QJsonValue& value : doc.array()) {
+        if (value.isObject()) events.append(RatingEvent::fromJson(value.toObject()));
+    }
+    std::stable_sort(events.begin(), events.end(), [](const RatingEvent& a, const RatingEvent& b) {
+        return a.ratedDate < b.ratedDate;
+    });
+
+    clear();
+    appendAll(events);
+    return true;
+}
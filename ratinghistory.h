@@ -0,0 +1,90 @@
+#ifndef RATINGHISTORY_H
+#define RATINGHISTORY_H
+
+#include <QString>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QJsonObject>
+
+// One rating given to a supplier, kept even after it is rated again
+struct RatingEvent
+{
+    int fournisseurId = 0;
+    QDateTime ratedDate;
+    int qualityScore = 0;       // 1-5 stars, as in SupplierRating
+    int deliveryScore = 0;
+    int priceScore = 0;
+    int communicationScore = 0;
+    QString comments;
+
+    double overall() const { return (qualityScore + deliveryScore + priceScore + communicationScore) / 4.0; }
+    static RatingEvent fromRating(const class SupplierRating& rating);
+    QJsonObject toJson() const;
+    static RatingEvent fromJson(const QJsonObject& json);
+};
+
+// Scores of one supplier, maintained at each append
+struct RatingScores
+{
+    int count = 0;
+    double allTime = 0.0;       // plain mean of the overall ratings
+    double decayed30 = 0.0;     // exponentially weighted, 30-day time constant
+    double decayed90 = 0.0;     // same, 90 days
+    QDateTime lastRated;
+};
+
+/**
+ * Every rating of every supplier, with running aggregates
+ *
+ * Each supplier keeps a plain sum and, per window, a decayed sum and a
+ * decayed weight anchored at its latest rating: a rating 'age' days older
+ * than the latest weighs exp(-age / window). Their ratio does not change
+ * as time passes, so all scores are computed once at append and read in
+ * O(1); ranking never recomputes a score inside a comparator.
+ */
+class RatingHistory
+{
+public:
+    enum Window { AllTime, Decayed30, Decayed90 };
+
+    RatingHistory();
+
+    // Events may arrive in any order; false (see getLastError) if one is invalid
+    bool append(const RatingEvent& event);
+    int appendAll(const QList<RatingEvent>& events);
+
+    const RatingScores& scores(int fournisseurId) const;   // all zero if never rated
+    double score(int fournisseurId, Window window) const;
+    QVector<RatingEvent> events(int fournisseurId) const;  // oldest first
+
+    bool contains(int fournisseurId) const { return series.contains(fournisseurId); }
+    QList<int> suppliers() const { return series.keys(); }
+    int supplierCount() const { return series.size(); }
+    qint64 eventCount() const { return totalEvents; }
+    qint64 memoryUsage() const;
+    void clear();
+
+    bool saveToFile(const QString& fileName) const;
+    bool loadFromFile(const QString& fileName);
+    QString getLastError() const { return lastError; }
+
+    static QString windowName(Window window);
+
+private:
+    struct Series {
+        QVector<RatingEvent> events;
+        double sum = 0.0;
+        double decayedSum[2] = { 0.0, 0.0 };       // 30 and 90 days
+        double decayedWeight[2] = { 0.0, 0.0 };
+        qint64 anchor = 0;                          // seconds since epoch of the latest rating
+        RatingScores scores;
+    };
+
+    QHash<int, Series> series;
+    qint64 totalEvents;
+    mutable QString lastError;
+};
+
+#endif // RATINGHISTORY_H
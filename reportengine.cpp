@@ -0,0 +1,262 @@
+#include "reportengine.h"
+#include "jobscheduler.h"
+#include "tracing.h"
+#include <QPainter>
+#include <QPicture>
+#include <QPrinter>
+#include <QFontMetricsF>
+#include <QThread>
+#include <QFile>
+#include <cmath>
+
+// ===== SupplierReport Implementation =====
+SupplierReport::SupplierReport(SupplierSnapshotPtr snapshot)
+    : snapshot(std::move(snapshot)), title("Liste des Fournisseurs"),
+      columns(defaultColumns()), batchPages(0), pages(0), streamPage(0)
+{
+}
+
+SupplierReport::~SupplierReport()
+{
+    if (streamPainter && streamPainter->isActive()) abort();
+}
+
+QVector<SupplierReport::Column> SupplierReport::defaultColumns()
+{
+    return {
+        { "ID", 0.7, [](const Fournisseur& f) { return QString::number(f.getIdFournisseur()); } },
+        { "Nom", 2.2, [](const Fournisseur& f) { return f.getNom(); } },
+        { "Email", 2.6, [](const Fournisseur& f) { return f.getEmail(); } },
+        { "Téléphone", 1.5, [](const Fournisseur& f) { return f.getTelephone(); } },
+        { "Type Produits", 2.0, [](const Fournisseur& f) { return f.getTypeProduits(); } },
+    };
+}
+
+bool SupplierReport::openPrinter(const QString& fileName, QPrinter& printer, QPainter& painter, Layout& layout)
+{
+    printer.setOutputFormat(QPrinter::PdfFormat);
+    printer.setOutputFileName(fileName);
+    printer.setPageOrientation(QPageLayout::Landscape);
+
+    if (!painter.begin(&printer)) {
+        lastError = "impossible d'ouvrir le fichier";
+        return false;
+    }
+
+    // Pictures are recorded at the default DPI and scaled to the printer's when
+    // replayed, so the layout is done in picture units, not printer pixels
+    QPicture probe;
+    QSizeF pageSize(printer.width() * qreal(probe.logicalDpiX()) / printer.logicalDpiX(),
+                    printer.height() * qreal(probe.logicalDpiY()) / printer.logicalDpiY());
+    layout = computeLayout(pageSize);
+    if (layout.firstPageRows < 1 || layout.rowsPerPage < 1) {
+        painter.end();
+        lastError = "page trop petite pour la mise en page";
+        return false;
+    }
+    return true;
+}
+
+bool SupplierReport::render(const QString& fileName, JobContext& job)
+{
+    TRACE_SCOPE("SupplierReport::render");
+    QPrinter printer(QPrinter::HighResolution);
+    QPainter painter;
+    Layout layout;
+    if (!openPrinter(fileName, printer, painter, layout)) {
+        job.fail(lastError);
+        return false;
+    }
+
+    int rows = snapshot->size();
+    pages = rows <= layout.firstPageRows
+            ? 1 : 1 + (rows - layout.firstPageRows + layout.rowsPerPage - 1) / layout.rowsPerPage;
+
+    // Only one batch of pages is alive at a time: memory does not grow with the row count
+    int batch = batchPages > 0 ? batchPages : 2 * qMax(1, QThread::idealThreadCount());
+    QVector<QPicture> buffer(batch);
+
+    for (int first = 0; first < pages && !job.isCancelled(); first += batch) {
+        int count = qMin(batch, pages - first);
+        job.parallelFor(count, [&](int k) {
+            TRACE_SCOPE("SupplierReport::paintPage");
+            int page = first + k;
+            int firstRow = firstRowOf(layout, page);
+            int lastRow = qMin(rows, firstRow + rowsOn(layout, page));
+            QVector<Fournisseur> pageContent;
+            pageContent.reserve(lastRow - firstRow);
+            for (int row = firstRow; row < lastRow; ++row) pageContent.append(snapshot->at(row));
+
+            buffer[k] = QPicture();
+            QPainter pagePainter(&buffer[k]);
+            paintPage(pagePainter, layout, page, pageContent);
+            pagePainter.end();
+        });
+
+        // Stitched in page order into the single printer stream
+        for (int k = 0; k < count && !job.isCancelled(); ++k) {
+            if (first + k > 0) printer.newPage();
+            painter.drawPicture(0, 0, buffer[k]);
+            buffer[k] = QPicture();
+        }
+        job.setProgress(first + count, pages);
+        job.setStatus(QString("page %1 / %2").arg(first + count).arg(pages));
+    }
+
+    bool ok = painter.end();
+    if (job.isCancelled()) {
+        QFile::remove(fileName);
+        return false;
+    }
+    if (!ok) {
+        lastError = "échec de l'écriture du PDF";
+        job.fail(lastError);
+    }
+    return ok;
+}
+
+bool SupplierReport::begin(const QString& fileName)
+{
+    streamFile = fileName;
+    streamPrinter = std::make_unique<QPrinter>(QPrinter::HighResolution);
+    streamPainter = std::make_unique<QPainter>();
+    pages = 0;
+    streamPage = 0;
+    pageRows.clear();
+    if (!openPrinter(fileName, *streamPrinter, *streamPainter, streamLayout)) {
+        streamPainter.reset();
+        streamPrinter.reset();
+        return false;
+    }
+    pageRows.reserve(streamLayout.firstPageRows);
+    return true;
+}
+
+void SupplierReport::addRow(const Fournisseur& f)
+{
+    pageRows.append(f);
+    if (pageRows.size() >= rowsOn(streamLayout, streamPage)) flushStreamPage();
+}
+
+bool SupplierReport::finish()
+{
+    if (!streamPainter) return false;
+    if (!pageRows.isEmpty() || streamPage == 0) flushStreamPage();
+    bool ok = streamPainter->end();
+    streamPainter.reset();
+    streamPrinter.reset();
+    if (!ok) lastError = "échec de l'écriture du PDF";
+    return ok;
+}
+
+void SupplierReport::abort()
+{
+    if (streamPainter) streamPainter->end();
+    streamPainter.reset();
+    streamPrinter.reset();
+    QFile::remove(streamFile);
+}
+
+void SupplierReport::flushStreamPage()
+{
+    // Same picture path as render(), so both modes produce identical pages
+    QPicture picture;
+    QPainter pagePainter(&picture);
+    paintPage(pagePainter, streamLayout, streamPage, pageRows);
+    pagePainter.end();
+
+    if (streamPage > 0) streamPrinter->newPage();
+    streamPainter->drawPicture(0, 0, picture);
+    streamPage++;
+    pageRows.clear();
+}
+
+SupplierReport::Layout SupplierReport::computeLayout(const QSizeF& pageSize) const
+{
+    Layout layout;
+    qreal margin = pageSize.width() * 0.04;
+    layout.page = QRectF(margin, margin, pageSize.width() - 2 * margin, pageSize.height() - 2 * margin);
+
+    layout.titleFont.setPointSizeF(16);
+    layout.titleFont.setBold(true);
+    layout.headerFont.setPointSizeF(9);
+    layout.headerFont.setBold(true);
+    layout.bodyFont.setPointSizeF(9);
+
+    // Measured once here; pages only reuse the resulting geometry
+    QPicture probe;
+    QFontMetricsF titleMetrics(layout.titleFont, &probe);
+    QFontMetricsF bodyMetrics(layout.bodyFont, &probe);
+    layout.titleHeight = titleMetrics.height() * 2;
+    layout.rowHeight = std::ceil(bodyMetrics.height() * 1.5);
+    layout.baseline = (layout.rowHeight - bodyMetrics.height()) / 2 + bodyMetrics.ascent();
+    layout.footerHeight = bodyMetrics.height() * 2;
+
+    qreal totalWeight = 0;
+    for (const Column& column : columns) totalWeight += column.weight;
+    qreal x = layout.page.left();
+    for (const Column& column : columns) {
+        qreal width = totalWeight > 0 ? layout.page.width() * column.weight / totalWeight : 0;
+        layout.columnX.append(x);
+        layout.columnWidth.append(width);
+        x += width;
+    }
+
+    // Header row on every page, title on the first one, footer at the bottom
+    qreal body = layout.page.height() - layout.rowHeight - layout.footerHeight;
+    layout.rowsPerPage = int(body / layout.rowHeight);
+    layout.firstPageRows = int((body - layout.titleHeight) / layout.rowHeight);
+    return layout;
+}
+
+int SupplierReport::firstRowOf(const Layout& layout, int page) const
+{
+    return page == 0 ? 0 : layout.firstPageRows + (page - 1) * layout.rowsPerPage;
+}
+
+int SupplierReport::rowsOn(const Layout& layout, int page) const
+{
+    return page == 0 ? layout.firstPageRows : layout.rowsPerPage;
+}
+
+void SupplierReport::paintPage(QPainter& painter, const Layout& layout, int page,
+                               const QVector<Fournisseur>& rows) const
+{
+    // Metrics for eliding, one per page and per thread (font caches are per thread)
+    QFontMetricsF headerMetrics(layout.headerFont, painter.device());
+    QFontMetricsF bodyMetrics(layout.bodyFont, painter.device());
+    const qreal padding = bodyMetrics.averageCharWidth() / 2;
+
+    qreal y = layout.page.top();
+    if (page == 0) {
+        painter.setFont(layout.titleFont);
+        painter.drawText(QPointF(layout.page.left(), y + QFontMetricsF(layout.titleFont, painter.device()).ascent()),
+                         title);
+        y += layout.titleHeight;
+    }
+
+    painter.setFont(layout.headerFont);
+    for (int c = 0; c < columns.size(); ++c) {
+        painter.drawText(QPointF(layout.columnX[c] + padding, y + layout.baseline),
+                         headerMetrics.elidedText(columns[c].title, Qt::ElideRight,
+                                                  layout.columnWidth[c] - 2 * padding));
+    }
+    y += layout.rowHeight;
+    painter.drawLine(QPointF(layout.page.left(), y), QPointF(layout.page.right(), y));
+
+    painter.setFont(layout.bodyFont);
+    for (const Fournisseur& f : rows) {
+        for (int c = 0; c < columns.size(); ++c) {
+            painter.drawText(QPointF(layout.columnX[c] + padding, y + layout.baseline),
+                             bodyMetrics.elidedText(columns[c].text(f), Qt::ElideRight,
+                                                    layout.columnWidth[c] - 2 * padding));
+        }
+        y += layout.rowHeight;
+    }
+
+    QString footer = pages > 0 ? QString("Page %1 / %2").arg(page + 1).arg(pages)
+                               : QString("Page %1").arg(page + 1);
+    painter.drawText(QPointF(layout.page.right() - bodyMetrics.horizontalAdvance(footer),
+                             layout.page.bottom() - bodyMetrics.descent()),
+                     footer);
+}
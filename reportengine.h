@@ -0,0 +1,119 @@
+#ifndef REPORTENGINE_H
+#define REPORTENGINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QFont>
+#include <QRectF>
+#include <functional>
+#include <memory>
+#include "supplierstore.h"
+#include "exportpipeline.h"
+
+class QPainter;
+class QPrinter;
+class JobContext;
+
+/**
+ * Paginated supplier list report (PDF)
+ *
+ * The layout is computed once per run: font metrics, column widths, row
+ * height and therefore rows per page, so any page can be drawn knowing
+ * only its number. Pages are drawn in parallel into QPicture buffers,
+ * a few at a time, and replayed in order into the printer, so memory
+ * stays flat whatever the supplier count. Cells are elided to their
+ * column width; a header row is repeated on every page.
+ *
+ * Without a snapshot the report can also be fed row by row (begin, addRow,
+ * finish) from a cursor or an export pipeline: each page is drawn as soon
+ * as it is full, and the footer omits the page total.
+ */
+class SupplierReport
+{
+public:
+    struct Column {
+        QString title;
+        qreal weight;                                   // share of the page width
+        std::function<QString(const Fournisseur&)> text;
+    };
+
+    explicit SupplierReport(SupplierSnapshotPtr snapshot = SupplierSnapshotPtr());
+    ~SupplierReport();
+
+    void setTitle(const QString& text) { title = text; }
+    void setColumns(const QVector<Column>& list) { columns = list; }
+
+    // Pages rendered per parallel batch (memory bound); 0 = two per worker
+    void setBatchPages(int pages) { batchPages = pages; }
+
+    bool render(const QString& fileName, JobContext& job);
+
+    // Streaming mode, single thread
+    bool begin(const QString& fileName);
+    void addRow(const Fournisseur& f);
+    bool finish();
+    void abort();                       // stops and removes the partial file
+
+    int pageCount() const { return pages; }
+    QString getLastError() const { return lastError; }
+
+    static QVector<Column> defaultColumns();
+
+private:
+    struct Layout {
+        QRectF page;                    // in picture units (see render)
+        QFont titleFont;
+        QFont headerFont;
+        QFont bodyFont;
+        qreal titleHeight = 0;
+        qreal rowHeight = 0;
+        qreal footerHeight = 0;
+        qreal baseline = 0;             // text baseline offset inside a row
+        QVector<qreal> columnX;
+        QVector<qreal> columnWidth;
+        int firstPageRows = 0;
+        int rowsPerPage = 0;
+    };
+
+    SupplierSnapshotPtr snapshot;
+    QString title;
+    QVector<Column> columns;
+    int batchPages;
+    int pages;                          // 0 while streaming (total unknown)
+    QString lastError;
+
+    // Streaming state
+    QString streamFile;
+    std::unique_ptr<QPrinter> streamPrinter;
+    std::unique_ptr<QPainter> streamPainter;
+    Layout streamLayout;
+    QVector<Fournisseur> pageRows;
+    int streamPage;
+
+    bool openPrinter(const QString& fileName, QPrinter& printer, QPainter& painter, Layout& layout);
+    Layout computeLayout(const QSizeF& pageSize) const;
+    int firstRowOf(const Layout& layout, int page) const;
+    int rowsOn(const Layout& layout, int page) const;
+    void paintPage(QPainter& painter, const Layout& layout, int page, const QVector<Fournisseur>& rows) const;
+    void flushStreamPage();
+};
+
+// PDF output of an ExportPipeline (streaming mode of SupplierReport)
+class PdfExportSink : public ExportSink
+{
+public:
+    explicit PdfExportSink(const QString& fileName) : fileName(fileName) {}
+    QString name() const override { return "PDF " + fileName; }
+    bool open() override { return report.begin(fileName); }
+    void write(const Fournisseur& f) override { report.addRow(f); }
+    bool close() override { return report.finish(); }
+    void abort() override { report.abort(); }
+    QString lastError() const override { return report.getLastError(); }
+
+private:
+    QString fileName;
+    SupplierReport report;
+};
+
+#endif // REPORTENGINE_H
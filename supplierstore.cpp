@@ -0,0 +1,146 @@
+#include "supplierstore.h"
+#include "tracing.h"
+#include <QMutexLocker>
+#include <algorithm>
+#include <atomic>
+
+// ===== SupplierSnapshot Implementation =====
+const Fournisseur& SupplierSnapshot::at(int index) const
+{
+    Q_ASSERT(index >= 0 && index < count);
+    // Last chunk whose first index is <= index
+    int c = int(std::upper_bound(offsets.begin(), offsets.end(), index) - offsets.begin()) - 1;
+    return chunks[c]->at(index - offsets[c]);
+}
+
+QList<Fournisseur> SupplierSnapshot::toList() const
+{
+    QList<Fournisseur> list;
+    list.reserve(count);
+    forEach([&list](const Fournisseur& f) { list.append(f); });
+    return list;
+}
+
+// ===== SupplierStore Implementation =====
+SupplierStore::SupplierStore()
+    : current(std::make_shared<const SupplierSnapshot>()), draftCount(0), nextVersion(1), batchDepth(0)
+{
+}
+
+SupplierSnapshotPtr SupplierStore::snapshot() const
+{
+    return std::atomic_load(&current);
+}
+
+void SupplierStore::reset(const QList<Fournisseur>& fournisseurs)
+{
+    TRACE_SCOPE("SupplierStore::reset");
+    QMutexLocker locker(&writerMutex);
+    draft.clear();
+    owned.clear();
+    for (int start = 0; start < fournisseurs.size(); start += ChunkSize) {
+        int end = qMin(start + ChunkSize, int(fournisseurs.size()));
+        auto chunk = std::make_shared<SupplierSnapshot::Chunk>();
+        chunk->reserve(ChunkSize);
+        for (int i = start; i < end; ++i) chunk->append(fournisseurs[i]);
+        draft.append(chunk);
+        owned.append(true);
+    }
+    draftCount = fournisseurs.size();
+    if (batchDepth == 0) publishLocked();
+}
+
+void SupplierStore::append(const Fournisseur& f)
+{
+    QMutexLocker locker(&writerMutex);
+    if (draft.isEmpty() || draft.last()->size() >= ChunkSize) {
+        auto chunk = std::make_shared<SupplierSnapshot::Chunk>();
+        chunk->reserve(ChunkSize);
+        draft.append(chunk);
+        owned.append(true);
+    }
+    writableChunk(draft.size() - 1).append(f);
+    draftCount++;
+    if (batchDepth == 0) publishLocked();
+}
+
+void SupplierStore::replace(int index, const Fournisseur& f)
+{
+    QMutexLocker locker(&writerMutex);
+    int offset;
+    int c = locate(index, offset);
+    if (c < 0) return;
+    writableChunk(c)[offset] = f;
+    if (batchDepth == 0) publishLocked();
+}
+
+void SupplierStore::removeAt(int index)
+{
+    QMutexLocker locker(&writerMutex);
+    int offset;
+    int c = locate(index, offset);
+    if (c < 0) return;
+
+    // Removal only shifts the rest of its own chunk; an emptied chunk is dropped
+    SupplierSnapshot::Chunk& chunk = writableChunk(c);
+    chunk.removeAt(offset);
+    if (chunk.isEmpty()) {
+        draft.removeAt(c);
+        owned.removeAt(c);
+    }
+    draftCount--;
+    if (batchDepth == 0) publishLocked();
+}
+
+void SupplierStore::beginBatch()
+{
+    QMutexLocker locker(&writerMutex);
+    batchDepth++;
+}
+
+void SupplierStore::endBatch()
+{
+    QMutexLocker locker(&writerMutex);
+    if (batchDepth > 0 && --batchDepth == 0) publishLocked();
+}
+
+int SupplierStore::locate(int index, int& offsetInChunk) const
+{
+    if (index < 0 || index >= draftCount) return -1;
+    for (int c = 0; c < draft.size(); ++c) {
+        if (index < draft[c]->size()) {
+            offsetInChunk = index;
+            return c;
+        }
+        index -= draft[c]->size();
+    }
+    return -1;
+}
+
+SupplierSnapshot::Chunk& SupplierStore::writableChunk(int chunkIndex)
+{
+    // Copy on first write after a publish: the published version keeps the original
+    if (!owned[chunkIndex]) {
+        draft[chunkIndex] = std::make_shared<SupplierSnapshot::Chunk>(*draft[chunkIndex]);
+        owned[chunkIndex] = true;
+    }
+    return *draft[chunkIndex];
+}
+
+void SupplierStore::publishLocked()
+{
+    auto next = std::make_shared<SupplierSnapshot>();
+    next->ver = nextVersion++;
+    next->count = draftCount;
+    next->chunks.reserve(draft.size());
+    next->offsets.reserve(draft.size());
+    int offset = 0;
+    for (const MutableChunk& chunk : draft) {
+        next->chunks.append(chunk);
+        next->offsets.append(offset);
+        offset += chunk->size();
+    }
+    owned.fill(false);
+
+    std::atomic_store(&current, SupplierSnapshotPtr(std::move(next)));
+}
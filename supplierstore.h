@@ -0,0 +1,96 @@
+#ifndef SUPPLIERSTORE_H
+#define SUPPLIERSTORE_H
+
+#include <QList>
+#include <QVector>
+#include <QMutex>
+#include <memory>
+#include "fournisseur.h"
+
+/**
+ * Immutable, versioned view of the supplier list
+ *
+ * Suppliers live in chunks shared between versions: an edit copies only
+ * the chunk it touches, so publishing a new version costs one chunk plus
+ * the chunk table, not the whole list. A snapshot never changes once
+ * published and can be read from any thread without locking.
+ */
+class SupplierSnapshot
+{
+public:
+    using Chunk = QVector<Fournisseur>;
+
+    quint64 version() const { return ver; }
+    int size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    const Fournisseur& at(int index) const;
+
+    template<typename Fn>
+    void forEach(Fn fn) const
+    {
+        for (const auto& chunk : chunks) {
+            for (const Fournisseur& f : *chunk) fn(f);
+        }
+    }
+
+    QList<Fournisseur> toList() const;
+
+private:
+    friend class SupplierStore;
+
+    quint64 ver = 0;
+    int count = 0;
+    QVector<std::shared_ptr<const Chunk>> chunks;
+    QVector<int> offsets;   // index of the first supplier of each chunk
+};
+
+using SupplierSnapshotPtr = std::shared_ptr<const SupplierSnapshot>;
+
+/**
+ * Supplier store with RCU-style publication
+ *
+ * Mirrors the GUI list position for position. Readers take snapshot() (an
+ * atomic load of the current pointer) and keep it as long as they need;
+ * writers edit a private draft and publish it with an atomic pointer swap.
+ * Writers only serialize with other writers, never with readers, and old
+ * versions are freed when their last reader drops them.
+ *
+ * Every edit publishes immediately, except between beginBatch() and
+ * endBatch(), where the whole group becomes visible at once.
+ */
+class SupplierStore
+{
+public:
+    static const int ChunkSize = 512;
+
+    SupplierStore();
+
+    SupplierSnapshotPtr snapshot() const;
+    quint64 version() const { return snapshot()->version(); }
+
+    void reset(const QList<Fournisseur>& fournisseurs);
+    void append(const Fournisseur& f);
+    void replace(int index, const Fournisseur& f);
+    void removeAt(int index);
+
+    void beginBatch();
+    void endBatch();
+
+private:
+    using MutableChunk = std::shared_ptr<SupplierSnapshot::Chunk>;
+
+    SupplierSnapshotPtr current;        // accessed only through std::atomic_load/store
+
+    QMutex writerMutex;
+    QVector<MutableChunk> draft;
+    QVector<bool> owned;                // draft chunk not shared with a published version
+    int draftCount;
+    quint64 nextVersion;
+    int batchDepth;
+
+    int locate(int index, int& offsetInChunk) const;
+    SupplierSnapshot::Chunk& writableChunk(int chunkIndex);
+    void publishLocked();
+};
+
+#endif // SUPPLIERSTORE_H
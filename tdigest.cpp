@@ -0,0 +1,134 @@
+#include "tdigest.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+
+// k1 scale function: centroids span one unit of k, which makes them tiny at the tails
+double scaleK(double q, double compression)
+{
+    return compression / (2 * Pi) * std::asin(2 * qBound(0.0, q, 1.0) - 1);
+}
+
+double scaleQ(double k, double compression)
+{
+    return (std::sin(qBound(-Pi / 2, k * 2 * Pi / compression, Pi / 2)) + 1) / 2;
+}
+
+}
+
+// ===== TDigest Implementation =====
+TDigest::TDigest(double compression)
+    : compression(qMax(10.0, compression)), totalWeight(0.0), bufferWeight(0.0),
+      minValue(std::numeric_limits<double>::infinity()),
+      maxValue(-std::numeric_limits<double>::infinity())
+{
+}
+
+void TDigest::add(double value, double weight)
+{
+    if (weight <= 0 || std::isnan(value)) return;
+    buffer.append({ value, weight });
+    bufferWeight += weight;
+    minValue = qMin(minValue, value);
+    maxValue = qMax(maxValue, value);
+    if (buffer.size() >= int(4 * compression)) flush();
+}
+
+void TDigest::merge(const TDigest& other)
+{
+    if (other.isEmpty()) return;
+    for (const Centroid& c : other.centroids) buffer.append(c);
+    for (const Centroid& c : other.buffer) buffer.append(c);
+    bufferWeight += other.totalWeight + other.bufferWeight;
+    minValue = qMin(minValue, other.minValue);
+    maxValue = qMax(maxValue, other.maxValue);
+    if (buffer.size() >= int(4 * compression)) flush();
+}
+
+void TDigest::compress()
+{
+    flush();
+    buffer.squeeze();
+    centroids.squeeze();
+}
+
+void TDigest::flush()
+{
+    if (buffer.isEmpty()) return;
+    QVector<Centroid> points = centroids;
+    points += buffer;
+    totalWeight += bufferWeight;
+    centroids = mergeCentroids(std::move(points), totalWeight, compression);
+    buffer.clear();
+    bufferWeight = 0.0;
+}
+
+QVector<TDigest::Centroid> TDigest::mergeCentroids(QVector<Centroid> points, double total, double compression)
+{
+    std::sort(points.begin(), points.end(), [](const Centroid& a, const Centroid& b) {
+        return a.mean < b.mean;
+    });
+
+    // Greedy pass: grow the current centroid while it stays within one unit of k
+    QVector<Centroid> merged;
+    merged.reserve(int(compression * 2));
+    double before = 0.0;                // weight of the centroids already closed
+    double limit = total * scaleQ(scaleK(0.0, compression) + 1, compression);
+    for (const Centroid& point : points) {
+        if (!merged.isEmpty() && before + merged.last().weight + point.weight <= limit) {
+            Centroid& current = merged.last();
+            current.weight += point.weight;
+            current.mean += (point.mean - current.mean) * point.weight / current.weight;
+        } else {
+            if (!merged.isEmpty()) {
+                before += merged.last().weight;
+                limit = total * scaleQ(scaleK(before / total, compression) + 1, compression);
+            }
+            merged.append(point);
+        }
+    }
+    return merged;
+}
+
+double TDigest::quantile(double q) const
+{
+    if (isEmpty()) return 0.0;
+    if (!buffer.isEmpty()) {
+        TDigest copy(*this);
+        copy.flush();
+        return copy.quantile(q);
+    }
+    if (q <= 0) return minValue;
+    if (q >= 1) return maxValue;
+    if (centroids.size() == 1) return centroids[0].mean;
+
+    // Each centroid's mass is centred on its mean; interpolate between neighbours
+    double target = q * totalWeight;
+    double cumulative = 0.0;
+    for (int i = 0; i < centroids.size(); ++i) {
+        const Centroid& c = centroids[i];
+        double centre = cumulative + c.weight / 2;
+        if (target < centre) {
+            if (i == 0) {
+                return minValue + (c.mean - minValue) * (target / centre);
+            }
+            const Centroid& prev = centroids[i - 1];
+            double prevCentre = cumulative - prev.weight / 2;
+            return prev.mean + (c.mean - prev.mean) * (target - prevCentre) / (centre - prevCentre);
+        }
+        cumulative += c.weight;
+    }
+    const Centroid& last = centroids.last();
+    double lastCentre = totalWeight - last.weight / 2;
+    return last.mean + (maxValue - last.mean) * (target - lastCentre) / (totalWeight - lastCentre);
+}
+
+qint64 TDigest::memoryUsage() const
+{
+    return qint64(sizeof(TDigest)) +
+           qint64(centroids.capacity() + buffer.capacity()) * qint64(sizeof(Centroid));
+}
@@ -0,0 +1,51 @@
+#ifndef TDIGEST_H
+#define TDIGEST_H
+
+#include <QVector>
+
+/**
+ * Mergeable quantile sketch (t-digest, merging variant)
+ *
+ * Keeps at most about 'compression' weighted centroids, small near the
+ * tails and large in the middle, so p50 .. p99 stay accurate to a fraction
+ * of a percent without keeping or sorting the raw values. Digests of
+ * different shards merge into the digest of their union. New values are
+ * buffered and folded in by batches; quantile() works on a merged copy
+ * while the buffer is not empty, so it is safe on a const digest.
+ */
+class TDigest
+{
+public:
+    explicit TDigest(double compression = 100.0);
+
+    void add(double value, double weight = 1.0);
+    void merge(const TDigest& other);
+    void compress();                    // fold the buffer in and release its memory
+
+    double quantile(double q) const;    // q in [0, 1]; 0 if empty
+    double count() const { return totalWeight + bufferWeight; }
+    bool isEmpty() const { return count() == 0.0; }
+    double min() const { return minValue; }
+    double max() const { return maxValue; }
+    int centroidCount() const { return centroids.size(); }
+    qint64 memoryUsage() const;
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    double compression;
+    QVector<Centroid> centroids;        // sorted by mean
+    QVector<Centroid> buffer;
+    double totalWeight;
+    double bufferWeight;
+    double minValue;
+    double maxValue;
+
+    void flush();
+    static QVector<Centroid> mergeCentroids(QVector<Centroid> points, double total, double compression);
+};
+
+#endif // TDIGEST_H
@@ -0,0 +1,139 @@
+#include "tracing.h"
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <QTextStream>
+#include <chrono>
+#include <memory>
+
+namespace {
+
+struct ThreadBuffer
+{
+    std::atomic<quint32> count{0};
+    std::atomic<quint64> dropped{0};
+    quint32 threadId = 0;
+    TraceEvent events[Tracer::BufferCapacity];
+};
+
+// Buffers are registered once per thread and kept after the thread exits,
+// so spans from finished worker threads still appear in the dump.
+QMutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>>& registry()
+{
+    static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    return buffers;
+}
+
+ThreadBuffer* threadBuffer()
+{
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        QMutexLocker locker(&registryMutex);
+        registry().push_back(std::make_unique<ThreadBuffer>());
+        buffer = registry().back().get();
+        buffer->threadId = quint32(registry().size());
+    }
+    return buffer;
+}
+
+const std::chrono::steady_clock::time_point processStart = std::chrono::steady_clock::now();
+
+QString escapeJson(const char* text)
+{
+    QString escaped = QString::fromUtf8(text);
+    escaped.replace('\\', "\\\\");
+    escaped.replace('"', "\\\"");
+    return escaped;
+}
+
+} // namespace
+
+#ifdef FOURNISSEUR_TRACING
+std::atomic<bool> Tracer::enabled{true};
+#else
+std::atomic<bool> Tracer::enabled{false};
+#endif
+
+bool Tracer::isCompiledIn()
+{
+#ifdef FOURNISSEUR_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+qint64 Tracer::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - processStart).count();
+}
+
+void Tracer::record(const char* name, qint64 startNs, qint64 durationNs)
+{
+    ThreadBuffer* buffer = threadBuffer();
+    quint32 index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= quint32(BufferCapacity)) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[index] = TraceEvent{name, startNs, durationNs};
+    // Publish after the event is written; the dumper reads with acquire
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+bool Tracer::dumpChromeTrace(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+    bool first = true;
+    QMutexLocker locker(&registryMutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry()) {
+        quint32 count = buffer->count.load(std::memory_order_acquire);
+        for (quint32 i = 0; i < count; ++i) {
+            const TraceEvent& e = buffer->events[i];
+            if (!first) out << ",\n";
+            first = false;
+            // Complete events ("X"); timestamps are in microseconds
+            out << "{\"name\":\"" << escapeJson(e.name)
+                << "\",\"cat\":\"fournisseur\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << QString::number(e.startNs / 1000.0, 'f', 3)
+                << ",\"dur\":" << QString::number(e.durationNs / 1000.0, 'f', 3) << "}";
+        }
+    }
+
+    out << "\n]}\n";
+    file.close();
+    return true;
+}
+
+bool Tracer::reset()
+{
+    if (isEnabled()) return false;
+
+    QMutexLocker locker(&registryMutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry()) {
+        buffer->count.store(0, std::memory_order_release);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+quint64 Tracer::droppedEvents()
+{
+    quint64 total = 0;
+    QMutexLocker locker(&registryMutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry()) {
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
@@ -0,0 +1,83 @@
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * Hot-path tracing
+ *
+ * TRACE_SCOPE("name") records one span (start + duration) into a buffer
+ * owned by the calling thread: no locks, one release store per span to
+ * publish it to the dumper.
+ * Tracer::dumpChromeTrace() writes chrome://tracing / Perfetto JSON.
+ *
+ * Spans only exist in builds configured with CONFIG+=tracing
+ * (FOURNISSEUR_TRACING); otherwise the macros expand to nothing.
+ * Names must be string literals (only the pointer is stored).
+ */
+
+struct TraceEvent
+{
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+class Tracer
+{
+public:
+    static const int BufferCapacity = 1 << 16;   // events per thread
+
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    static bool isCompiledIn();
+
+    static qint64 nowNs();
+    static void record(const char* name, qint64 startNs, qint64 durationNs);
+
+    // Call while traced work is quiescent for a complete, consistent file
+    static bool dumpChromeTrace(const QString& fileName);
+    // Empties every buffer. Writers are not synchronized with it: refused (false)
+    // while tracing is enabled, and spans opened before setEnabled(false) must
+    // have closed, or they land in a cleared buffer.
+    static bool reset();
+    static quint64 droppedEvents();
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+class TraceScope
+{
+private:
+    const char* name;
+    qint64 startNs;
+
+public:
+    explicit TraceScope(const char* spanName)
+        : name(Tracer::isEnabled() ? spanName : nullptr),
+          startNs(name ? Tracer::nowNs() : 0)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (name) Tracer::record(name, startNs, Tracer::nowNs() - startNs);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef FOURNISSEUR_TRACING
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#endif
+
+#endif // TRACING_H
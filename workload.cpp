@@ -0,0 +1,612 @@
+#include "workload.h"
+#include "databasemanager.h"
+#include "livesearch.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QtConcurrent>
+
+namespace {
+
+QJsonArray toJsonArray(const QList<Fournisseur>& fournisseurs)
+{
+    QJsonArray array;
+    for (const Fournisseur& f : fournisseurs) {
+        array.append(f.toJson());
+    }
+    return array;
+}
+
+QList<Fournisseur> fromJsonArray(const QJsonArray& array)
+{
+    QList<Fournisseur> fournisseurs;
+    fournisseurs.reserve(array.size());
+    for (const QJsonValue& value : array) {
+        fournisseurs.append(Fournisseur::fromJson(value.toObject()));
+    }
+    return fournisseurs;
+}
+
+QString formatMs(quint64 ns)
+{
+    return QString::number(ns / 1e6, 'f', 2);
+}
+
+} // namespace
+
+// ===== WorkloadOp Implementation =====
+WorkloadOp WorkloadOp::add(const Fournisseur& f)
+{
+    WorkloadOp op;
+    op.type = Add;
+    op.fournisseur = f;
+    return op;
+}
+
+WorkloadOp WorkloadOp::modify(const Fournisseur& f)
+{
+    WorkloadOp op;
+    op.type = Modify;
+    op.fournisseur = f;
+    return op;
+}
+
+WorkloadOp WorkloadOp::remove(int id)
+{
+    WorkloadOp op;
+    op.type = Delete;
+    op.id = id;
+    return op;
+}
+
+WorkloadOp WorkloadOp::search(const QString& text)
+{
+    WorkloadOp op;
+    op.type = Search;
+    op.query = text;
+    return op;
+}
+
+WorkloadOp WorkloadOp::filter(const FilterCriteria& criteria)
+{
+    WorkloadOp op;
+    op.type = Filter;
+    op.criteria = criteria;
+    return op;
+}
+
+WorkloadOp WorkloadOp::importBatch(const QList<Fournisseur>& fournisseurs)
+{
+    WorkloadOp op;
+    op.type = Import;
+    op.batch = fournisseurs;
+    return op;
+}
+
+WorkloadOp WorkloadOp::load()
+{
+    WorkloadOp op;
+    op.type = Load;
+    return op;
+}
+
+int WorkloadOp::key() const
+{
+    switch (type) {
+        case Add:
+        case Modify: return fournisseur.getIdFournisseur();
+        case Delete: return id;
+        default: return -1;
+    }
+}
+
+QString WorkloadOp::typeName(Type type)
+{
+    switch (type) {
+        case Add: return "ADD";
+        case Modify: return "MODIFY";
+        case Delete: return "DELETE";
+        case Search: return "SEARCH";
+        case Filter: return "FILTER";
+        case Import: return "IMPORT";
+        default: return "LOAD";
+    }
+}
+
+QJsonObject WorkloadOp::toJson() const
+{
+    QJsonObject json;
+    json["t"] = double(offsetMs);
+    json["op"] = typeName(type);
+
+    switch (type) {
+        case Add:
+        case Modify:
+            json["fournisseur"] = fournisseur.toJson();
+            break;
+        case Delete:
+            json["id"] = id;
+            break;
+        case Search:
+            json["query"] = query;
+            break;
+        case Filter: {
+            QJsonObject c;
+            c["nom"] = criteria.nom;
+            c["email"] = criteria.email;
+            c["typeProduits"] = criteria.typeProduits;
+            c["adresse"] = criteria.adresse;
+            c["minRating"] = criteria.minRating;
+            c["maxRating"] = criteria.maxRating;
+            c["activeOnly"] = criteria.activeOnly;
+            json["criteria"] = c;
+            break;
+        }
+        case Import:
+            json["fournisseurs"] = toJsonArray(batch);
+            break;
+        default:
+            break;
+    }
+    return json;
+}
+
+bool WorkloadOp::fromJson(const QJsonObject& json, WorkloadOp& op)
+{
+    static const Type types[] = { Add, Modify, Delete, Search, Filter, Import, Load };
+
+    QString name = json["op"].toString();
+    bool known = false;
+    for (Type type : types) {
+        if (typeName(type) == name) {
+            op.type = type;
+            known = true;
+            break;
+        }
+    }
+    if (!known) return false;
+
+    op.offsetMs = qint64(json["t"].toDouble());
+    op.fournisseur = Fournisseur::fromJson(json["fournisseur"].toObject());
+    op.id = json["id"].toInt(-1);
+    op.query = json["query"].toString();
+
+    QJsonObject c = json["criteria"].toObject();
+    op.criteria.nom = c["nom"].toString();
+    op.criteria.email = c["email"].toString();
+    op.criteria.typeProduits = c["typeProduits"].toString();
+    op.criteria.adresse = c["adresse"].toString();
+    op.criteria.minRating = c["minRating"].toInt(0);
+    op.criteria.maxRating = c["maxRating"].toInt(5);
+    op.criteria.activeOnly = c["activeOnly"].toBool(false);
+
+    op.batch = fromJsonArray(json["fournisseurs"].toArray());
+    return true;
+}
+
+// ===== WorkloadRecorder Implementation =====
+WorkloadRecorder::WorkloadRecorder()
+    : recorded(0)
+{
+}
+
+bool WorkloadRecorder::start(const QString& fileName, const QList<Fournisseur>& snapshot)
+{
+    stop();
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    QJsonObject header;
+    header["format"] = "fournisseur-workload";
+    header["version"] = 1;
+    header["started"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    header["rows"] = snapshot.size();
+    file.write(QJsonDocument(header).toJson(QJsonDocument::Compact) + "\n");
+
+    QJsonObject snapshotLine;
+    snapshotLine["t"] = 0;
+    snapshotLine["op"] = "SNAPSHOT";
+    snapshotLine["fournisseurs"] = toJsonArray(snapshot);
+    file.write(QJsonDocument(snapshotLine).toJson(QJsonDocument::Compact) + "\n");
+    file.flush();
+
+    recorded = 0;
+    clock.start();
+    return true;
+}
+
+void WorkloadRecorder::stop()
+{
+    if (file.isOpen()) {
+        file.close();
+    }
+}
+
+void WorkloadRecorder::record(WorkloadOp op)
+{
+    if (!file.isOpen()) return;
+
+    op.offsetMs = clock.elapsed();
+    file.write(QJsonDocument(op.toJson()).toJson(QJsonDocument::Compact) + "\n");
+    // Flushed per line: a crash still leaves a replayable prefix
+    file.flush();
+    recorded++;
+}
+
+// ===== JsonWorkloadBackend Implementation =====
+JsonWorkloadBackend::JsonWorkloadBackend(std::shared_ptr<Store> store)
+    : store(store)
+{
+}
+
+bool JsonWorkloadBackend::seed(const QList<Fournisseur>& snapshot)
+{
+    QMutexLocker locker(&store->mutex);
+    store->fournisseurs = snapshot;
+    return persist();
+}
+
+bool JsonWorkloadBackend::persist()
+{
+    if (store->fileName.isEmpty()) return true;
+    if (!JsonStorage::saveToFile(store->fileName, store->fournisseurs)) {
+        error = QString("écriture de %1 impossible").arg(store->fileName);
+        return false;
+    }
+    return true;
+}
+
+bool JsonWorkloadBackend::execute(const WorkloadOp& op)
+{
+    QMutexLocker locker(&store->mutex);
+    QList<Fournisseur>& list = store->fournisseurs;
+
+    switch (op.type) {
+        case WorkloadOp::Add:
+            list.append(op.fournisseur);
+            return persist();
+
+        case WorkloadOp::Modify:
+        case WorkloadOp::Delete: {
+            int id = op.key();
+            for (int i = 0; i < list.size(); ++i) {
+                if (list[i].getIdFournisseur() == id) {
+                    if (op.type == WorkloadOp::Modify) list[i] = op.fournisseur;
+                    else list.removeAt(i);
+                    return persist();
+                }
+            }
+            error = QString("fournisseur %1 introuvable").arg(id);
+            return false;
+        }
+
+        case WorkloadOp::Search: {
+            int matches = 0;
+            for (const Fournisseur& f : list) {
+                if (IncrementalSearch::matchesQuery(f, op.query)) matches++;
+            }
+            Q_UNUSED(matches);
+            return true;
+        }
+
+        case WorkloadOp::Filter: {
+            int matches = 0;
+            QVector<bool> types = op.criteria.matchingTypes();
+            for (const Fournisseur& f : list) {
+                if (op.criteria.matches(f, 0, types)) {
+                    matches++;
+                }
+            }
+            Q_UNUSED(matches);
+            return true;
+        }
+
+        case WorkloadOp::Import:
+            list.append(op.batch);
+            return persist();
+
+        case WorkloadOp::Load: {
+            if (store->fileName.isEmpty()) return true;
+            bool success;
+            JsonStorage::loadFromFile(store->fileName, success);
+            if (!success) error = QString("lecture de %1 impossible").arg(store->fileName);
+            return success;
+        }
+    }
+    return false;
+}
+
+// ===== DatabaseWorkloadBackend Implementation =====
+DatabaseWorkloadBackend::DatabaseWorkloadBackend(DatabaseManager* db)
+    : db(db)
+{
+}
+
+DatabaseWorkloadBackend::~DatabaseWorkloadBackend()
+{
+    delete db;
+}
+
+QString DatabaseWorkloadBackend::name() const
+{
+    return db->getDatabaseType();
+}
+
+QString DatabaseWorkloadBackend::lastError() const
+{
+    return db->getLastError();
+}
+
+bool DatabaseWorkloadBackend::seed(const QList<Fournisseur>& snapshot)
+{
+    db->dropTables();
+    return db->createTables() && db->insertBatch(snapshot, true);
+}
+
+bool DatabaseWorkloadBackend::execute(const WorkloadOp& op)
+{
+    bool success = false;
+
+    switch (op.type) {
+        case WorkloadOp::Add:
+            return db->insertFournisseur(op.fournisseur, true);
+        case WorkloadOp::Modify:
+            return db->updateFournisseur(op.fournisseur);
+        case WorkloadOp::Delete:
+            return db->deleteFournisseur(op.id);
+        case WorkloadOp::Search:
+            db->searchFournisseurs(op.query, success);
+            return success;
+        case WorkloadOp::Filter: {
+            // The GUI filters in memory after a full read; do the same
+            QList<Fournisseur> all = db->getAllFournisseurs(success);
+            int matches = 0;
+            QVector<bool> types = op.criteria.matchingTypes();
+            for (const Fournisseur& f : all) {
+                if (op.criteria.matches(f, 0, types)) {
+                    matches++;
+                }
+            }
+            Q_UNUSED(matches);
+            return success;
+        }
+        case WorkloadOp::Import:
+            return db->insertBatch(op.batch, true);
+        case WorkloadOp::Load:
+            db->getAllFournisseurs(success);
+            return success;
+    }
+    return false;
+}
+
+// ===== WorkloadReplayer Implementation =====
+WorkloadReplayer::WorkloadReplayer()
+    : snapshotPresent(false), speed(1.0), clients(1), seedBackend(false)
+{
+}
+
+bool WorkloadReplayer::load(const QString& fileName)
+{
+    ops.clear();
+    snapshot.clear();
+    snapshotPresent = false;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        lastError = QString("Impossible d'ouvrir %1").arg(fileName);
+        return false;
+    }
+
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().trimmed();
+        lineNumber++;
+        if (line.isEmpty()) continue;
+
+        QJsonParseError parseError;
+        QJsonObject json = QJsonDocument::fromJson(line, &parseError).object();
+        if (parseError.error != QJsonParseError::NoError) {
+            // A capture cut short by a crash ends with a partial line
+            if (file.atEnd()) break;
+            lastError = QString("Ligne %1: %2").arg(lineNumber).arg(parseError.errorString());
+            return false;
+        }
+
+        if (json.contains("format")) {
+            if (json["format"].toString() != "fournisseur-workload") {
+                lastError = QString("%1 n'est pas un fichier de charge").arg(fileName);
+                return false;
+            }
+            continue;
+        }
+        if (json["op"].toString() == "SNAPSHOT") {
+            snapshot = fromJsonArray(json["fournisseurs"].toArray());
+            snapshotPresent = true;
+            continue;
+        }
+
+        WorkloadOp op;
+        if (!WorkloadOp::fromJson(json, op)) {
+            lastError = QString("Ligne %1: opération inconnue %2")
+                .arg(lineNumber).arg(json["op"].toString());
+            return false;
+        }
+        ops.append(op);
+    }
+    return true;
+}
+
+WorkloadReplayer::Report WorkloadReplayer::run(const BackendFactory& factory)
+{
+    Report report;
+    report.clients = clients;
+    report.speed = speed;
+
+    if (seedBackend && snapshotPresent) {
+        std::unique_ptr<WorkloadBackend> setup = factory(-1);
+        if (!setup || !setup->seed(snapshot)) {
+            report.errorSamples << QString("Initialisation impossible: %1")
+                .arg(setup ? setup->lastError() : QString("backend indisponible"));
+            return report;
+        }
+        report.backend = setup->name();
+    }
+
+    // Same supplier -> same client, so its ADD / MODIFY / DELETE stay ordered
+    QVector<QVector<const WorkloadOp*>> perClient(clients);
+    int roundRobin = 0;
+    for (const WorkloadOp& op : ops) {
+        int key = op.key();
+        int client = key >= 0 ? key % clients : roundRobin++ % clients;
+        perClient[client].append(&op);
+    }
+    qint64 firstOffset = ops.isEmpty() ? 0 : ops.first().offsetMs;
+
+    struct ClientResult {
+        QString backend;
+        QMap<QString, LatencyHistogram> perType;
+        qint64 operations = 0;
+        qint64 errors = 0;
+        QStringList errorSamples;
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(clients);
+    QSemaphore ready;
+    QSemaphore go;
+    QElapsedTimer clock;
+    double pace = speed;
+
+    QList<QFuture<ClientResult>> futures;
+    for (int c = 0; c < clients; ++c) {
+        futures.append(QtConcurrent::run(&pool, [&, c]() {
+            ClientResult result;
+            std::unique_ptr<WorkloadBackend> backend = factory(c);
+            if (backend) result.backend = backend->name();
+
+            // Every client connects before the clock starts
+            ready.release();
+            go.acquire();
+
+            for (const WorkloadOp* op : perClient[c]) {
+                qint64 startNs;
+                if (pace > 0.0) {
+                    qint64 dueNs = qint64((op->offsetMs - firstOffset) * 1e6 / pace);
+                    qint64 waitNs = dueNs - clock.nsecsElapsed();
+                    if (waitNs > 2000000) QThread::usleep(quint64((waitNs - 1000000) / 1000));
+                    while (clock.nsecsElapsed() < dueNs) QThread::yieldCurrentThread();
+                    startNs = dueNs;
+                } else {
+                    startNs = clock.nsecsElapsed();
+                }
+
+                bool ok = backend && backend->execute(*op);
+                quint64 latencyNs = quint64(clock.nsecsElapsed() - startNs);
+
+                result.perType[WorkloadOp::typeName(op->type)].record(latencyNs);
+                result.operations++;
+                if (!ok) {
+                    result.errors++;
+                    if (result.errorSamples.size() < 5) {
+                        result.errorSamples << QString("%1: %2").arg(WorkloadOp::typeName(op->type),
+                            backend ? backend->lastError() : QString("backend indisponible"));
+                    }
+                }
+            }
+            return result;
+        }));
+    }
+
+    ready.acquire(clients);
+    clock.start();
+    go.release(clients);
+
+    for (QFuture<ClientResult>& future : futures) {
+        ClientResult result = future.result();
+        if (report.backend.isEmpty()) report.backend = result.backend;
+        for (auto it = result.perType.constBegin(); it != result.perType.constEnd(); ++it) {
+            report.perType[it.key()].merge(it.value());
+            report.overall.merge(it.value());
+        }
+        report.operations += result.operations;
+        report.errors += result.errors;
+        for (const QString& sample : result.errorSamples) {
+            if (report.errorSamples.size() < 10) report.errorSamples << sample;
+        }
+    }
+    report.elapsedSeconds = clock.nsecsElapsed() / 1e9;
+    return report;
+}
+
+// ===== Report formatting =====
+QString WorkloadReplayer::Report::toText() const
+{
+    QString text = QString("🎬 REJEU DE CHARGE - %1\n\n").arg(backend);
+    text += QString("Clients: %1   Vitesse: %2\n")
+        .arg(clients).arg(speed > 0 ? QString("x%1").arg(speed) : QString("max"));
+    text += QString("Opérations: %1   Erreurs: %2   Durée: %3 s   Débit: %4 op/s\n\n")
+        .arg(operations).arg(errors)
+        .arg(elapsedSeconds, 0, 'f', 2).arg(throughput(), 0, 'f', 1);
+
+    text += QString("%1 %2 %3 %4 %5 %6\n")
+        .arg(QString("Opération"), -10).arg(QString("Nombre"), 8)
+        .arg(QString("p50 ms"), 10).arg(QString("p90 ms"), 10)
+        .arg(QString("p99 ms"), 10).arg(QString("max ms"), 10);
+    text += QString(63, '-') + "\n";
+
+    auto line = [](const QString& label, const LatencyHistogram& h) {
+        return QString("%1 %2 %3 %4 %5 %6\n")
+            .arg(label, -10).arg(h.count(), 8)
+            .arg(formatMs(h.percentile(50)), 10).arg(formatMs(h.percentile(90)), 10)
+            .arg(formatMs(h.percentile(99)), 10).arg(formatMs(h.max()), 10);
+    };
+    for (auto it = perType.constBegin(); it != perType.constEnd(); ++it) {
+        text += line(it.key(), it.value());
+    }
+    text += line("TOTAL", overall);
+
+    if (!errorSamples.isEmpty()) {
+        text += "\nErreurs (extrait):\n";
+        for (const QString& sample : errorSamples) {
+            text += "  " + sample + "\n";
+        }
+    }
+    return text;
+}
+
+QJsonObject WorkloadReplayer::Report::toJson() const
+{
+    auto stats = [](const LatencyHistogram& h) {
+        QJsonObject o;
+        o["count"] = double(h.count());
+        o["meanMs"] = h.mean() / 1e6;
+        o["p50Ms"] = h.percentile(50) / 1e6;
+        o["p90Ms"] = h.percentile(90) / 1e6;
+        o["p99Ms"] = h.percentile(99) / 1e6;
+        o["maxMs"] = h.max() / 1e6;
+        return o;
+    };
+
+    QJsonObject types;
+    for (auto it = perType.constBegin(); it != perType.constEnd(); ++it) {
+        types[it.key()] = stats(it.value());
+    }
+
+    QJsonObject json;
+    json["backend"] = backend;
+    json["clients"] = clients;
+    json["speed"] = speed;
+    json["operations"] = double(operations);
+    json["errors"] = double(errors);
+    json["elapsedSeconds"] = elapsedSeconds;
+    json["throughput"] = throughput();
+    json["overall"] = stats(overall);
+    json["perType"] = types;
+    json["errorSamples"] = QJsonArray::fromStringList(errorSamples);
+    return json;
+}
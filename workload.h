@@ -0,0 +1,187 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QMutex>
+#include <functional>
+#include <memory>
+#include "fournisseur.h"
+#include "advancedfeatures.h"
+#include "querymetrics.h"
+
+class DatabaseManager;
+
+/**
+ * One recorded user operation with its full payload
+ * Offsets are milliseconds since the start of the capture.
+ */
+struct WorkloadOp
+{
+    enum Type { Add, Modify, Delete, Search, Filter, Import, Load };
+
+    Type type = Load;
+    qint64 offsetMs = 0;
+    Fournisseur fournisseur;            // Add, Modify
+    int id = -1;                        // Delete
+    QString query;                      // Search
+    FilterCriteria criteria;            // Filter
+    QList<Fournisseur> batch;           // Import
+
+    static WorkloadOp add(const Fournisseur& f);
+    static WorkloadOp modify(const Fournisseur& f);
+    static WorkloadOp remove(int id);
+    static WorkloadOp search(const QString& text);
+    static WorkloadOp filter(const FilterCriteria& criteria);
+    static WorkloadOp importBatch(const QList<Fournisseur>& fournisseurs);
+    static WorkloadOp load();
+
+    // Supplier the operation is about (-1 = none): keeps its ops on one client
+    int key() const;
+
+    static QString typeName(Type type);
+    QJsonObject toJson() const;
+    static bool fromJson(const QJsonObject& json, WorkloadOp& op);
+};
+
+/**
+ * Workload capture
+ *
+ * Appends one JSON object per line (JSONL) as operations happen: a header,
+ * an optional SNAPSHOT of the data at capture start (so a replay can start
+ * from the same state), then every operation with its offset and payload.
+ */
+class WorkloadRecorder
+{
+private:
+    QFile file;
+    QElapsedTimer clock;
+    qint64 recorded;
+
+public:
+    WorkloadRecorder();
+
+    bool start(const QString& fileName, const QList<Fournisseur>& snapshot);
+    void stop();
+    bool isRecording() const { return file.isOpen(); }
+    qint64 operationCount() const { return recorded; }
+    QString fileName() const { return file.fileName(); }
+
+    void record(WorkloadOp op);
+};
+
+/**
+ * Storage the replayer drives. One instance per client thread, created and
+ * used on that thread (SQL connections are not shareable across threads).
+ */
+class WorkloadBackend
+{
+public:
+    virtual ~WorkloadBackend() {}
+    virtual QString name() const = 0;
+    virtual bool seed(const QList<Fournisseur>& snapshot) = 0;   // called once, before timing
+    virtual bool execute(const WorkloadOp& op) = 0;
+    virtual QString lastError() const = 0;
+};
+
+// JSON file storage as the GUI uses it: whole-file save after each change.
+// All clients share one list behind a mutex.
+class JsonWorkloadBackend : public WorkloadBackend
+{
+public:
+    struct Store {
+        QMutex mutex;
+        QString fileName;
+        QList<Fournisseur> fournisseurs;
+    };
+
+    explicit JsonWorkloadBackend(std::shared_ptr<Store> store);
+
+    QString name() const override { return "JSON"; }
+    bool seed(const QList<Fournisseur>& snapshot) override;
+    bool execute(const WorkloadOp& op) override;
+    QString lastError() const override { return error; }
+
+private:
+    std::shared_ptr<Store> store;
+    QString error;
+
+    bool persist();
+};
+
+// Any DatabaseManager target (SQLite file, Oracle); one connection per client
+class DatabaseWorkloadBackend : public WorkloadBackend
+{
+public:
+    explicit DatabaseWorkloadBackend(DatabaseManager* db);
+    ~DatabaseWorkloadBackend() override;
+
+    QString name() const override;
+    bool seed(const QList<Fournisseur>& snapshot) override;
+    bool execute(const WorkloadOp& op) override;
+    QString lastError() const override;
+
+private:
+    DatabaseManager* db;
+};
+
+/**
+ * Workload replay
+ *
+ * Re-issues a capture from several client threads. Operations on the same
+ * supplier stay on the same client (in order); the others are spread
+ * round-robin. speed = 1 replays at the recorded pace, 10 ten times faster,
+ * 0 as fast as possible. When paced, latency is measured from the scheduled
+ * time, so a stalled backend shows up as queueing instead of being hidden.
+ */
+class WorkloadReplayer
+{
+public:
+    // Called on each client thread; client -1 is the setup instance used for seeding
+    using BackendFactory = std::function<std::unique_ptr<WorkloadBackend>(int client)>;
+
+    struct Report {
+        QString backend;
+        int clients = 0;
+        double speed = 0.0;
+        qint64 operations = 0;
+        qint64 errors = 0;
+        double elapsedSeconds = 0.0;
+        LatencyHistogram overall;
+        QMap<QString, LatencyHistogram> perType;
+        QStringList errorSamples;
+
+        double throughput() const { return elapsedSeconds > 0 ? operations / elapsedSeconds : 0.0; }
+        QString toText() const;
+        QJsonObject toJson() const;
+    };
+
+    WorkloadReplayer();
+
+    bool load(const QString& fileName);
+    QString getLastError() const { return lastError; }
+    int operationCount() const { return ops.size(); }
+    const QList<Fournisseur>& getSnapshot() const { return snapshot; }
+    bool hasSnapshot() const { return snapshotPresent; }
+
+    void setSpeed(double factor) { speed = factor; }
+    void setClients(int count) { clients = qMax(1, count); }
+    void setSeed(bool enabled) { seedBackend = enabled; }
+
+    Report run(const BackendFactory& factory);
+
+private:
+    QList<WorkloadOp> ops;
+    QList<Fournisseur> snapshot;
+    bool snapshotPresent;
+    double speed;
+    int clients;
+    bool seedBackend;
+    QString lastError;
+};
+
+#endif // WORKLOAD_H